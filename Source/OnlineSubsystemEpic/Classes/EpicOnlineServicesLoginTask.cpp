@@ -125,7 +125,7 @@ UEpicOnlineServicesLoginTask* UEpicOnlineServicesLoginTask::TryLogin(UObject* Wo
         Task->PlayerControllerWeakPtr->NetPlayerIndex, LoginCompleteDelegate);
 
     Task->Credentials.Type = FString::Printf(
-        TEXT("EAS:%s"), *FUtils::GetEnumValueAsString<ELoginType>("ELoginType", LoginType));
+        TEXT("EAS:%s"), *FUtils::LoginTypeToString(LoginType));
 
     switch (LoginType)
     {
@@ -0,0 +1,463 @@
+#include "OnlineBotFarmEpic.h"
+#include "OnlineSubsystemEpic.h"
+#include "OnlineSubsystemEpicTypes.h"
+#include "OnlineRateLimiterEpic.h"
+#include "OnlineSubsystem.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Paths.h"
+
+#include "eos_connect.h"
+
+typedef struct FBotMintAdditionalData
+{
+	FOnlineBotFarmEpic* Farm;
+	int32 Generation;
+	int32 BotIndex;
+	int32 BotNumber;
+	FString DisplayName;
+	TSharedRef<FOnlineBotFarmEpic::FBotBatch> Batch;
+} FBotMintAdditionalData;
+
+FOnlineBotFarmEpic::FOnlineBotFarmEpic(FOnlineSubsystemEpic* InSubsystem)
+	: Subsystem(InSubsystem)
+	, bFakeIds(false)
+	, bCommandsEnabled(false)
+	, NextBotNumber(0)
+	, DeviceIdOwner(INDEX_NONE)
+	, bDeviceIdOwnerReused(false)
+	, bPlayerUsedDeviceId(false)
+	, LoggedInCount(0)
+	, bMintInFlight(false)
+	, Generation(0)
+{
+}
+
+void FOnlineBotFarmEpic::LoadConfig()
+{
+	GConfig->GetBool(TEXT("OnlineSubsystemEpic"), TEXT("BotFarmFakeIds"), this->bFakeIds, GEngineIni);
+	GConfig->GetBool(TEXT("OnlineSubsystemEpic"), TEXT("BotFarmCommands"), this->bCommandsEnabled, GEngineIni);
+
+	this->LoadState();
+}
+
+FString FOnlineBotFarmEpic::GetStatePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("OnlineSubsystemEpic") / TEXT("BotFarm.ini");
+}
+
+void FOnlineBotFarmEpic::LoadState()
+{
+	FConfigFile state;
+	state.Read(GetStatePath());
+
+	FString value;
+	if (state.GetString(TEXT("BotFarm"), TEXT("PlayerUsedDeviceId"), value))
+	{
+		this->bPlayerUsedDeviceId = value.ToBool();
+	}
+	if (state.GetString(TEXT("BotFarm"), TEXT("DeviceIdOwner"), value))
+	{
+		this->DeviceIdOwner = FCString::Atoi(*value);
+	}
+
+	FConfigSection const* section = state.Find(TEXT("Bots"));
+	if (section)
+	{
+		for (TPair<FName, FConfigValue> const& entry : *section)
+		{
+			int32 botNumber = FCString::Atoi(*entry.Key.ToString().RightChop(3));
+			this->MintedBots.Add(botNumber, entry.Value.GetValue());
+			this->NextBotNumber = FMath::Max(this->NextBotNumber, botNumber + 1);
+		}
+	}
+}
+
+void FOnlineBotFarmEpic::SaveState() const
+{
+	FConfigFile state;
+	state.SetString(TEXT("BotFarm"), TEXT("PlayerUsedDeviceId"), this->bPlayerUsedDeviceId ? TEXT("True") : TEXT("False"));
+	state.SetString(TEXT("BotFarm"), TEXT("DeviceIdOwner"), *FString::FromInt(this->DeviceIdOwner));
+	for (TPair<int32, FString> const& bot : this->MintedBots)
+	{
+		state.SetString(TEXT("Bots"), *FString::Printf(TEXT("Bot%d"), bot.Key), *bot.Value);
+	}
+
+	if (!state.Write(GetStatePath()))
+	{
+		UE_LOG_ONLINE(Warning, TEXT("Couldn't write the bot farm state to %s, the next run may mint on a device id it doesn't know"), *GetStatePath());
+	}
+}
+
+TFuture<int32> FOnlineBotFarmEpic::AddBots(int32 Count)
+{
+	TSharedRef<FBotBatch> batch = MakeShared<FBotBatch>();
+	TFuture<int32> future = batch->Promise.GetFuture();
+
+	if (Count <= 0)
+	{
+		batch->Promise.SetValue(0);
+		return future;
+	}
+
+	// Fake bots don't need the backend, they are logged in right away
+	if (this->bFakeIds)
+	{
+		this->ProductUserIds.Reserve(this->ProductUserIds.Num() + Count);
+		this->States.Reserve(this->States.Num() + Count);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			int32 botIndex = this->ProductUserIds.Num();
+			EOS_ProductUserId productUserId = MakeFakeProductUserId(this->NextBotNumber++);
+			this->ProductUserIds.Add(productUserId);
+			this->States.Add(EBotState::LoggedIn);
+			this->BotIndexByProductUserId.Add(productUserId, botIndex);
+		}
+		this->LoggedInCount += Count;
+
+		UE_LOG_ONLINE(Display, TEXT("Added %d fake bots"), Count);
+		batch->Promise.SetValue(Count);
+		return future;
+	}
+
+	batch->Remaining = Count;
+	for (int32 i = 0; i < Count; ++i)
+	{
+		this->MintQueue.Add(batch);
+	}
+	this->StartNextMint();
+
+	return future;
+}
+
+TSharedPtr<const FUniqueNetId> FOnlineBotFarmEpic::GetBotId(int32 BotIndex) const
+{
+	if (!this->States.IsValidIndex(BotIndex) || this->States[BotIndex] != EBotState::LoggedIn)
+	{
+		return nullptr;
+	}
+
+	// Net ids are made on demand, the table only keeps the product user id
+	return MakeShared<FUniqueNetIdEpic>(this->ProductUserIds[BotIndex]);
+}
+
+void FOnlineBotFarmEpic::OnLoginStatusChanged(EOS_ProductUserId ProductUserId, EOS_ELoginStatus CurrentStatus)
+{
+	int32 const* botIndex = this->BotIndexByProductUserId.Find(ProductUserId);
+	if (!botIndex)
+	{
+		return;
+	}
+
+	// The device id of a bot is gone once the next bot was minted, a bot that lost its login stays logged out
+	EBotState& state = this->States[*botIndex];
+	if (CurrentStatus == EOS_ELoginStatus::EOS_LS_NotLoggedIn && state == EBotState::LoggedIn)
+	{
+		state = EBotState::LoggedOut;
+		this->LoggedInCount -= 1;
+	}
+}
+
+void FOnlineBotFarmEpic::OnPlayerDeviceIdLogin()
+{
+	if (this->bPlayerUsedDeviceId)
+	{
+		return;
+	}
+
+	if (this->DeviceIdOwner != INDEX_NONE)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("A local user logged in with the device id of Bot%d, the bot farm leaves it to them and won't mint on this device anymore"), this->DeviceIdOwner);
+	}
+
+	this->bPlayerUsedDeviceId = true;
+	this->SaveState();
+	this->FailQueuedMints();
+}
+
+void FOnlineBotFarmEpic::Reset()
+{
+	this->Generation += 1;
+
+	// Complete every pending batch with what it got so far.
+	// A running mint finishes in the background, bots added meanwhile are minted once it is done
+	TArray<TSharedRef<FBotBatch>> queued = MoveTemp(this->MintQueue);
+	if (this->MintingBatch)
+	{
+		queued.Add(this->MintingBatch.ToSharedRef());
+		this->MintingBatch = nullptr;
+	}
+	for (TSharedRef<FBotBatch> const& batch : queued)
+	{
+		if (batch->Remaining > 0)
+		{
+			batch->Remaining = 0;
+			batch->Promise.SetValue(batch->LoggedIn);
+		}
+	}
+
+	this->ProductUserIds.Empty();
+	this->States.Empty();
+	this->BotIndexByProductUserId.Empty();
+	this->LoggedInCount = 0;
+}
+
+void FOnlineBotFarmEpic::StartNextMint()
+{
+	if (this->bMintInFlight || this->MintQueue.Num() == 0)
+	{
+		return;
+	}
+
+	// Deleting a device id a player logged in with would lose their account for good
+	if (this->bPlayerUsedDeviceId)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("Can't mint bots, a local user logged in with the device id of this device. Remove %s to allow it again"), *GetStatePath());
+		this->FailQueuedMints();
+		return;
+	}
+
+	this->bMintInFlight = true;
+	this->MintingBatch = this->MintQueue[0];
+
+	int32 botIndex = this->ProductUserIds.Add(nullptr);
+	this->States.Add(EBotState::Minting);
+
+	// The device id of the last run still logs its bot in, it is reused before any new bot is minted
+	bool bReuseOwner = this->DeviceIdOwner != INDEX_NONE && !this->bDeviceIdOwnerReused;
+	int32 botNumber = bReuseOwner ? this->DeviceIdOwner : this->NextBotNumber++;
+
+	FBotMintAdditionalData* additionalData = new FBotMintAdditionalData{
+		this,
+		this->Generation,
+		botIndex,
+		botNumber,
+		FString::Printf(TEXT("Bot%d"), botNumber),
+		this->MintQueue[0]
+	};
+	this->MintQueue.RemoveAt(0, 1, false);
+
+	if (bReuseOwner)
+	{
+		this->bDeviceIdOwnerReused = true;
+		this->LoginBot(additionalData);
+		return;
+	}
+
+	// The farm only ever deletes the device id of one of its bots. Without one, the device id is created right away,
+	// which fails if the device has a device id the farm doesn't know
+	if (this->DeviceIdOwner == INDEX_NONE)
+	{
+		this->CreateDeviceId(additionalData);
+		return;
+	}
+
+	// Every bot gets a fresh device id, so it maps to a product user of its own
+	EOS_HConnect connectHandle = EOS_Platform_GetConnectInterface(this->Subsystem->PlatformHandle);
+	EOS_Connect_DeleteDeviceIdOptions deleteOptions = {
+		EOS_CONNECT_DELETEDEVICEID_API_LATEST
+	};
+	EOS_Connect_DeleteDeviceId(connectHandle, &deleteOptions, additionalData, &FOnlineBotFarmEpic::EOS_Connect_OnDeviceIdDeleted);
+}
+
+void EOS_CALL FOnlineBotFarmEpic::EOS_Connect_OnDeviceIdDeleted(const EOS_Connect_DeleteDeviceIdCallbackInfo* Data)
+{
+	FBotMintAdditionalData* additionalData = static_cast<FBotMintAdditionalData*>(Data->ClientData);
+	FOnlineBotFarmEpic* thisPtr = additionalData->Farm;
+
+	// The device id may have been removed outside of the farm already
+	if (Data->ResultCode != EOS_EResult::EOS_Success && Data->ResultCode != EOS_EResult::EOS_NotFound)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("[EOS SDK] Couldn't delete the device id of the last bot. Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+		thisPtr->FinishMint(additionalData, nullptr);
+		return;
+	}
+
+	thisPtr->DeviceIdOwner = INDEX_NONE;
+	thisPtr->SaveState();
+
+	thisPtr->CreateDeviceId(additionalData);
+}
+
+void FOnlineBotFarmEpic::CreateDeviceId(FBotMintAdditionalData* AdditionalData)
+{
+	FTCHARToUTF8 deviceModel(*AdditionalData->DisplayName);
+	EOS_Connect_CreateDeviceIdOptions createOptions = {
+		EOS_CONNECT_CREATEDEVICEID_API_LATEST,
+		deviceModel.Get()
+	};
+	EOS_HConnect connectHandle = EOS_Platform_GetConnectInterface(this->Subsystem->PlatformHandle);
+	EOS_Connect_CreateDeviceId(connectHandle, &createOptions, AdditionalData, &FOnlineBotFarmEpic::EOS_Connect_OnDeviceIdCreated);
+}
+
+void EOS_CALL FOnlineBotFarmEpic::EOS_Connect_OnDeviceIdCreated(const EOS_Connect_CreateDeviceIdCallbackInfo* Data)
+{
+	FBotMintAdditionalData* additionalData = static_cast<FBotMintAdditionalData*>(Data->ClientData);
+	FOnlineBotFarmEpic* thisPtr = additionalData->Farm;
+
+	// The device has a device id the farm didn't create, it may belong to a player and is left alone
+	if (Data->ResultCode == EOS_EResult::EOS_DuplicateNotAllowed)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("Can't mint bots, this device has a device id the bot farm didn't create"));
+		thisPtr->FailQueuedMints();
+		thisPtr->FinishMint(additionalData, nullptr);
+		return;
+	}
+
+	if (Data->ResultCode != EOS_EResult::EOS_Success)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("[EOS SDK] Couldn't create a device id for %s. Error: %s"), *additionalData->DisplayName, UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+		thisPtr->FinishMint(additionalData, nullptr);
+		return;
+	}
+
+	// Saved before the login, the device id is the farm's to replace even if the bot never logs in
+	thisPtr->DeviceIdOwner = additionalData->BotNumber;
+	thisPtr->bDeviceIdOwnerReused = true;
+	thisPtr->SaveState();
+
+	thisPtr->LoginBot(additionalData);
+}
+
+void FOnlineBotFarmEpic::LoginBot(FBotMintAdditionalData* AdditionalData)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Login, [this, AdditionalData]()
+		{
+			FTCHARToUTF8 displayName(*AdditionalData->DisplayName);
+
+			// Device id logins carry no token, the SDK uses the device id of this device
+			EOS_Connect_Credentials credentials = {
+				EOS_CONNECT_CREDENTIALS_API_LATEST,
+				nullptr,
+				EOS_EExternalCredentialType::EOS_ECT_DEVICEID_ACCESS_TOKEN
+			};
+			EOS_Connect_UserLoginInfo loginInfo = {
+				EOS_CONNECT_USERLOGININFO_API_LATEST,
+				displayName.Get()
+			};
+			EOS_Connect_LoginOptions loginOptions = {
+				EOS_CONNECT_LOGIN_API_LATEST,
+				&credentials,
+				&loginInfo
+			};
+			EOS_HConnect connectHandle = EOS_Platform_GetConnectInterface(this->Subsystem->PlatformHandle);
+			EOS_Connect_Login(connectHandle, &loginOptions, AdditionalData, &FOnlineBotFarmEpic::EOS_Connect_OnLoginComplete);
+		}, [AdditionalData]()
+		{
+			// Dropped on shutdown, the login completes as failed
+			EOS_Connect_LoginCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = AdditionalData;
+			EOS_Connect_OnLoginComplete(&info);
+		});
+}
+
+void EOS_CALL FOnlineBotFarmEpic::EOS_Connect_OnLoginComplete(const EOS_Connect_LoginCallbackInfo* Data)
+{
+	FBotMintAdditionalData* additionalData = static_cast<FBotMintAdditionalData*>(Data->ClientData);
+	FOnlineBotFarmEpic* thisPtr = additionalData->Farm;
+
+	if (Data->ResultCode == EOS_EResult::EOS_Success)
+	{
+		thisPtr->FinishMint(additionalData, Data->LocalUserId);
+		return;
+	}
+
+	// A new device id has no product user yet, create one
+	if (Data->ResultCode == EOS_EResult::EOS_InvalidUser && Data->ContinuanceToken)
+	{
+		EOS_Connect_CreateUserOptions createUserOptions = {
+			EOS_CONNECT_CREATEUSER_API_LATEST,
+			Data->ContinuanceToken
+		};
+		EOS_HConnect connectHandle = EOS_Platform_GetConnectInterface(thisPtr->Subsystem->PlatformHandle);
+		EOS_Connect_CreateUser(connectHandle, &createUserOptions, additionalData, &FOnlineBotFarmEpic::EOS_Connect_OnUserCreated);
+		return;
+	}
+
+	UE_LOG_ONLINE(Warning, TEXT("[EOS SDK] Login of %s failed. Error: %s"), *additionalData->DisplayName, UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+	thisPtr->FinishMint(additionalData, nullptr);
+}
+
+void EOS_CALL FOnlineBotFarmEpic::EOS_Connect_OnUserCreated(const EOS_Connect_CreateUserCallbackInfo* Data)
+{
+	FBotMintAdditionalData* additionalData = static_cast<FBotMintAdditionalData*>(Data->ClientData);
+	FOnlineBotFarmEpic* thisPtr = additionalData->Farm;
+
+	if (Data->ResultCode != EOS_EResult::EOS_Success)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("[EOS SDK] Couldn't create a user for %s. Error: %s"), *additionalData->DisplayName, UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+		thisPtr->FinishMint(additionalData, nullptr);
+		return;
+	}
+
+	thisPtr->FinishMint(additionalData, Data->LocalUserId);
+}
+
+void FOnlineBotFarmEpic::FinishMint(FBotMintAdditionalData* AdditionalData, EOS_ProductUserId ProductUserId)
+{
+	// The device id is free again, whichever generation the mint belongs to
+	this->bMintInFlight = false;
+
+	// The product user exists whichever generation the mint belongs to
+	if (EOS_ProductUserId_IsValid(ProductUserId))
+	{
+		this->MintedBots.Add(AdditionalData->BotNumber, FUniqueNetIdEpic::ProductUserIdToString(ProductUserId));
+		this->SaveState();
+	}
+
+	// The farm was reset while the mint was running, its batch was completed already. Bots queued since then start now
+	if (AdditionalData->Generation != this->Generation)
+	{
+		delete(AdditionalData);
+		this->StartNextMint();
+		return;
+	}
+
+	int32 botIndex = AdditionalData->BotIndex;
+	FBotBatch& batch = AdditionalData->Batch.Get();
+	if (EOS_ProductUserId_IsValid(ProductUserId))
+	{
+		this->ProductUserIds[botIndex] = ProductUserId;
+		this->States[botIndex] = EBotState::LoggedIn;
+		this->BotIndexByProductUserId.Add(ProductUserId, botIndex);
+		this->LoggedInCount += 1;
+		batch.LoggedIn += 1;
+	}
+	else
+	{
+		this->States[botIndex] = EBotState::Failed;
+	}
+
+	batch.Remaining -= 1;
+	if (batch.Remaining == 0)
+	{
+		UE_LOG_ONLINE(Display, TEXT("Bot batch done, %d bots logged in. %d of %d bots are logged in overall"), batch.LoggedIn, this->LoggedInCount, this->ProductUserIds.Num());
+		batch.Promise.SetValue(batch.LoggedIn);
+	}
+
+	delete(AdditionalData);
+
+	this->MintingBatch = nullptr;
+	this->StartNextMint();
+}
+
+void FOnlineBotFarmEpic::FailQueuedMints()
+{
+	TArray<TSharedRef<FBotBatch>> queued = MoveTemp(this->MintQueue);
+	for (TSharedRef<FBotBatch> const& batch : queued)
+	{
+		batch->Remaining -= 1;
+		if (batch->Remaining == 0)
+		{
+			batch->Promise.SetValue(batch->LoggedIn);
+		}
+	}
+}
+
+EOS_ProductUserId FOnlineBotFarmEpic::MakeFakeProductUserId(int32 BotIndex)
+{
+	// Product user ids are 32 hex digits. The SDK parses them without asking the backend,
+	// but no backend call accepts them. They only feed the farm's own bookkeeping
+	FString idString = FString::Printf(TEXT("b07%029x"), BotIndex);
+	return EOS_ProductUserId_FromString(TCHAR_TO_UTF8(*idString));
+}
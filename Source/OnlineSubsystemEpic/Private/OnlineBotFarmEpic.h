@@ -0,0 +1,165 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "eos_sdk.h"
+
+class FOnlineSubsystemEpic;
+struct FBotMintAdditionalData;
+
+/**
+ * Mints and holds product users for load tests.
+ * Bots are not local users, they don't occupy a local user slot and don't raise the identity delegates.
+ * Each bot is a connect user logged in with a device id of its own. As the SDK keeps a single device id per device,
+ * bots are minted one after the other: the device id is replaced, the bot logs in, and stays logged in until its auth expires.
+ * The farm only deletes device ids it created itself. The minted bots and the bot owning the device id of this device are
+ * kept in Saved/OnlineSubsystemEpic/BotFarm.ini, the next run logs that bot in again instead of minting a new one.
+ * Once a local user logged in with a device id on this device, the farm doesn't mint on it anymore, in this run or any later one.
+ * With fake ids the SDK isn't used at all, bots get made up product user ids that only exist inside the farm.
+ * The farm is not thread safe, it is used from the game thread only.
+ */
+class FOnlineBotFarmEpic
+{
+public:
+	explicit FOnlineBotFarmEpic(FOnlineSubsystemEpic* InSubsystem);
+
+	/** Reads the bot farm settings from the OnlineSubsystemEpic section of the engine config */
+	void LoadConfig();
+
+	/** Whether the BOTS console commands may be used */
+	bool AreCommandsEnabled() const
+	{
+		return this->bCommandsEnabled;
+	}
+
+	/**
+	 * Mints new bots and logs them in.
+	 * @param Count - The number of bots to add
+	 * @returns - A future completing once all bots are done, with the number of bots that were logged in
+	 */
+	TFuture<int32> AddBots(int32 Count);
+
+	/** The number of bots, including the ones that failed or lost their login */
+	int32 Num() const
+	{
+		return this->ProductUserIds.Num();
+	}
+
+	/** The number of bots that are currently logged in */
+	int32 NumLoggedIn() const
+	{
+		return this->LoggedInCount;
+	}
+
+	/** Returns the id of a bot, or null if the bot isn't logged in */
+	TSharedPtr<const FUniqueNetId> GetBotId(int32 BotIndex) const;
+
+	/** Whether a product user is one of the bots */
+	bool IsBot(EOS_ProductUserId ProductUserId) const
+	{
+		return this->BotIndexByProductUserId.Contains(ProductUserId);
+	}
+
+	/** Called by the identity interface when the login status of a bot changes */
+	void OnLoginStatusChanged(EOS_ProductUserId ProductUserId, EOS_ELoginStatus CurrentStatus);
+
+	/** Called by the identity interface when a local user logged in with a device id. The farm stops minting on this device for good */
+	void OnPlayerDeviceIdLogin();
+
+	/** Drops all bots and pending mints, completing the pending futures */
+	void Reset();
+
+private:
+	friend struct FBotMintAdditionalData;
+
+	static void EOS_CALL EOS_Connect_OnDeviceIdDeleted(const EOS_Connect_DeleteDeviceIdCallbackInfo* Data);
+	static void EOS_CALL EOS_Connect_OnDeviceIdCreated(const EOS_Connect_CreateDeviceIdCallbackInfo* Data);
+	static void EOS_CALL EOS_Connect_OnLoginComplete(const EOS_Connect_LoginCallbackInfo* Data);
+	static void EOS_CALL EOS_Connect_OnUserCreated(const EOS_Connect_CreateUserCallbackInfo* Data);
+
+	enum class EBotState : uint8
+	{
+		Minting,
+		LoggedIn,
+		LoggedOut,
+		Failed
+	};
+
+	/** The bots of a single AddBots call */
+	struct FBotBatch
+	{
+		TPromise<int32> Promise;
+		int32 Remaining = 0;
+		int32 LoggedIn = 0;
+	};
+
+	/** Starts minting the next queued bot, unless a mint is running already */
+	void StartNextMint();
+
+	/** Creates the device id of a bot, once the device has none */
+	void CreateDeviceId(FBotMintAdditionalData* AdditionalData);
+
+	/** Completes every queued bot as failed */
+	void FailQueuedMints();
+
+	/** Logs a freshly minted bot in with the current device id */
+	void LoginBot(FBotMintAdditionalData* AdditionalData);
+
+	/** Records the outcome of a mint and starts the next one */
+	void FinishMint(FBotMintAdditionalData* AdditionalData, EOS_ProductUserId ProductUserId);
+
+	/** Makes up the product user id of a bot with fake ids */
+	static EOS_ProductUserId MakeFakeProductUserId(int32 BotIndex);
+
+	/** Where the farm keeps its bots between runs */
+	static FString GetStatePath();
+
+	/** Reads the bots of earlier runs */
+	void LoadState();
+
+	/** Writes the bots, so the next run knows which device id belongs to the farm */
+	void SaveState() const;
+
+	FOnlineSubsystemEpic* Subsystem;
+
+	/** Whether bots get made up product user ids instead of being logged in with the backend */
+	bool bFakeIds;
+
+	/** Whether the BOTS console commands may be used */
+	bool bCommandsEnabled;
+
+	/** The number of the next bot, used for its device model and display name. Continues the numbers of earlier runs */
+	int32 NextBotNumber;
+
+	/** The product user ids of all bots ever minted on this device, by bot number. Persisted */
+	TMap<int32, FString> MintedBots;
+
+	/** The number of the bot owning the device id of this device, INDEX_NONE if the farm didn't create it. Persisted */
+	int32 DeviceIdOwner;
+
+	/** Whether the bot owning the device id was logged in again in this run already */
+	bool bDeviceIdOwnerReused;
+
+	/** Whether a local user ever logged in with a device id on this device. Persisted */
+	bool bPlayerUsedDeviceId;
+
+	// One entry per bot, kept as separate arrays so thousands of bots stay small
+	TArray<EOS_ProductUserId> ProductUserIds;
+	TArray<EBotState> States;
+	TMap<EOS_ProductUserId, int32> BotIndexByProductUserId;
+
+	/** The number of bots in the LoggedIn state */
+	int32 LoggedInCount;
+
+	/** The batch of every bot waiting to be minted, in mint order */
+	TArray<TSharedRef<FBotBatch>> MintQueue;
+
+	/** The batch of the bot being minted right now, if any. Dropped on reset, while the mint may still be running */
+	TSharedPtr<FBotBatch> MintingBatch;
+
+	/** Whether a mint is running. Stays set after a reset until the mint's last callback, as only one mint may use the device id at a time */
+	bool bMintInFlight;
+
+	/** Increased on reset, mints started before that are dropped when they complete */
+	int32 Generation;
+};
@@ -1,9 +1,15 @@
 #include "OnlineIdentityInterfaceEpic.h"
 #include "CoreMinimal.h"
 #include "OnlineSubsystemEpic.h"
+#include "OnlineRetryPolicyEpic.h"
+#include "OnlineRateLimiterEpic.h"
+#include "OnlineReconnectSchedulerEpic.h"
+#include "OnlineBotFarmEpic.h"
+#include "OnlineWriteJournalEpic.h"
 #include "OnlineError.h"
 #include "Utilities.h"
 #include "HAL/UnrealMemory.h"
+#include "Misc/ConfigCacheIni.h"
 
 #include "eos_sdk.h"
 #include "eos_types.h"
@@ -106,8 +112,48 @@ typedef struct FLoginCompleteAdditionalData
     FOnlineIdentityInterfaceEpic* IdentityInterface;
     int32 LocalUserNum;
     EOS_EpicAccountId EpicAccountId;
+
+    // The connect credentials, kept to reissue the login after a transient failure. Dropped once the login is done.
+    // Epic account logins fetch a fresh access token instead.
+    EOS_EExternalCredentialType ConnectType = EOS_EExternalCredentialType::EOS_ECT_EPIC;
+    FString ConnectToken;
+    FString ConnectDisplayName;
+    int32 Attempt = 1;
+
+    // Set if this login refreshes the auth of a user that is already logged in
+    bool bIsRefresh = false;
+
+    // The holds a refresh placed on the rate limiter, released once it is done
+    TArray<TPair<EEpicOperation, uint32>, TInlineAllocator<3>> Holds;
+
+    // Set if this login brings back a user that lost their login
+    bool bIsReconnect = false;
 } FAuthLoginCompleteAdditionalData;
 
+/** The shared state of a batch login, see LoginManyAsync */
+struct FLoginBatchState
+{
+    TArray<FOnlineLoginRequestEpic> Requests;
+
+    // The results in the order the requests were passed in, and the result index of each request
+    TArray<FOnlineLoginResultEpic> Results;
+    TArray<int32> ResultIndices;
+    TSharedPtr<TOnlineTrackedPromiseEpic<TArray<FOnlineLoginResultEpic>>> Promise;
+
+    // The index of the next request to start
+    int32 NextRequest = 0;
+
+    // The number of requests that haven't completed yet
+    int32 Remaining = 0;
+};
+
+typedef struct FVerifyUserAuthAdditionalData
+{
+    FOnlineIdentityInterfaceEpic* IdentityInterface;
+    EOS_ProductUserId ProductUserId;
+    EUserPrivileges::Type Privilege;
+} FVerifyUserAuthAdditionalData;
+
 typedef struct FCreateUserAdditionalData
 {
     FOnlineIdentityInterfaceEpic* IdentityInterface;
@@ -130,36 +176,17 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Auth_OnLoginComplete(const EOS_A
 
     if (Data->ResultCode == EOS_EResult::EOS_Success)
     {
-        const EOS_EpicAccountId AccountId = EOS_Auth_GetLoggedInAccountByIndex(InterfaceEpic->AuthHandle, AdditionalData->LocalUserNum);
+        // Take the account from the callback, with several logins running the SDK's login order is not the local user order
+        const EOS_EpicAccountId AccountId = Data->LocalUserId;
         if (EOS_EpicAccountId_IsValid(AccountId))
         {
-            EOS_Auth_Token* AuthToken = nullptr;
-
-            EOS_Auth_CopyUserAuthTokenOptions CopyAuthTokenOptions = {
-                EOS_AUTH_COPYUSERAUTHTOKEN_API_LATEST
-            };
-            EOS_Auth_CopyUserAuthToken(InterfaceEpic->AuthHandle, &CopyAuthTokenOptions, AccountId, &AuthToken);
-
-            EOS_Connect_Credentials ConnectCredentials = {
-                EOS_CONNECT_CREDENTIALS_API_LATEST,
-                AuthToken->AccessToken,
-                EOS_EExternalCredentialType::EOS_ECT_EPIC
-            };
-            EOS_Connect_LoginOptions LoginOptions = {
-                EOS_CONNECT_LOGIN_API_LATEST,
-                &ConnectCredentials,
-                nullptr
-            };
-
-            FLoginCompleteAdditionalData* NewAdditionalData = new FLoginCompleteAdditionalData{
+            FLoginCompleteAdditionalData* ConnectData = new FLoginCompleteAdditionalData{
                 InterfaceEpic,
                 AdditionalData->LocalUserNum,
                 AccountId
             };
-            EOS_Connect_Login(InterfaceEpic->ConnectHandle, &LoginOptions, NewAdditionalData, EOS_Connect_OnLoginComplete);
-
-            // Release the auth token
-            EOS_Auth_Token_Release(AuthToken);
+            ConnectData->bIsReconnect = AdditionalData->bIsReconnect;
+            InterfaceEpic->ConnectLogin(ConnectData);
         }
         else
         {
@@ -177,7 +204,14 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Auth_OnLoginComplete(const EOS_A
     if (!ErrorMessage.IsEmpty())
     {
         UE_LOG_ONLINE_IDENTITY(Warning, TEXT("Epic Account Service Login failed. Message:\r\n    %s"), *ErrorMessage);
-        InterfaceEpic->TriggerOnLoginCompleteDelegates(INDEX_NONE, false, FUniqueNetIdEpic(), ErrorMessage);
+        if (AdditionalData->bIsReconnect)
+        {
+            InterfaceEpic->SubsystemEpic->ReconnectScheduler->Finished(AdditionalData->LocalUserNum, false);
+        }
+        else
+        {
+            InterfaceEpic->TriggerOnLoginCompleteDelegates(AdditionalData->LocalUserNum, false, FUniqueNetIdEpic(), ErrorMessage);
+        }
     }
 
     delete(AdditionalData);
@@ -190,6 +224,36 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnLoginComplete(const EO
     FOnlineIdentityInterfaceEpic* InterfaceEpic = AdditionalData->IdentityInterface;
     check(InterfaceEpic);
 
+    // Transient failures reissue the login with the same additional data
+    if (InterfaceEpic->SubsystemEpic->RetryPolicy->ScheduleRetry(EEpicOperation::Login, Data->ResultCode, AdditionalData->Attempt, [InterfaceEpic, AdditionalData]()
+        {
+            AdditionalData->Attempt += 1;
+            InterfaceEpic->ConnectLogin(AdditionalData);
+        }, [AdditionalData]()
+        {
+            // Dropped on shutdown, the login completes as failed
+            EOS_Connect_LoginCallbackInfo Info = {};
+            Info.ResultCode = EOS_EResult::EOS_Canceled;
+            Info.ClientData = AdditionalData;
+            EOS_Connect_OnLoginComplete(&Info);
+        }))
+    {
+        return;
+    }
+
+    // Refreshes happen in the background, the game only learns about them if they fail for good
+    if (AdditionalData->bIsRefresh)
+    {
+        InterfaceEpic->FinishAuthRefresh(AdditionalData, Data->ResultCode);
+        delete(AdditionalData);
+        return;
+    }
+    if (AdditionalData->bIsReconnect)
+    {
+        InterfaceEpic->FinishReconnect(AdditionalData, Data);
+        delete(AdditionalData);
+        return;
+    }
 
     FString ErrorMessage;
 
@@ -204,6 +268,11 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnLoginComplete(const EO
         }
 
         UserId = FUniqueNetIdEpic(Data->LocalUserId, AdditionalData->EpicAccountId);
+
+        // A new login comes with new tokens, the account is rebuilt on the next access
+        InterfaceEpic->InvalidateUserAccount(Data->LocalUserId);
+        InterfaceEpic->RegisterLocalUser(AdditionalData->LocalUserNum, Data->LocalUserId, AdditionalData->EpicAccountId);
+        InterfaceEpic->StoreLoginCredentials(AdditionalData);
         //Added a pretty print for the user ID here as the log before was spitting undefined characters - Mike
         UE_LOG_ONLINE_IDENTITY(Display, TEXT("Finished logging in user \"%s\""), *UserId.ToDebugString());
     }
@@ -247,9 +316,30 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnLoginComplete(const EO
 
 void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnAuthExpiration(EOS_Connect_AuthExpirationCallbackInfo const* Data)
 {
-    // ToDo: Make the user see this.
+    // The SDK notifies us a while before the auth actually expires.
+    // Logging in again with fresh credentials extends it, without the user noticing.
+    FOnlineIdentityInterfaceEpic* thisPtr = (FOnlineIdentityInterfaceEpic*)Data->ClientData;
+
+    // Bots can't refresh, the device id they logged in with is gone
+    if (thisPtr->SubsystemEpic->BotFarm->IsBot(Data->LocalUserId))
+    {
+        return;
+    }
+
+    thisPtr->InvalidateUserAccount(Data->LocalUserId);
+
     FString localUser = FUniqueNetIdEpic::ProductUserIdToString(Data->LocalUserId);
-    UE_LOG_ONLINE_IDENTITY(Display, TEXT("Auth for user \"%s\" expired"), *localUser);
+    UE_LOG_ONLINE_IDENTITY(Display, TEXT("Auth for user \"%s\" is about to expire, refreshing"), *localUser);
+
+    int32 const* localUserNum = thisPtr->LocalUserNumByProductUserId.Find(Data->LocalUserId);
+    if (localUserNum)
+    {
+        thisPtr->StartAuthRefresh(*localUserNum);
+    }
+    else
+    {
+        UE_LOG_ONLINE_IDENTITY(Warning, TEXT("User \"%s\" is not a local user, can't refresh their auth"), *localUser);
+    }
 }
 
 void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnLoginStatusChanged(
@@ -257,6 +347,15 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnLoginStatusChanged(
 {
     FOnlineIdentityInterfaceEpic* thisPtr = (FOnlineIdentityInterfaceEpic*)Data->ClientData;
 
+    // Bots are no local users, the game doesn't hear about them
+    if (thisPtr->SubsystemEpic->BotFarm->IsBot(Data->LocalUserId))
+    {
+        thisPtr->SubsystemEpic->BotFarm->OnLoginStatusChanged(Data->LocalUserId, Data->CurrentStatus);
+        return;
+    }
+
+    thisPtr->InvalidateUserAccount(Data->LocalUserId);
+
     FString localUser = FUniqueNetIdEpic::ProductUserIdToString(Data->LocalUserId);
     ELoginStatus::Type oldStatus = thisPtr->EOSLoginStatusToUELoginStatus(Data->PreviousStatus);
     ELoginStatus::Type newStatus = thisPtr->EOSLoginStatusToUELoginStatus(Data->CurrentStatus);
@@ -268,24 +367,56 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnLoginStatusChanged(
     FUniqueNetIdEpic netId = FUniqueNetIdEpic(Data->LocalUserId);
     FPlatformUserId localUserNum = thisPtr->GetPlatformUserIdFromUniqueNetId(netId);
 
+    thisPtr->InvalidatePrivileges(Data->LocalUserId);
+
+    // A user that is no longer logged in doesn't occupy their local user slot anymore.
+    // If they were logged in until now, they lost their login and are brought back by the reconnect scheduler.
+    if (newStatus == ELoginStatus::NotLoggedIn && localUserNum != PLATFORMUSERID_NONE)
+    {
+        // Users that are logging out stay logged out
+        if (oldStatus == ELoginStatus::LoggedIn && !thisPtr->LocalUsers[localUserNum].bLoggingOut)
+        {
+            thisPtr->ScheduleReconnect(localUserNum);
+        }
+        thisPtr->UnregisterLocalUser(localUserNum);
+    }
+
     thisPtr->TriggerOnLoginStatusChangedDelegates(localUserNum, oldStatus, newStatus, netId);
+
+    // Writes made while the user was offline or on a local profile can be sent now
+    if (Data->CurrentStatus == EOS_ELoginStatus::EOS_LS_LoggedIn)
+    {
+        thisPtr->SubsystemEpic->WriteJournal->Flush();
+    }
 }
 
 void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Auth_OnLogoutComplete(const EOS_Auth_LogoutCallbackInfo* Data)
 {
+    FOnlineIdentityInterfaceEpic* thisPtr = (FOnlineIdentityInterfaceEpic*)Data->ClientData;
+    check(thisPtr);
+
     if (Data->ResultCode != EOS_EResult::EOS_Success)
     {
         char const* resultStr = EOS_EResult_ToString(Data->ResultCode);
         UE_LOG_ONLINE_IDENTITY(Warning, TEXT("[EOS SDK] Logout Failed - User: %s, Result : %s"),
                                UTF8_TO_TCHAR(Data->LocalUserId), resultStr);
+
+        // The user stays logged in, and is reconnected again if they lose their login
+        if (int32 const* localUserNum = thisPtr->LocalUserNumByEpicAccountId.Find(Data->LocalUserId))
+        {
+            thisPtr->LocalUsers[*localUserNum].bLoggingOut = false;
+        }
         return;
     }
 
-    FOnlineIdentityInterfaceEpic* thisPtr = (FOnlineIdentityInterfaceEpic*)Data->ClientData;
-    check(thisPtr);
-
-    EOS_ProductUserId puid = FUniqueNetIdEpic::ProductUserIDFromString(UTF8_TO_TCHAR(Data->LocalUserId));
-    int32 idIdx = thisPtr->GetPlatformUserIdFromUniqueNetId(FUniqueNetIdEpic(puid));
+    // The logout only tells us the EAID, the local user table knows the rest
+    int32 idIdx = PLATFORMUSERID_NONE;
+    if (int32 const* localUserNum = thisPtr->LocalUserNumByEpicAccountId.Find(Data->LocalUserId))
+    {
+        idIdx = *localUserNum;
+        thisPtr->InvalidateUserAccount(thisPtr->LocalUsers[idIdx].ProductUserId);
+        thisPtr->UnregisterLocalUser(idIdx);
+    }
 
     thisPtr->TriggerOnLogoutCompleteDelegates(idIdx, true);
     FString localUser = FUniqueNetIdEpic::EpicAccountIdToString(Data->LocalUserId);
@@ -309,11 +440,31 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnUserCreated(EOS_Connec
 
     // Creating a user always means we're not using an epic account
     FUniqueNetIdEpic userId = FUniqueNetIdEpic(Data->LocalUserId);
+    thisPtr->RegisterLocalUser(additionalData->LocalUserNum, Data->LocalUserId, nullptr);
     UE_LOG_ONLINE_IDENTITY(Display, TEXT("Finished creating user \"%s\""), UTF8_TO_TCHAR(Data->LocalUserId));
 
     thisPtr->TriggerOnLoginCompleteDelegates(additionalData->LocalUserNum, true, userId, TEXT(""));
 }
 
+void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Auth_OnVerifyUserAuthComplete(const EOS_Auth_VerifyUserAuthCallbackInfo* Data)
+{
+    FVerifyUserAuthAdditionalData* AdditionalData = static_cast<FVerifyUserAuthAdditionalData*>(Data->ClientData);
+    FOnlineIdentityInterfaceEpic* thisPtr = AdditionalData->IdentityInterface;
+    check(thisPtr);
+
+    uint32 PrivilegeResult = static_cast<uint32>(EPrivilegeResults::NoFailures);
+    if (Data->ResultCode != EOS_EResult::EOS_Success)
+    {
+        UE_LOG_ONLINE_IDENTITY(Warning, TEXT("[EOS SDK] Couldn't verify user auth. Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+        PrivilegeResult = FOnlineRetryPolicyEpic::IsRetryable(Data->ResultCode)
+            ? static_cast<uint32>(EPrivilegeResults::NetworkConnectionUnavailable)
+            : static_cast<uint32>(EPrivilegeResults::UserNotLoggedIn);
+    }
+
+    thisPtr->FinishPrivilegeCheck(AdditionalData->ProductUserId, AdditionalData->Privilege, PrivilegeResult);
+    delete(AdditionalData);
+}
+
 void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnAccountLinked(EOS_Connect_LinkAccountCallbackInfo const* Data)
 {
     // ToDo: Implement a way to notify the user that an account was linked
@@ -324,7 +475,14 @@ void EOS_CALL FOnlineIdentityInterfaceEpic::EOS_Connect_OnAccountLinked(EOS_Conn
 //-------------------------------
 FOnlineIdentityInterfaceEpic::FOnlineIdentityInterfaceEpic(FOnlineSubsystemEpic* inSubsystem)
     : SubsystemEpic(inSubsystem)
+    , AuthRefreshHoldTime(5.f)
+    , EarlyLoginState(EEarlyLoginState::None)
+    , bRejectingEarlyLoginConflict(false)
+    , PrivilegeCacheTTL(60.f)
 {
+    GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("PrivilegeCacheTTL"), this->PrivilegeCacheTTL, GEngineIni);
+    GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("AuthRefreshHoldTime"), this->AuthRefreshHoldTime, GEngineIni);
+
     this->AuthHandle = EOS_Platform_GetAuthInterface(inSubsystem->PlatformHandle);
     this->ConnectHandle = EOS_Platform_GetConnectInterface(inSubsystem->PlatformHandle);
 
@@ -371,50 +529,54 @@ bool FOnlineIdentityInterfaceEpic::Login(int32 LocalUserNum, const FOnlineAccoun
     // |           | Other                    | N / A                                           |
 
 
+    // An early login for this user might already be running or done
+    if (this->AttachToEarlyLogin(LocalUserNum, AccountCredentials))
+    {
+        return true;
+    }
+
+    // The game logs the user in itself, a pending reconnect would only get in the way
+    if (0 <= LocalUserNum && LocalUserNum < MAX_LOCAL_PLAYERS)
+    {
+        this->SubsystemEpic->ReconnectScheduler->Cancel(LocalUserNum);
+    }
+
     FString ErrorMessage;
     bool bSuccess = false;
 
-    if (0 <= LocalUserNum && LocalUserNum < MAX_LOCAL_PLAYERS)
+    // Two logins of the same user at once would get each other's results
+    bool bEarlyLoginConflict = this->IsEarlyLoginRunning(LocalUserNum);
+    if (bEarlyLoginConflict)
+    {
+        ErrorMessage = FString::Printf(TEXT("The early auto login of local user %d is still running, only \"EAS:PersistentAuth\" logins can wait for it. Log in again once it completed"), LocalUserNum);
+    }
+    else if (0 <= LocalUserNum && LocalUserNum < MAX_LOCAL_PLAYERS)
     {
         // Check if we are using the epic account system or plain connect
         FString Left, Right;
         AccountCredentials.Type.Split(TEXT(":"), &Left, &Right);
         if (Left.Equals(TEXT("EAS"), ESearchCase::IgnoreCase))
         {
-            EOS_EpicAccountId eosId = EOS_Auth_GetLoggedInAccountByIndex(this->AuthHandle, LocalUserNum);
+            EOS_EpicAccountId eosId = this->LocalUsers[LocalUserNum].EpicAccountId;
 
-            // If we already have a valid EAID, we can go straight to connect
-            if (EOS_EpicAccountId_IsValid(eosId))
-            {
-                EOS_Auth_Token* AuthToken = nullptr;
+            // Get which EAS login type we want to use
+            TPair<ELoginType, bool> loginTypeTuple = FUtils::LoginTypeFromString(Right);
 
-                EOS_Auth_CopyUserAuthTokenOptions CopyAuthTokenOptions = {
-                    EOS_AUTH_COPYUSERAUTHTOKEN_API_LATEST
-                };
-                EOS_Auth_CopyUserAuthToken(this->AuthHandle, &CopyAuthTokenOptions, eosId, &AuthToken);
-
-                EOS_Connect_Credentials ConnectCredentials = {
-                    EOS_CONNECT_CREDENTIALS_API_LATEST,
-                    AuthToken->AccessToken,
-                    EOS_EExternalCredentialType::EOS_ECT_EPIC
-                };
-                EOS_Connect_LoginOptions LoginOptions = {
-                    EOS_CONNECT_LOGIN_API_LATEST,
-                    &ConnectCredentials,
-                    nullptr
-                };
-                FLoginCompleteAdditionalData* AdditionalData = new FLoginCompleteAdditionalData{
+            // If the user is still logged in with their EAID, we can go straight to connect
+            if (EOS_EpicAccountId_IsValid(eosId) && EOS_Auth_GetLoginStatus(this->AuthHandle, eosId) == EOS_ELoginStatus::EOS_LS_LoggedIn)
+            {
+                this->ConnectLogin(new FLoginCompleteAdditionalData{
                     this,
                     LocalUserNum,
-                    nullptr
-                };
-                EOS_Connect_Login(ConnectHandle, &LoginOptions, AdditionalData, EOS_Connect_OnLoginComplete);
-
-                // Release the auth token
-                EOS_Auth_Token_Release(AuthToken);
+                    eosId
+                });
             }
                 // In any other case we call the epic account endpoint
                 // and handle login in the callback
+            else if (!loginTypeTuple.Get<1>())
+            {
+                ErrorMessage = FString::Printf(TEXT("Login of type \"%s\" not supported"), *AccountCredentials.Type);
+            }
             else
             {
                 // Create credentials struct
@@ -422,8 +584,7 @@ bool FOnlineIdentityInterfaceEpic::Login(int32 LocalUserNum, const FOnlineAccoun
                     EOS_AUTH_CREDENTIALS_API_LATEST
                 };
 
-                // Get which EAS login type we want to use
-                ELoginType loginType = FUtils::GetEnumValueFromString<ELoginType>(TEXT("ELoginType"), Right);
+                ELoginType loginType = loginTypeTuple.Get<0>();
 
                 // Convert the Id and Token fields to char const* for later use
                 char const* FirstParamStr = TCHAR_TO_ANSI(*AccountCredentials.Id.Left(256));
@@ -482,9 +643,16 @@ bool FOnlineIdentityInterfaceEpic::Login(int32 LocalUserNum, const FOnlineAccoun
                         Credentials.Token = SecondParamStr;
 
                         // Check which external login provider we want to use and then set the external type to the appropriate value
-                        EExternalLoginType externalLoginType = FUtils::GetEnumValueFromString<EExternalLoginType>(
-                            TEXT("EExternalLoginType"), AccountCredentials.Id);
-                        switch (externalLoginType)
+                        TPair<EExternalLoginType, bool> externalLoginTypeTuple =
+                            FUtils::ExternalLoginTypeFromString(AccountCredentials.Id);
+                        if (!externalLoginTypeTuple.Get<1>())
+                        {
+                            ErrorMessage = FString::Printf(
+                                TEXT("Using unsupported external login type: %s"), *AccountCredentials.Id);
+                            break;
+                        }
+
+                        switch (externalLoginTypeTuple.Get<0>())
                         {
                         case EExternalLoginType::Steam:
                             {
@@ -500,25 +668,28 @@ bool FOnlineIdentityInterfaceEpic::Login(int32 LocalUserNum, const FOnlineAccoun
                     }
                 default:
                     {
-                        UE_LOG_ONLINE_IDENTITY(Fatal, TEXT("Login of type \"%s\" not supported"),
-                                               *AccountCredentials.Type);
-                        return false;
+                        ErrorMessage = FString::Printf(TEXT("Login of type \"%s\" not supported"), *AccountCredentials.Type);
+                        break;
                     }
                 }
 
-                EOS_Auth_LoginOptions LoginOptions = {};
-                LoginOptions.ApiVersion = EOS_AUTH_LOGIN_API_LATEST;
-                LoginOptions.ScopeFlags = EOS_EAuthScopeFlags::EOS_AS_BasicProfile |
-                    EOS_EAuthScopeFlags::EOS_AS_FriendsList | EOS_EAuthScopeFlags::EOS_AS_Presence;
-                LoginOptions.Credentials = &Credentials;
+                // Only log in if the credentials were complete
+                if (ErrorMessage.IsEmpty())
+                {
+                    EOS_Auth_LoginOptions LoginOptions = {};
+                    LoginOptions.ApiVersion = EOS_AUTH_LOGIN_API_LATEST;
+                    LoginOptions.ScopeFlags = EOS_EAuthScopeFlags::EOS_AS_BasicProfile |
+                        EOS_EAuthScopeFlags::EOS_AS_FriendsList | EOS_EAuthScopeFlags::EOS_AS_Presence;
+                    LoginOptions.Credentials = &Credentials;
 
-                FLoginCompleteAdditionalData* AdditionalData = new FLoginCompleteAdditionalData{
-                    this,
-                    LocalUserNum
-                };
-                EOS_Auth_Login(AuthHandle, &LoginOptions, AdditionalData, EOS_Auth_OnLoginComplete);
+                    FLoginCompleteAdditionalData* AdditionalData = new FLoginCompleteAdditionalData{
+                        this,
+                        LocalUserNum
+                    };
+                    EOS_Auth_Login(AuthHandle, &LoginOptions, AdditionalData, EOS_Auth_OnLoginComplete);
+                }
             }
-            bSuccess = true;
+            bSuccess = ErrorMessage.IsEmpty();
         }
         else if (Left.Equals(TEXT("CONNECT"), ESearchCase::IgnoreCase))
         {
@@ -562,45 +733,24 @@ bool FOnlineIdentityInterfaceEpic::Login(int32 LocalUserNum, const FOnlineAccoun
                 // Make sure we have a valid connect type
                 if (externalTypeTuple.Get<1>())
                 {
-                    EOS_Connect_Credentials connectCrendentials = {
-                        EOS_CONNECT_CREDENTIALS_API_LATEST,
-                        TCHAR_TO_UTF8(*AccountCredentials.Token),
-                        externalType
+                    FLoginCompleteAdditionalData* additionalData = new FLoginCompleteAdditionalData{
+                        this,
+                        LocalUserNum,
+                        nullptr // Since this is the connect login flow, no EAID is available
                     };
+                    additionalData->ConnectType = externalType;
+                    additionalData->ConnectToken = AccountCredentials.Token;
 
                     // We need to check which external credentials type is used,
                     // as Apple and Nintendo require additional data.
-                    EOS_Connect_LoginOptions loginOptions;
                     if (externalType == EOS_EExternalCredentialType::EOS_ECT_APPLE_ID_TOKEN
                         || externalType == EOS_EExternalCredentialType::EOS_ECT_NINTENDO_ID_TOKEN
                         || externalType == EOS_EExternalCredentialType::EOS_ECT_NINTENDO_NSA_ID_TOKEN)
                     {
-                        EOS_Connect_UserLoginInfo loginInfo = {
-                            EOS_CONNECT_USERLOGININFO_API_LATEST,
-                            TCHAR_TO_UTF8(*AccountCredentials.Id)
-                        };
-                        loginOptions = {
-                            EOS_CONNECT_LOGIN_API_LATEST,
-                            &connectCrendentials,
-                            &loginInfo
-                        };
-                    }
-                    else
-                    {
-                        loginOptions = {
-                            EOS_CONNECT_LOGIN_API_LATEST,
-                            &connectCrendentials,
-                            nullptr
-                        };
+                        additionalData->ConnectDisplayName = AccountCredentials.Id;
                     }
 
-                    FLoginCompleteAdditionalData* additionalData = new FLoginCompleteAdditionalData{
-                        this,
-                        LocalUserNum,
-                        nullptr // Since this is the connect login flow, no EAID is available
-                    };
-                    EOS_Connect_Login(this->ConnectHandle, &loginOptions, additionalData,
-                                      &FOnlineIdentityInterfaceEpic::EOS_Connect_OnLoginComplete);
+                    this->ConnectLogin(additionalData);
 
                     bSuccess = true;
                 }
@@ -629,6 +779,9 @@ bool FOnlineIdentityInterfaceEpic::Login(int32 LocalUserNum, const FOnlineAccoun
     {
         UE_CLOG_ONLINE_IDENTITY(!ErrorMessage.IsEmpty(), Warning, TEXT("%s encountered an error. Message:\r\n    %s"),
                                 *FString(__FUNCTION__), *ErrorMessage);
+
+        // The early login waits for its own result, not for the one of the rejected login
+        TGuardValue<bool> RejectingGuard(this->bRejectingEarlyLoginConflict, bEarlyLoginConflict);
         this->TriggerOnLoginCompleteDelegates(LocalUserNum, false, FUniqueNetIdEpic(), ErrorMessage);
     }
 
@@ -643,6 +796,425 @@ bool FOnlineIdentityInterfaceEpic::AutoLogin(int32 LocalUserNum)
     return Login(LocalUserNum, Credentials);
 }
 
+TFuture<FOnlineLoginResultEpic> FOnlineIdentityInterfaceEpic::LoginAsync(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials)
+{
+    FOnlineLoginResultEpic FailedResult;
+    FailedResult.LocalUserNum = LocalUserNum;
+    FailedResult.Error = TEXT("The login didn't complete before the interface was shut down");
+    TSharedRef<TOnlineTrackedPromiseEpic<FOnlineLoginResultEpic>> Promise = this->PendingPromises.Make(MoveTemp(FailedResult));
+    TFuture<FOnlineLoginResultEpic> Future = Promise->GetFuture();
+
+    // Per user delegates only exist for valid indices, without one the login could never complete
+    if (LocalUserNum < 0 || LocalUserNum >= MAX_LOCAL_PLAYERS)
+    {
+        FOnlineLoginResultEpic Result;
+        Result.LocalUserNum = LocalUserNum;
+        Result.Error = FString::Printf(TEXT("\"%d\" is outside the range of allowed user indices [0 - %d["), LocalUserNum, MAX_LOCAL_PLAYERS);
+        Promise->SetValue(MoveTemp(Result));
+        return Future;
+    }
+
+    // The handler removes itself on the first login result for this user.
+    // Login delegates are raised from within the EOS callbacks, thus the promise is fulfilled in the same tick.
+    TSharedRef<FDelegateHandle> Handle = MakeShared<FDelegateHandle>();
+    *Handle = this->AddOnLoginCompleteDelegate_Handle(LocalUserNum, FOnLoginCompleteDelegate::CreateLambda(
+        [this, Promise, Handle](int32 InLocalUserNum, bool bWasSuccessful, const FUniqueNetId& UserId, const FString& Error)
+        {
+            this->ClearOnLoginCompleteDelegate_Handle(InLocalUserNum, *Handle);
+
+            FOnlineLoginResultEpic Result;
+            Result.LocalUserNum = InLocalUserNum;
+            Result.bWasSuccessful = bWasSuccessful;
+            if (UserId.GetType() == EPIC_SUBSYSTEM && UserId.IsValid())
+            {
+                Result.UserId = MakeShared<FUniqueNetIdEpic>(static_cast<FUniqueNetIdEpic const&>(UserId));
+            }
+            Result.Error = Error;
+            Promise->SetValue(MoveTemp(Result));
+        }));
+
+    this->Login(LocalUserNum, AccountCredentials);
+    return Future;
+}
+
+TFuture<FOnlineLoginResultEpic> FOnlineIdentityInterfaceEpic::AutoLoginAsync(int32 LocalUserNum)
+{
+    FOnlineAccountCredentials Credentials;
+    Credentials.Type = FString("EAS:PersistentAuth");
+
+    return LoginAsync(LocalUserNum, Credentials);
+}
+
+void FOnlineIdentityInterfaceEpic::StartEarlyAutoLogin()
+{
+    if (this->EarlyLoginState != EEarlyLoginState::None)
+    {
+        return;
+    }
+
+    UE_LOG_ONLINE_IDENTITY(Display, TEXT("Starting early auto login for local user 0"));
+
+    // The login can fail right away, in which case the handler runs before AutoLogin returns.
+    // The handler removes itself on the result of the early login, which is the first one for user 0 that isn't a rejected login.
+    this->EarlyLoginState = EEarlyLoginState::Starting;
+    TSharedRef<FDelegateHandle> Handle = MakeShared<FDelegateHandle>();
+    *Handle = this->AddOnLoginCompleteDelegate_Handle(0, FOnLoginCompleteDelegate::CreateLambda(
+        [this, Handle](int32 InLocalUserNum, bool bWasSuccessful, const FUniqueNetId& UserId, const FString& Error)
+        {
+            if (this->bRejectingEarlyLoginConflict)
+            {
+                return;
+            }
+            this->ClearOnLoginCompleteDelegate_Handle(InLocalUserNum, *Handle);
+
+            if (this->EarlyLoginState == EEarlyLoginState::Attached)
+            {
+                // The login delegates already told the game about the result
+                this->EarlyLoginState = EEarlyLoginState::None;
+                return;
+            }
+
+            UE_LOG_ONLINE_IDENTITY(Display, TEXT("Early auto login finished, keeping the result until the game logs in"));
+            this->EarlyLoginResult = FOnlineLoginResultEpic();
+            this->EarlyLoginResult.LocalUserNum = InLocalUserNum;
+            this->EarlyLoginResult.bWasSuccessful = bWasSuccessful;
+            if (UserId.GetType() == EPIC_SUBSYSTEM && UserId.IsValid())
+            {
+                this->EarlyLoginResult.UserId = MakeShared<FUniqueNetIdEpic>(static_cast<FUniqueNetIdEpic const&>(UserId));
+            }
+            this->EarlyLoginResult.Error = Error;
+            this->EarlyLoginState = EEarlyLoginState::Completed;
+        }));
+    this->AutoLogin(0);
+
+    if (this->EarlyLoginState == EEarlyLoginState::Starting)
+    {
+        this->EarlyLoginState = EEarlyLoginState::InFlight;
+    }
+}
+
+bool FOnlineIdentityInterfaceEpic::IsEarlyLoginRunning(int32 LocalUserNum) const
+{
+    return LocalUserNum == 0 && (this->EarlyLoginState == EEarlyLoginState::InFlight || this->EarlyLoginState == EEarlyLoginState::Attached);
+}
+
+bool FOnlineIdentityInterfaceEpic::AttachToEarlyLogin(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials)
+{
+    if (LocalUserNum != 0)
+    {
+        return false;
+    }
+
+    // Only a persistent auth login would have the same result as the early login, any other login uses its own credentials
+    if (!AccountCredentials.Type.Equals(TEXT("EAS:PersistentAuth"), ESearchCase::IgnoreCase))
+    {
+        if (this->EarlyLoginState == EEarlyLoginState::Completed)
+        {
+            this->EarlyLoginState = EEarlyLoginState::None;
+            this->EarlyLoginResult = FOnlineLoginResultEpic();
+        }
+        return false;
+    }
+
+    switch (this->EarlyLoginState)
+    {
+    case EEarlyLoginState::InFlight:
+        // The login delegates fire once the early login completes
+        this->EarlyLoginState = EEarlyLoginState::Attached;
+        return true;
+
+    case EEarlyLoginState::Attached:
+        return true;
+
+    case EEarlyLoginState::Completed:
+        {
+            // The result is handed out once. A failed early login lets the game log in with its own credentials.
+            this->EarlyLoginState = EEarlyLoginState::None;
+            if (!this->EarlyLoginResult.bWasSuccessful)
+            {
+                return false;
+            }
+
+            TSharedPtr<const FUniqueNetId> UserId = this->EarlyLoginResult.UserId;
+            this->EarlyLoginResult = FOnlineLoginResultEpic();
+            if (!UserId.IsValid())
+            {
+                return false;
+            }
+
+            this->TriggerOnLoginCompleteDelegates(LocalUserNum, true, *UserId, TEXT(""));
+            return true;
+        }
+
+    default:
+        return false;
+    }
+}
+
+TFuture<TArray<FOnlineLoginResultEpic>> FOnlineIdentityInterfaceEpic::LoginManyAsync(TArray<FOnlineLoginRequestEpic> const& Requests, int32 MaxConcurrentLogins)
+{
+    TSharedRef<FLoginBatchState> State = MakeShared<FLoginBatchState>();
+
+    // A local user can only run one login at a time, as their login delegates can't tell two logins apart.
+    // Later requests for a user already in the batch fail right away.
+    State->Results.SetNum(Requests.Num());
+    TSet<int32> BatchedUsers;
+    for (int32 i = 0; i < Requests.Num(); ++i)
+    {
+        bool bAlreadyInBatch = false;
+        BatchedUsers.Add(Requests[i].LocalUserNum, &bAlreadyInBatch);
+        if (bAlreadyInBatch)
+        {
+            State->Results[i].LocalUserNum = Requests[i].LocalUserNum;
+            State->Results[i].Error = FString::Printf(TEXT("Local user %d is already logged in by this batch"), Requests[i].LocalUserNum);
+            continue;
+        }
+
+        State->Requests.Add(Requests[i]);
+        State->ResultIndices.Add(i);
+    }
+
+    // If the interface shuts down first, the logins still running fail
+    TArray<FOnlineLoginResultEpic> FailedResults = State->Results;
+    for (int32 i = 0; i < State->Requests.Num(); ++i)
+    {
+        FOnlineLoginResultEpic& FailedResult = FailedResults[State->ResultIndices[i]];
+        FailedResult.LocalUserNum = State->Requests[i].LocalUserNum;
+        FailedResult.Error = TEXT("The login didn't complete before the interface was shut down");
+    }
+    State->Promise = this->PendingPromises.Make(MoveTemp(FailedResults));
+    TFuture<TArray<FOnlineLoginResultEpic>> Future = State->Promise->GetFuture();
+
+    State->Remaining = State->Requests.Num();
+    if (State->Remaining == 0)
+    {
+        State->Promise->SetValue(MoveTemp(State->Results));
+        return Future;
+    }
+
+    // Each login runs its Auth and Connect stage on its own, so the batch only takes as long as its slowest login
+    int32 Concurrency = FMath::Max(1, MaxConcurrentLogins);
+    for (int32 i = 0; i < Concurrency && State->NextRequest < State->Requests.Num(); ++i)
+    {
+        this->StartNextBatchLogin(State);
+    }
+
+    return Future;
+}
+
+void FOnlineIdentityInterfaceEpic::StartNextBatchLogin(TSharedRef<FLoginBatchState> const& State)
+{
+    const int32 RequestIndex = State->NextRequest++;
+    FOnlineLoginRequestEpic const& Request = State->Requests[RequestIndex];
+
+    this->LoginAsync(Request.LocalUserNum, Request.Credentials).Next([this, State, RequestIndex](FOnlineLoginResultEpic const& Result)
+        {
+            // The batch was failed on shutdown, don't start further logins
+            if (State->Promise->IsSet())
+            {
+                return;
+            }
+
+            State->Results[State->ResultIndices[RequestIndex]] = Result;
+            State->Remaining -= 1;
+
+            if (State->NextRequest < State->Requests.Num())
+            {
+                this->StartNextBatchLogin(State);
+            }
+            else if (State->Remaining == 0)
+            {
+                State->Promise->SetValue(MoveTemp(State->Results));
+            }
+        });
+}
+
+void FOnlineIdentityInterfaceEpic::StartAuthRefresh(int32 LocalUserNum)
+{
+    FLocalUserSlot const& Slot = this->LocalUsers[LocalUserNum];
+
+    // Refreshing would log the user in again
+    if (Slot.bLoggingOut)
+    {
+        return;
+    }
+
+    // Epic accounts get a fresh token from the auth interface, device ids need none. Everything else needs new credentials from the game.
+    if (!CanLogInAgain(Slot))
+    {
+        UE_LOG_ONLINE_IDENTITY(Display, TEXT("Asking the game for new credentials to refresh the auth of local user %d"), LocalUserNum);
+        this->TriggerOnLoginCredentialsNeededDelegates(LocalUserNum, false);
+        return;
+    }
+
+    FLoginCompleteAdditionalData* AdditionalData = new FLoginCompleteAdditionalData{
+        this,
+        LocalUserNum,
+        Slot.EpicAccountId
+    };
+    AdditionalData->ConnectType = Slot.ConnectType;
+    AdditionalData->ConnectDisplayName = Slot.ConnectDisplayName;
+    AdditionalData->bIsRefresh = true;
+
+    // Requests that need a valid auth wait for the refresh, instead of failing with an expired one.
+    // The rate limiter doesn't know which user a request is for, so the requests of all local users wait.
+    if (this->AuthRefreshHoldTime > 0)
+    {
+        for (EEpicOperation Operation : { EEpicOperation::Session, EEpicOperation::UserInfo, EEpicOperation::Presence })
+        {
+            AdditionalData->Holds.Add(MakeTuple(Operation, this->SubsystemEpic->RateLimiter->Hold(Operation, this->AuthRefreshHoldTime)));
+        }
+    }
+
+    this->ConnectLogin(AdditionalData);
+}
+
+void FOnlineIdentityInterfaceEpic::FinishAuthRefresh(FLoginCompleteAdditionalData* AdditionalData, EOS_EResult Result)
+{
+    // Only the holds of this refresh are released, a late refresh doesn't lift the holds of a newer one
+    for (TPair<EEpicOperation, uint32> const& Hold : AdditionalData->Holds)
+    {
+        this->SubsystemEpic->RateLimiter->Release(Hold.Key, Hold.Value);
+    }
+
+    if (Result == EOS_EResult::EOS_Success)
+    {
+        // The account holds on to the old tokens
+        this->InvalidateUserAccount(this->LocalUsers[AdditionalData->LocalUserNum].ProductUserId);
+        UE_LOG_ONLINE_IDENTITY(Display, TEXT("Refreshed auth of local user %d"), AdditionalData->LocalUserNum);
+    }
+    else
+    {
+        UE_LOG_ONLINE_IDENTITY(Warning, TEXT("Couldn't refresh auth of local user %d. Error: %s"), AdditionalData->LocalUserNum,
+                               UTF8_TO_TCHAR(EOS_EResult_ToString(Result)));
+    }
+}
+
+void FOnlineIdentityInterfaceEpic::ScheduleReconnect(int32 LocalUserNum)
+{
+    // Copy the slot, it is emptied right after this
+    FLocalUserSlot Slot = this->LocalUsers[LocalUserNum];
+
+    if (!CanLogInAgain(Slot))
+    {
+        UE_LOG_ONLINE_IDENTITY(Display, TEXT("Asking the game for new credentials to reconnect local user %d"), LocalUserNum);
+        this->TriggerOnLoginCredentialsNeededDelegates(LocalUserNum, true);
+        return;
+    }
+
+    // Epic accounts come back through persistent auth, which needs no user input
+    bool bPersistentAuth = Slot.ConnectType == EOS_EExternalCredentialType::EOS_ECT_EPIC;
+    this->SubsystemEpic->ReconnectScheduler->Schedule(LocalUserNum, bPersistentAuth, [this, LocalUserNum, Slot]()
+        {
+            this->StartReconnect(LocalUserNum, Slot);
+        });
+}
+
+void FOnlineIdentityInterfaceEpic::StartReconnect(int32 LocalUserNum, FLocalUserSlot const& Slot)
+{
+    // The EAS login usually survives losing the connect login, then a connect login with a fresh token is enough.
+    // Otherwise log in to EAS with persistent auth first, the auth callback continues with the connect login.
+    if (Slot.ConnectType == EOS_EExternalCredentialType::EOS_ECT_EPIC
+        && EOS_Auth_GetLoginStatus(this->AuthHandle, Slot.EpicAccountId) != EOS_ELoginStatus::EOS_LS_LoggedIn)
+    {
+        EOS_Auth_Credentials Credentials = {
+            EOS_AUTH_CREDENTIALS_API_LATEST
+        };
+        Credentials.Type = EOS_ELoginCredentialType::EOS_LCT_PersistentAuth;
+
+        EOS_Auth_LoginOptions LoginOptions = {};
+        LoginOptions.ApiVersion = EOS_AUTH_LOGIN_API_LATEST;
+        LoginOptions.ScopeFlags = EOS_EAuthScopeFlags::EOS_AS_BasicProfile |
+            EOS_EAuthScopeFlags::EOS_AS_FriendsList | EOS_EAuthScopeFlags::EOS_AS_Presence;
+        LoginOptions.Credentials = &Credentials;
+
+        FLoginCompleteAdditionalData* AdditionalData = new FLoginCompleteAdditionalData{
+            this,
+            LocalUserNum
+        };
+        AdditionalData->bIsReconnect = true;
+        EOS_Auth_Login(this->AuthHandle, &LoginOptions, AdditionalData, &FOnlineIdentityInterfaceEpic::EOS_Auth_OnLoginComplete);
+        return;
+    }
+
+    FLoginCompleteAdditionalData* AdditionalData = new FLoginCompleteAdditionalData{
+        this,
+        LocalUserNum,
+        Slot.EpicAccountId
+    };
+    AdditionalData->ConnectType = Slot.ConnectType;
+    AdditionalData->ConnectDisplayName = Slot.ConnectDisplayName;
+    AdditionalData->bIsReconnect = true;
+    this->ConnectLogin(AdditionalData);
+}
+
+void FOnlineIdentityInterfaceEpic::FinishReconnect(FLoginCompleteAdditionalData* AdditionalData, EOS_Connect_LoginCallbackInfo const* Data)
+{
+    bool bWasSuccessful = Data->ResultCode == EOS_EResult::EOS_Success;
+    if (bWasSuccessful)
+    {
+        // The SDK raises a login status change for the user, that's how the game learns they are back
+        this->InvalidateUserAccount(Data->LocalUserId);
+        this->RegisterLocalUser(AdditionalData->LocalUserNum, Data->LocalUserId, AdditionalData->EpicAccountId);
+        this->StoreLoginCredentials(AdditionalData);
+    }
+    else
+    {
+        UE_LOG_ONLINE_IDENTITY(Warning, TEXT("Couldn't reconnect local user %d. Error: %s"), AdditionalData->LocalUserNum,
+                               UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+    }
+
+    this->SubsystemEpic->ReconnectScheduler->Finished(AdditionalData->LocalUserNum, bWasSuccessful);
+}
+
+void FOnlineIdentityInterfaceEpic::ConnectLogin(FLoginCompleteAdditionalData* AdditionalData)
+{
+    // The token is read once the request leaves the rate limiter, so a queued login never sends a stale token
+    this->SubsystemEpic->RateLimiter->Submit(EEpicOperation::Login, [this, AdditionalData]()
+        {
+            // Epic account logins always use the current access token, as a stored one might have expired by now
+            if (AdditionalData->ConnectType == EOS_EExternalCredentialType::EOS_ECT_EPIC && EOS_EpicAccountId_IsValid(AdditionalData->EpicAccountId))
+            {
+                EOS_Auth_Token* AuthToken = nullptr;
+                EOS_Auth_CopyUserAuthTokenOptions CopyAuthTokenOptions = {
+                    EOS_AUTH_COPYUSERAUTHTOKEN_API_LATEST
+                };
+                if (EOS_Auth_CopyUserAuthToken(this->AuthHandle, &CopyAuthTokenOptions, AdditionalData->EpicAccountId, &AuthToken) == EOS_EResult::EOS_Success)
+                {
+                    AdditionalData->ConnectToken = UTF8_TO_TCHAR(AuthToken->AccessToken);
+                    EOS_Auth_Token_Release(AuthToken);
+                }
+            }
+
+            FTCHARToUTF8 Token(*AdditionalData->ConnectToken);
+            FTCHARToUTF8 DisplayName(*AdditionalData->ConnectDisplayName);
+
+            // Device id logins carry no token
+            EOS_Connect_Credentials ConnectCredentials = {
+                EOS_CONNECT_CREDENTIALS_API_LATEST,
+                AdditionalData->ConnectToken.IsEmpty() ? nullptr : Token.Get(),
+                AdditionalData->ConnectType
+            };
+            EOS_Connect_UserLoginInfo LoginInfo = {
+                EOS_CONNECT_USERLOGININFO_API_LATEST,
+                DisplayName.Get()
+            };
+            EOS_Connect_LoginOptions LoginOptions = {
+                EOS_CONNECT_LOGIN_API_LATEST,
+                &ConnectCredentials,
+                AdditionalData->ConnectDisplayName.IsEmpty() ? nullptr : &LoginInfo
+            };
+            EOS_Connect_Login(this->ConnectHandle, &LoginOptions, AdditionalData, &FOnlineIdentityInterfaceEpic::EOS_Connect_OnLoginComplete);
+        }, [AdditionalData]()
+        {
+            // Dropped on shutdown, the login completes as failed
+            EOS_Connect_LoginCallbackInfo Info = {};
+            Info.ResultCode = EOS_EResult::EOS_Canceled;
+            Info.ClientData = AdditionalData;
+            EOS_Connect_OnLoginComplete(&Info);
+        });
+}
+
 TSharedPtr<const FUniqueNetId> FOnlineIdentityInterfaceEpic::CreateUniquePlayerId(const FString& Str)
 {
     // This might not be useful, but we only create a new PUID from this
@@ -668,7 +1240,7 @@ TArray<TSharedPtr<FUserOnlineAccount>> FOnlineIdentityInterfaceEpic::GetAllUserA
     {
         EOS_ProductUserId ProductUserId = EOS_Connect_GetLoggedInUserByIndex(ConnectHandle, i);
 
-        TSharedPtr<FUserOnlineAccount> UserAccount = OnlineUserAccountFromPUID(ProductUserId);
+        TSharedPtr<FUserOnlineAccount> UserAccount = GetCachedUserAccount(ProductUserId);
 
         Accounts.Add(UserAccount);
     }
@@ -680,7 +1252,7 @@ TSharedPtr<FUserOnlineAccount> FOnlineIdentityInterfaceEpic::GetUserAccount(cons
     const TSharedRef<FUniqueNetIdEpic const> EpicNetId = StaticCastSharedRef<FUniqueNetIdEpic const>(UserId.AsShared());
     const EOS_ProductUserId ProductUserId = EpicNetId->ToProductUserId();
 
-    return OnlineUserAccountFromPUID(ProductUserId);
+    return GetCachedUserAccount(ProductUserId);
 }
 
 FString FOnlineIdentityInterfaceEpic::GetAuthToken(const int32 LocalUserNum) const
@@ -735,12 +1307,25 @@ ELoginStatus::Type FOnlineIdentityInterfaceEpic::GetLoginStatus(const int32 Loca
 
 FPlatformUserId FOnlineIdentityInterfaceEpic::GetPlatformUserIdFromUniqueNetId(const FUniqueNetId& UniqueNetId) const
 {
-    for (int i = 0; i < MAX_LOCAL_PLAYERS; ++i)
+    if (UniqueNetId.GetType() != EPIC_SUBSYSTEM)
+    {
+        return PLATFORMUSERID_NONE;
+    }
+
+    // Look up the PUID first, ids of EAS users might only carry their EAID
+    FUniqueNetIdEpic const& EpicNetId = static_cast<FUniqueNetIdEpic const&>(UniqueNetId);
+    if (EpicNetId.IsProductUserIdValid())
     {
-        auto id = GetUniquePlayerId(i);
-        if (id.IsValid() && (*id == UniqueNetId))
+        if (int32 const* LocalUserNum = this->LocalUserNumByProductUserId.Find(EpicNetId.ToProductUserId()))
         {
-            return i;
+            return *LocalUserNum;
+        }
+    }
+    if (EpicNetId.IsEpicAccountIdValid())
+    {
+        if (int32 const* LocalUserNum = this->LocalUserNumByEpicAccountId.Find(EpicNetId.ToEpicAccountId()))
+        {
+            return *LocalUserNum;
         }
     }
 
@@ -769,13 +1354,14 @@ FString FOnlineIdentityInterfaceEpic::GetPlayerNickname(int32 LocalUserNum) cons
 
 TSharedPtr<const FUniqueNetId> FOnlineIdentityInterfaceEpic::GetUniquePlayerId(int32 LocalUserNum) const
 {
-    EOS_ProductUserId AccountId = EOS_Connect_GetLoggedInUserByIndex(this->ConnectHandle, LocalUserNum);
-    EOS_EpicAccountId EpicAccountId = EOS_Auth_GetLoggedInAccountByIndex(this->AuthHandle, LocalUserNum);
-
-    if (EOS_ProductUserId_IsValid(AccountId))
+    if (0 <= LocalUserNum && LocalUserNum < MAX_LOCAL_PLAYERS)
     {
-        // We don't care if the EAID is invalid
-        return MakeShared<FUniqueNetIdEpic>(AccountId, EpicAccountId);
+        FLocalUserSlot const& Slot = this->LocalUsers[LocalUserNum];
+        if (EOS_ProductUserId_IsValid(Slot.ProductUserId))
+        {
+            // We don't care if the EAID is invalid
+            return MakeShared<FUniqueNetIdEpic>(Slot.ProductUserId, Slot.EpicAccountId);
+        }
     }
     return nullptr;
 }
@@ -783,8 +1369,122 @@ TSharedPtr<const FUniqueNetId> FOnlineIdentityInterfaceEpic::GetUniquePlayerId(i
 void FOnlineIdentityInterfaceEpic::GetUserPrivilege(const FUniqueNetId& LocalUserId, EUserPrivileges::Type Privilege,
                                                     const FOnGetUserPrivilegeCompleteDelegate& Delegate)
 {
-    // ToDo: Implement actual check against the backend
-    Delegate.ExecuteIfBound(LocalUserId, Privilege, static_cast<uint32>(EPrivilegeResults::NoFailures));
+    if (LocalUserId.GetType() != EPIC_SUBSYSTEM)
+    {
+        Delegate.ExecuteIfBound(LocalUserId, Privilege, static_cast<uint32>(EPrivilegeResults::GenericFailure));
+        return;
+    }
+
+    FUniqueNetIdEpic const& EpicUserId = static_cast<FUniqueNetIdEpic const&>(LocalUserId);
+    if (!EpicUserId.IsProductUserIdValid())
+    {
+        Delegate.ExecuteIfBound(LocalUserId, Privilege, static_cast<uint32>(EPrivilegeResults::UserNotLoggedIn));
+        return;
+    }
+
+    // Most checks are answered from the cache
+    TPair<EOS_ProductUserId, EUserPrivileges::Type> Key = MakeTuple(EpicUserId.ToProductUserId(), Privilege);
+    if (FCachedPrivilege const* Cached = this->PrivilegeCache.Find(Key))
+    {
+        if (Cached->ExpirationTime > FPlatformTime::Seconds())
+        {
+            Delegate.ExecuteIfBound(LocalUserId, Privilege, Cached->Result);
+            return;
+        }
+        this->PrivilegeCache.Remove(Key);
+    }
+
+    // Checks for the same user and privilege that overlap share a single evaluation
+    TSharedRef<FUniqueNetIdEpic const> CallerId = MakeShared<FUniqueNetIdEpic>(EpicUserId);
+    if (!this->PrivilegeCoalescer.Join(Key, [CallerId, Privilege, Delegate](uint32 const& PrivilegeResult)
+        {
+            Delegate.ExecuteIfBound(*CallerId, Privilege, PrivilegeResult);
+        }))
+    {
+        return;
+    }
+
+    switch (EOS_Connect_GetLoginStatus(this->ConnectHandle, Key.Key))
+    {
+    case EOS_ELoginStatus::EOS_LS_LoggedIn:
+        break;
+    case EOS_ELoginStatus::EOS_LS_UsingLocalProfile:
+        // A local profile can still play, but nothing that needs the backend
+        this->FinishPrivilegeCheck(Key.Key, Privilege, Privilege == EUserPrivileges::CanPlay
+            ? static_cast<uint32>(EPrivilegeResults::NoFailures)
+            : static_cast<uint32>(EPrivilegeResults::NetworkConnectionUnavailable));
+        return;
+    default:
+        this->FinishPrivilegeCheck(Key.Key, Privilege, static_cast<uint32>(EPrivilegeResults::UserNotLoggedIn));
+        return;
+    }
+
+    // Connect only users have nothing more to check. Epic accounts verify their auth token with the backend.
+    if (!EpicUserId.IsEpicAccountIdValid())
+    {
+        this->FinishPrivilegeCheck(Key.Key, Privilege, static_cast<uint32>(EPrivilegeResults::NoFailures));
+        return;
+    }
+
+    FVerifyUserAuthAdditionalData* AdditionalData = new FVerifyUserAuthAdditionalData{
+        this,
+        Key.Key,
+        Privilege
+    };
+    EOS_EpicAccountId EpicAccountId = EpicUserId.ToEpicAccountId();
+    this->SubsystemEpic->RateLimiter->Submit(EEpicOperation::Login, [this, AdditionalData, EpicAccountId]()
+        {
+            // The token is copied once the request leaves the rate limiter, a queued check never sends a stale token
+            EOS_Auth_Token* AuthToken = nullptr;
+            EOS_Auth_CopyUserAuthTokenOptions CopyAuthTokenOptions = {
+                EOS_AUTH_COPYUSERAUTHTOKEN_API_LATEST
+            };
+            if (EOS_Auth_CopyUserAuthToken(this->AuthHandle, &CopyAuthTokenOptions, EpicAccountId, &AuthToken) != EOS_EResult::EOS_Success)
+            {
+                // The user lost their EAS login while the check was queued
+                this->FinishPrivilegeCheck(AdditionalData->ProductUserId, AdditionalData->Privilege, static_cast<uint32>(EPrivilegeResults::UserNotLoggedIn));
+                delete(AdditionalData);
+                return;
+            }
+
+            EOS_Auth_VerifyUserAuthOptions VerifyOptions = {
+                EOS_AUTH_VERIFYUSERAUTH_API_LATEST,
+                AuthToken
+            };
+            EOS_Auth_VerifyUserAuth(this->AuthHandle, &VerifyOptions, AdditionalData, &FOnlineIdentityInterfaceEpic::EOS_Auth_OnVerifyUserAuthComplete);
+            EOS_Auth_Token_Release(AuthToken);
+        }, [AdditionalData]()
+        {
+            // Dropped on shutdown, the check completes as failed
+            EOS_Auth_VerifyUserAuthCallbackInfo Info = {};
+            Info.ResultCode = EOS_EResult::EOS_Canceled;
+            Info.ClientData = AdditionalData;
+            EOS_Auth_OnVerifyUserAuthComplete(&Info);
+        });
+}
+
+void FOnlineIdentityInterfaceEpic::FinishPrivilegeCheck(EOS_ProductUserId ProductUserId, EUserPrivileges::Type Privilege, uint32 PrivilegeResult)
+{
+    TPair<EOS_ProductUserId, EUserPrivileges::Type> Key = MakeTuple(ProductUserId, Privilege);
+
+    // A missing connection says nothing about the privilege, ask again next time
+    if (PrivilegeResult != static_cast<uint32>(EPrivilegeResults::NetworkConnectionUnavailable))
+    {
+        this->PrivilegeCache.Add(Key, FCachedPrivilege{ PrivilegeResult, FPlatformTime::Seconds() + this->PrivilegeCacheTTL });
+    }
+
+    this->PrivilegeCoalescer.Complete(Key, PrivilegeResult);
+}
+
+void FOnlineIdentityInterfaceEpic::InvalidatePrivileges(EOS_ProductUserId ProductUserId)
+{
+    for (auto It = this->PrivilegeCache.CreateIterator(); It; ++It)
+    {
+        if (It.Key().Key == ProductUserId)
+        {
+            It.RemoveCurrent();
+        }
+    }
 }
 
 bool FOnlineIdentityInterfaceEpic::Logout(int32 LocalUserNum)
@@ -802,8 +1502,8 @@ bool FOnlineIdentityInterfaceEpic::Logout(int32 LocalUserNum)
                 NetIdEpic->ToEpicAccountId()
             };
 
-            const EOS_EpicAccountId EpicAccountId = EOS_Auth_GetLoggedInAccountByIndex(AuthHandle, LocalUserNum);
-            LogoutOpts.LocalUserId = EpicAccountId;
+            // The connect login of the user ends with the EAS one, which must not bring them back
+            this->LocalUsers[LocalUserNum].bLoggingOut = true;
             EOS_Auth_Logout(AuthHandle, &LogoutOpts, this, &FOnlineIdentityInterfaceEpic::EOS_Auth_OnLogoutComplete);
         }
         else
@@ -811,9 +1511,15 @@ bool FOnlineIdentityInterfaceEpic::Logout(int32 LocalUserNum)
             UE_LOG_ONLINE_IDENTITY(Display, TEXT("[EOS SDK] No valid epic account id for logout found."));
         }
 
-        // Remove the user id from the local cache
-        TSharedRef<const FUniqueNetIdEpic> idRef = NetIdEpic.ToSharedRef();
-        ///this->userAccounts.Remove(idRef);
+        // Remove the user account from the local cache.
+        // EAS users keep their slot until the logout callback, as it needs the slot to find the local user.
+        this->InvalidateUserAccount(NetIdEpic->ToProductUserId());
+        this->InvalidatePrivileges(NetIdEpic->ToProductUserId());
+        this->SubsystemEpic->ReconnectScheduler->Cancel(LocalUserNum);
+        if (!NetIdEpic->IsEpicAccountIdValid())
+        {
+            this->UnregisterLocalUser(LocalUserNum);
+        }
     }
     else
     {
@@ -842,7 +1548,7 @@ void FOnlineIdentityInterfaceEpic::RevokeAuthToken(const FUniqueNetId& LocalUser
 // Utility Methods
 //-------------------------------
 
-TSharedPtr<FUserOnlineAccount> FOnlineIdentityInterfaceEpic::OnlineUserAccountFromPUID(
+TSharedPtr<FUserOnlineAccountEpic> FOnlineIdentityInterfaceEpic::OnlineUserAccountFromPUID(
     EOS_ProductUserId const& PUID) const
 {
     EOS_Connect_ExternalAccountInfo* ExternalAccountInfo = nullptr;
@@ -858,7 +1564,11 @@ TSharedPtr<FUserOnlineAccount> FOnlineIdentityInterfaceEpic::OnlineUserAccountFr
 
     TSharedPtr<FUserOnlineAccountEpic> UserAccount = nullptr;
 
-    check(ExternalAccountInfo != nullptr);
+    // Users that are not logged in have no product user info
+    if (ConnectResult != EOS_EResult::EOS_Success || ExternalAccountInfo == nullptr)
+    {
+        return UserAccount;
+    }
     
     // Check if this user account is also owned by EPIC and if, make calls to the Auth interface
     if (ExternalAccountInfo->AccountIdType == EOS_EExternalAccountType::EOS_EAT_EPIC)
@@ -911,6 +1621,91 @@ TSharedPtr<FUserOnlineAccount> FOnlineIdentityInterfaceEpic::OnlineUserAccountFr
     return UserAccount;
 }
 
+TSharedPtr<FUserOnlineAccountEpic> FOnlineIdentityInterfaceEpic::GetCachedUserAccount(EOS_ProductUserId const& PUID) const
+{
+    if (TSharedPtr<FUserOnlineAccountEpic> const* CachedAccount = this->UserAccountCache.Find(PUID))
+    {
+        return *CachedAccount;
+    }
+
+    TSharedPtr<FUserOnlineAccountEpic> UserAccount = OnlineUserAccountFromPUID(PUID);
+    if (UserAccount)
+    {
+        this->UserAccountCache.Add(PUID, UserAccount);
+    }
+    return UserAccount;
+}
+
+void FOnlineIdentityInterfaceEpic::InvalidateUserAccount(EOS_ProductUserId const& PUID)
+{
+    this->UserAccountCache.Remove(PUID);
+}
+
+void FOnlineIdentityInterfaceEpic::RegisterLocalUser(int32 LocalUserNum, EOS_ProductUserId ProductUserId, EOS_EpicAccountId EpicAccountId)
+{
+    check(0 <= LocalUserNum && LocalUserNum < MAX_LOCAL_PLAYERS);
+
+    // Clear whatever the slot held before, and whatever slot these ids held before
+    this->UnregisterLocalUser(LocalUserNum);
+    if (int32 const* OldLocalUserNum = this->LocalUserNumByProductUserId.Find(ProductUserId))
+    {
+        this->UnregisterLocalUser(*OldLocalUserNum);
+    }
+
+    FLocalUserSlot& Slot = this->LocalUsers[LocalUserNum];
+    Slot.ProductUserId = ProductUserId;
+    Slot.EpicAccountId = EOS_EpicAccountId_IsValid(EpicAccountId) ? EpicAccountId : nullptr;
+
+    this->LocalUserNumByProductUserId.Add(ProductUserId, LocalUserNum);
+    if (Slot.EpicAccountId)
+    {
+        this->LocalUserNumByEpicAccountId.Add(Slot.EpicAccountId, LocalUserNum);
+    }
+}
+
+bool FOnlineIdentityInterfaceEpic::CanLogInAgain(FLocalUserSlot const& Slot)
+{
+    switch (Slot.ConnectType)
+    {
+    case EOS_EExternalCredentialType::EOS_ECT_EPIC:
+        return Slot.EpicAccountId != nullptr;
+    case EOS_EExternalCredentialType::EOS_ECT_DEVICEID_ACCESS_TOKEN:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void FOnlineIdentityInterfaceEpic::StoreLoginCredentials(FLoginCompleteAdditionalData const* AdditionalData)
+{
+    // The token stays out of the slot, it is a secret of the platform the user logged in with
+    FLocalUserSlot& Slot = this->LocalUsers[AdditionalData->LocalUserNum];
+    Slot.ConnectType = AdditionalData->ConnectType;
+    Slot.ConnectDisplayName = AdditionalData->ConnectDisplayName;
+
+    // The bot farm must never replace a device id a player logged in with
+    if (Slot.ConnectType == EOS_EExternalCredentialType::EOS_ECT_DEVICEID_ACCESS_TOKEN && this->SubsystemEpic->BotFarm)
+    {
+        this->SubsystemEpic->BotFarm->OnPlayerDeviceIdLogin();
+    }
+}
+
+void FOnlineIdentityInterfaceEpic::UnregisterLocalUser(int32 LocalUserNum)
+{
+    check(0 <= LocalUserNum && LocalUserNum < MAX_LOCAL_PLAYERS);
+
+    FLocalUserSlot& Slot = this->LocalUsers[LocalUserNum];
+    if (Slot.ProductUserId)
+    {
+        this->LocalUserNumByProductUserId.Remove(Slot.ProductUserId);
+    }
+    if (Slot.EpicAccountId)
+    {
+        this->LocalUserNumByEpicAccountId.Remove(Slot.EpicAccountId);
+    }
+    Slot = FLocalUserSlot();
+}
+
 ELoginStatus::Type FOnlineIdentityInterfaceEpic::EOSLoginStatusToUELoginStatus(EOS_ELoginStatus LoginStatus)
 {
     switch (LoginStatus)
@@ -1,12 +1,18 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 #include "OnlineSubsystemTypes.h"
 #include "Interfaces/OnlineIdentityInterface.h"
 #include "OnlineSubsystemEpicTypes.h"
+#include "OnlineRequestCoalescerEpic.h"
+#include "OnlinePromiseTrackerEpic.h"
+#include "OnlineApiTypesEpic.h"
 #include "eos_sdk.h"
 
 class FOnlineSubsystemEpic;
+struct FLoginCompleteAdditionalData;
+struct FLoginBatchState;
 
 class FOnlineIdentityInterfaceEpic
 	: public IOnlineIdentity
@@ -21,6 +27,79 @@ class FOnlineIdentityInterfaceEpic
 
 	EOS_NotificationId NotifyAuthExpiration;
 
+	/** The promises of the future based API that are still outstanding */
+	FOnlinePromiseTrackerEpic PendingPromises;
+
+	/**
+	 * One account object per logged in user, built on first access.
+	 * Entries are dropped when the user logs in or out, their login status changes, or their auth expires,
+	 * and are rebuilt from the SDK on the next access.
+	 */
+	mutable TMap<EOS_ProductUserId, TSharedPtr<FUserOnlineAccountEpic>> UserAccountCache;
+
+	/** The ids of the user logged in on a local user slot */
+	struct FLocalUserSlot
+	{
+		EOS_ProductUserId ProductUserId = nullptr;
+		EOS_EpicAccountId EpicAccountId = nullptr;
+
+		// How the user logged in. The token isn't kept, only logins that need none are repeated in the background
+		EOS_EExternalCredentialType ConnectType = EOS_EExternalCredentialType::EOS_ECT_EPIC;
+		FString ConnectDisplayName;
+
+		// Set from Logout until the logout callback, the user losing their login meanwhile is no reason to log them in again
+		bool bLoggingOut = false;
+	};
+
+	/**
+	 * Maps local user numbers to their ids and back.
+	 * Filled when a login completes, and cleared on logout or when the SDK reports the user as logged out.
+	 */
+	FLocalUserSlot LocalUsers[MAX_LOCAL_PLAYERS];
+	TMap<EOS_ProductUserId, int32> LocalUserNumByProductUserId;
+	TMap<EOS_EpicAccountId, int32> LocalUserNumByEpicAccountId;
+
+	/** The longest time in seconds requests are held back while a user's auth is refreshed. Holds the requests of every user, 0 disables it */
+	float AuthRefreshHoldTime;
+
+	enum class EEarlyLoginState : uint8
+	{
+		/** No early login, or its result was handed out already */
+		None,
+		/** The login is being started */
+		Starting,
+		/** The login runs and nobody asked for it yet */
+		InFlight,
+		/** The login runs and the game logged in meanwhile, the login delegates deliver the result */
+		Attached,
+		/** The login is done and the result waits for the game to log in */
+		Completed
+	};
+
+	/** The state of the early auto login of local user 0 */
+	EEarlyLoginState EarlyLoginState;
+
+	/** The result of the early auto login, kept until the game logs in */
+	FOnlineLoginResultEpic EarlyLoginResult;
+
+	/** Set while a login is failed because the early login runs, so the early login doesn't take that result for its own */
+	bool bRejectingEarlyLoginConflict;
+
+	struct FCachedPrivilege
+	{
+		uint32 Result;
+		double ExpirationTime;
+	};
+
+	/** Evaluated privileges per user, dropped when they expire or the user's login status changes */
+	TMap<TPair<EOS_ProductUserId, EUserPrivileges::Type>, FCachedPrivilege> PrivilegeCache;
+
+	/** Joins overlapping privilege checks for the same user and privilege */
+	TOnlineRequestCoalescerEpic<TPair<EOS_ProductUserId, EUserPrivileges::Type>, uint32> PrivilegeCoalescer;
+
+	/** The time in seconds a privilege check result is reused */
+	float PrivilegeCacheTTL;
+
 	FOnlineIdentityInterfaceEpic() = delete;
 
 	static void EOS_CALL EOS_Connect_OnLoginComplete(const EOS_Connect_LoginCallbackInfo* Data);
@@ -28,10 +107,68 @@ class FOnlineIdentityInterfaceEpic
 	static void EOS_CALL EOS_Connect_OnLoginStatusChanged(const EOS_Connect_LoginStatusChangedCallbackInfo* Data);
 	static void EOS_CALL EOS_Auth_OnLoginComplete(const EOS_Auth_LoginCallbackInfo* Data);
 	static void EOS_CALL EOS_Auth_OnLogoutComplete(const EOS_Auth_LogoutCallbackInfo* Data);
+	static void EOS_CALL EOS_Auth_OnVerifyUserAuthComplete(const EOS_Auth_VerifyUserAuthCallbackInfo* Data);
 	static void EOS_CALL EOS_Connect_OnUserCreated(const EOS_Connect_CreateUserCallbackInfo* Data);
 	static void EOS_CALL EOS_Connect_OnAccountLinked(const EOS_Connect_LinkAccountCallbackInfo* Data);
 
-	TSharedPtr<FUserOnlineAccount> OnlineUserAccountFromPUID(EOS_ProductUserId const& PUID) const;
+	/**
+	 * Starts a connect login with the credentials stored in the additional data.
+	 * Takes ownership of the additional data, which is passed on to the login callback.
+	 */
+	void ConnectLogin(FLoginCompleteAdditionalData* AdditionalData);
+
+	/** Logs a local user in again with the credentials of their last login, to extend their auth before it expires */
+	void StartAuthRefresh(int32 LocalUserNum);
+
+	/**
+	 * Hands the early auto login to a persistent auth login call for the same user.
+	 * @returns - True if the call is answered by the early login, false if it has to log in itself
+	 */
+	bool AttachToEarlyLogin(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials);
+
+	/** Whether the early auto login of a user still runs */
+	bool IsEarlyLoginRunning(int32 LocalUserNum) const;
+
+	/** Starts the next login of a batch, and the one after that once it completes */
+	void StartNextBatchLogin(TSharedRef<FLoginBatchState> const& State);
+
+	/** Called by the login callback once a refresh is done */
+	void FinishAuthRefresh(FLoginCompleteAdditionalData* AdditionalData, EOS_EResult Result);
+
+	TSharedPtr<FUserOnlineAccountEpic> OnlineUserAccountFromPUID(EOS_ProductUserId const& PUID) const;
+
+	/** Returns the cached account of a logged in user, building it if there is none yet */
+	TSharedPtr<FUserOnlineAccountEpic> GetCachedUserAccount(EOS_ProductUserId const& PUID) const;
+
+	/** Drops the cached account of a user, the next access rebuilds it */
+	void InvalidateUserAccount(EOS_ProductUserId const& PUID);
+
+	/** Puts a logged in user into a local user slot, replacing whoever was in there */
+	void RegisterLocalUser(int32 LocalUserNum, EOS_ProductUserId ProductUserId, EOS_EpicAccountId EpicAccountId);
+
+	/** Empties a local user slot */
+	void UnregisterLocalUser(int32 LocalUserNum);
+
+	/** Caches the result of a privilege evaluation and passes it to every check waiting for it */
+	void FinishPrivilegeCheck(EOS_ProductUserId ProductUserId, EUserPrivileges::Type Privilege, uint32 PrivilegeResult);
+
+	/** Drops all cached privileges of a user */
+	void InvalidatePrivileges(EOS_ProductUserId ProductUserId);
+
+	/** Whether the login of a slot can be repeated without new credentials, which works for Epic accounts and device ids only */
+	static bool CanLogInAgain(FLocalUserSlot const& Slot);
+
+	/** Stores how a completed login was made in the user's slot */
+	void StoreLoginCredentials(FLoginCompleteAdditionalData const* AdditionalData);
+
+	/** Hands a user that lost their login to the reconnect scheduler, or asks the game for new credentials */
+	void ScheduleReconnect(int32 LocalUserNum);
+
+	/** Called by the reconnect scheduler, logs the user in again */
+	void StartReconnect(int32 LocalUserNum, FLocalUserSlot const& Slot);
+
+	/** Called by the login callback once a reconnect is done */
+	void FinishReconnect(FLoginCompleteAdditionalData* AdditionalData, EOS_Connect_LoginCallbackInfo const* Data);
 	ELoginStatus::Type EOSLoginStatusToUELoginStatus(EOS_ELoginStatus LoginStatus);
 
 public:
@@ -56,4 +193,42 @@ public:
 	virtual void GetUserPrivilege(const FUniqueNetId& LocalUserId, EUserPrivileges::Type Privilege, const FOnGetUserPrivilegeCompleteDelegate& Delegate) override;
 	virtual bool Logout(int32 LocalUserNum) override;
 	virtual void RevokeAuthToken(const FUniqueNetId& LocalUserId, const FOnRevokeAuthTokenCompleteDelegate& Delegate) override;
+
+	// Future based API.
+	// The futures are completed from within the EOS callback that finishes the operation,
+	// continuations attached with Then() or Next() therefore run in the same EOS_Platform_Tick.
+
+	/** Same as Login(), but returns a future instead of raising only the login delegates */
+	TFuture<FOnlineLoginResultEpic> LoginAsync(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials);
+
+	/** Same as AutoLogin(), but returns a future instead of raising only the login delegates */
+	TFuture<FOnlineLoginResultEpic> AutoLoginAsync(int32 LocalUserNum);
+
+	/**
+	 * Starts a persistent auth login for local user 0 in the background.
+	 * The first Login or AutoLogin call for that user waits for it, or gets its result right away if it's done.
+	 * Used by the subsystem at startup, if EarlyAutoLogin is set.
+	 */
+	void StartEarlyAutoLogin();
+
+	/**
+	 * Logs in several local users at once. The logins run concurrently, each one going through its Auth and Connect stage independently.
+	 * The usual per user login delegates are raised for every login.
+	 * @param Requests - The users to log in. Every local user may only appear once
+	 * @param MaxConcurrentLogins - The maximum number of logins running at the same time
+	 * @returns - A future completing once all logins are done, with the results in the order of the requests
+	 */
+	TFuture<TArray<FOnlineLoginResultEpic>> LoginManyAsync(TArray<FOnlineLoginRequestEpic> const& Requests, int32 MaxConcurrentLogins = 4);
+
+	/**
+	 * Raised instead of refreshing or reconnecting a user that logged in with credentials that aren't kept.
+	 * The game logs the user in again with fresh credentials.
+	 */
+	DEFINE_ONLINE_DELEGATE_TWO_PARAM(OnLoginCredentialsNeeded, int32, bool);
+
+	/** Fails the futures of the operations still running. Called by the subsystem on shutdown */
+	void FailPendingFutures()
+	{
+		this->PendingPromises.FailAll();
+	}
 };
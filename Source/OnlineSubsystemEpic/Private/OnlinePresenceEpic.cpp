@@ -1,6 +1,9 @@
 #include "OnlinePresenceEpic.h"
 #include "eos_presence.h"
 #include "OnlineSubsystemEpicTypes.h"
+#include "OnlineRetryPolicyEpic.h"
+#include "OnlineRateLimiterEpic.h"
+#include "OnlineWriteJournalEpic.h"
 #include "eos_connect.h"
 #include "eos_userinfo.h"
 #include "eos_sessions.h"
@@ -15,9 +18,13 @@
 // ---------------------------------------------
 typedef struct FPresenceAdditionalData
 {
-	FOnlinePresenceEpic const* This;
-	FUniqueNetIdEpic const& EpicNetId;
-	FOnlinePresenceEpic::FOnPresenceTaskCompleteDelegate const& Delegate;
+	FOnlinePresenceEpic* This;
+	FUniqueNetIdEpic EpicNetId;
+	FOnlinePresenceEpic::FOnPresenceTaskCompleteDelegate Delegate;
+	int32 Attempt = 1;
+
+	// The presence being set, journaled again if the connection is lost
+	FOnlineUserPresenceStatus Status;
 } FSetPresenceAdditionalData;
 
 typedef struct FQueryExternalMappingForPresenceAdditionalInformation
@@ -34,7 +41,12 @@ void FOnlinePresenceEpic::EOS_SetPresenceComplete(EOS_Presence_SetPresenceCallba
 {
 	FPresenceAdditionalData* additionalData = static_cast<FPresenceAdditionalData*>(data->ClientData);
 
-	if (data->ResultCode == EOS_EResult::EOS_Success)
+	if (additionalData->This->Subsystem->WriteJournal->NoteResult(data->ResultCode))
+	{
+		additionalData->This->DeferSetPresence(additionalData->EpicNetId, additionalData->Status);
+		additionalData->Delegate.ExecuteIfBound(additionalData->EpicNetId, true);
+	}
+	else if (data->ResultCode == EOS_EResult::EOS_Success)
 	{
 		UE_LOG_ONLINE_PRESENCE(Display, TEXT("[EOS SDK] Sucessfully updated presence for user \"%s\""), *FUniqueNetIdEpic::EpicAccountIdToString(data->LocalUserId));
 		additionalData->Delegate.ExecuteIfBound(additionalData->EpicNetId, true);
@@ -53,12 +65,34 @@ void FOnlinePresenceEpic::EOS_QueryPresenceComplete(EOS_Presence_QueryPresenceCa
 {
 	FPresenceAdditionalData* additionalData = static_cast<FPresenceAdditionalData*>(data->ClientData);
 
+	// Transient failures reissue the query with the same additional data
+	EOS_EpicAccountId localUserId = data->LocalUserId;
+	EOS_EpicAccountId targetUserId = data->TargetUserId;
+	if (additionalData->This->Subsystem->RetryPolicy->ScheduleRetry(EEpicOperation::Presence, data->ResultCode, additionalData->Attempt, [additionalData, localUserId, targetUserId]()
+		{
+			additionalData->Attempt += 1;
+			additionalData->This->IssueQueryPresence(additionalData, localUserId, targetUserId);
+		}, [additionalData, localUserId, targetUserId]()
+		{
+			// Dropped on shutdown, the query completes as failed
+			EOS_Presence_QueryPresenceCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = additionalData;
+			info.LocalUserId = localUserId;
+			info.TargetUserId = targetUserId;
+			EOS_QueryPresenceComplete(&info);
+		}))
+	{
+		return;
+	}
+
 	bool success = data->ResultCode == EOS_EResult::EOS_Success;
 
 	UE_CLOG_ONLINE_PRESENCE(success, Display, TEXT("[EOS SDK] Sucessfully queried presence for user: %s"), UTF8_TO_TCHAR(data->TargetUserId));
 	UE_CLOG_ONLINE_PRESENCE(!success, Warning, TEXT("[EOS SDK] QueryPresence encountered an error: %s"), *FString(__FUNCTION__));
 
-	additionalData->Delegate.ExecuteIfBound(additionalData->EpicNetId, success);
+	// Hand the result to every caller that asked for this presence while the query was running
+	additionalData->This->QueryPresenceCoalescer.Complete(MakeTuple(localUserId, targetUserId), success);
 
 	delete additionalData;
 }
@@ -229,6 +263,28 @@ void FOnlinePresenceEpic::EOS_QueryExternalAccountMappingsForPresenceComplete(EO
 //-------------------------------
 // Utility Methods
 //-------------------------------
+void FOnlinePresenceEpic::IssueQueryPresence(FPresenceAdditionalData* AdditionalData, EOS_EpicAccountId LocalUserId, EOS_EpicAccountId TargetUserId)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Presence, [this, AdditionalData, LocalUserId, TargetUserId]()
+		{
+			EOS_Presence_QueryPresenceOptions queryPresenceOptions = {
+				EOS_PRESENCE_QUERYPRESENCE_API_LATEST,
+				LocalUserId,
+				TargetUserId
+			};
+			EOS_Presence_QueryPresence(this->PresenceHandle, &queryPresenceOptions, AdditionalData, &FOnlinePresenceEpic::EOS_QueryPresenceComplete);
+		}, [AdditionalData, LocalUserId, TargetUserId]()
+		{
+			// Dropped on shutdown, the query completes as failed
+			EOS_Presence_QueryPresenceCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = AdditionalData;
+			info.LocalUserId = LocalUserId;
+			info.TargetUserId = TargetUserId;
+			EOS_QueryPresenceComplete(&info);
+		});
+}
+
 EOnlinePresenceState::Type FOnlinePresenceEpic::EOSPresenceStateToUEPresenceState(EOS_Presence_EStatus status) const
 {
 	switch (status)
@@ -288,7 +344,13 @@ void FOnlinePresenceEpic::SetPresence(const FUniqueNetId& User, const FOnlineUse
 	FString error;
 
 	FUniqueNetIdEpic const epicNetId = static_cast<FUniqueNetIdEpic const>(User);
-	if (epicNetId.IsEpicAccountIdValid())
+	if (epicNetId.IsEpicAccountIdValid() && this->Subsystem->WriteJournal->ShouldDefer(epicNetId.ToProductUserId()))
+	{
+		// The presence is sent once the user is back online
+		this->DeferSetPresence(epicNetId, Status);
+		Delegate.ExecuteIfBound(User, true);
+	}
+	else if (epicNetId.IsEpicAccountIdValid())
 	{
 		EOS_HPresenceModification modHandle = nullptr;
 		EOS_Presence_CreatePresenceModificationOptions createPresenceModOptions = {
@@ -341,17 +403,34 @@ void FOnlinePresenceEpic::SetPresence(const FUniqueNetId& User, const FOnlineUse
 					if (eosResult == EOS_EResult::EOS_Success)
 					{
 						// Finally update the presence itself.
-						EOS_Presence_SetPresenceOptions setPresenceOptions = {
-							EOS_PRESENCE_SETPRESENCE_API_LATEST,
-							epicNetId.ToEpicAccountId(),
-							modHandle
-						};
 						FPresenceAdditionalData* additionalData = new FPresenceAdditionalData{
 							this,
 							epicNetId,
 							Delegate
 						};
-						EOS_Presence_SetPresence(this->PresenceHandle, &setPresenceOptions, additionalData, &FOnlinePresenceEpic::EOS_SetPresenceComplete);
+						additionalData->Status = Status;
+						EOS_EpicAccountId localUserId = epicNetId.ToEpicAccountId();
+						this->Subsystem->RateLimiter->Submit(EEpicOperation::Presence, [this, additionalData, localUserId, modHandle]()
+							{
+								EOS_Presence_SetPresenceOptions setPresenceOptions = {
+									EOS_PRESENCE_SETPRESENCE_API_LATEST,
+									localUserId,
+									modHandle
+								};
+								EOS_Presence_SetPresence(this->PresenceHandle, &setPresenceOptions, additionalData, &FOnlinePresenceEpic::EOS_SetPresenceComplete);
+
+								// The SDK copies what it needs, the handle can be released right away
+								EOS_PresenceModification_Release(modHandle);
+							}, [additionalData, localUserId, modHandle]()
+							{
+								// Dropped on shutdown, the update completes as failed
+								EOS_PresenceModification_Release(modHandle);
+								EOS_Presence_SetPresenceCallbackInfo info = {};
+								info.ResultCode = EOS_EResult::EOS_Canceled;
+								info.ClientData = additionalData;
+								info.LocalUserId = localUserId;
+								EOS_SetPresenceComplete(&info);
+							});
 					}
 					else
 					{
@@ -381,32 +460,79 @@ void FOnlinePresenceEpic::SetPresence(const FUniqueNetId& User, const FOnlineUse
 	if (!error.IsEmpty())
 	{
 		UE_LOG_ONLINE_PRESENCE(Warning, TEXT("%s encounted an error. Message: %s"), *FString(__FUNCTION__), *error);
+		Delegate.ExecuteIfBound(User, false);
 	}
 }
 
+void FOnlinePresenceEpic::DeferSetPresence(FUniqueNetIdEpic const& User, FOnlineUserPresenceStatus const& Status)
+{
+	// Only the latest presence of a user is worth sending
+	TSharedRef<FUniqueNetIdEpic const> user = MakeShared<FUniqueNetIdEpic>(User);
+	this->Subsystem->WriteJournal->Record(FString::Printf(TEXT("Presence:%s"), *FUniqueNetIdEpic::EpicAccountIdToString(User.ToEpicAccountId())), [this, user, Status]()
+		{
+			this->SetPresence(*user, Status);
+		});
+}
+
 void FOnlinePresenceEpic::QueryPresence(const FUniqueNetId& User, const FOnPresenceTaskCompleteDelegate& Delegate)
 {
 	FUniqueNetIdEpic const& epicUser = static_cast<FUniqueNetIdEpic>(User);
 	if (epicUser.IsEpicAccountIdValid())
 	{
-		EOS_Presence_QueryPresenceOptions queryPresenceOptions = {
-			EOS_PRESENCE_QUERYPRESENCE_API_LATEST,
-			epicUser.ToEpicAccountId(),
-			epicUser.ToEpicAccountId()
-		};
-		FPresenceAdditionalData* additionalData = new FPresenceAdditionalData{
-			this,
-			epicUser,
-			Delegate
-		};
-		EOS_Presence_QueryPresence(this->PresenceHandle, &queryPresenceOptions, additionalData, &FOnlinePresenceEpic::EOS_QueryPresenceComplete);
+		// Only the first of several overlapping queries for the same user is sent, the others join it
+		TPair<EOS_EpicAccountId, EOS_EpicAccountId> key = MakeTuple(epicUser.ToEpicAccountId(), epicUser.ToEpicAccountId());
+		FUniqueNetIdEpic callerNetId = epicUser;
+		if (this->QueryPresenceCoalescer.Join(key, [callerNetId, Delegate](bool const& bWasSuccessful)
+			{
+				Delegate.ExecuteIfBound(callerNetId, bWasSuccessful);
+			}))
+		{
+			FPresenceAdditionalData* additionalData = new FPresenceAdditionalData{
+				this,
+				epicUser
+			};
+			this->IssueQueryPresence(additionalData, key.Key, key.Value);
+		}
 	}
 	else
 	{
 		UE_LOG_ONLINE_PRESENCE(Warning, TEXT("%s: UserId doesn't contain a valid epic account id."), *FString(__FUNCTION__));
+		Delegate.ExecuteIfBound(User, false);
 	}
 }
 
+TFuture<FOnlinePresenceResultEpic> FOnlinePresenceEpic::SetPresenceAsync(const FUniqueNetId& User, const FOnlineUserPresenceStatus& Status)
+{
+	TSharedRef<TOnlineTrackedPromiseEpic<FOnlinePresenceResultEpic>> promise = this->PendingPromises.Make(FOnlinePresenceResultEpic{ MakeShared<FUniqueNetIdEpic>(static_cast<FUniqueNetIdEpic const&>(User)), false });
+	TFuture<FOnlinePresenceResultEpic> future = promise->GetFuture();
+
+	this->SetPresence(User, Status, FOnPresenceTaskCompleteDelegate::CreateLambda([promise](const FUniqueNetId& UserId, const bool bWasSuccessful)
+		{
+			FOnlinePresenceResultEpic result;
+			result.UserId = MakeShared<FUniqueNetIdEpic>(static_cast<FUniqueNetIdEpic const&>(UserId));
+			result.bWasSuccessful = bWasSuccessful;
+			promise->SetValue(MoveTemp(result));
+		}));
+
+	return future;
+}
+
+TFuture<FOnlinePresenceResultEpic> FOnlinePresenceEpic::QueryPresenceAsync(const FUniqueNetId& User)
+{
+	TSharedRef<TOnlineTrackedPromiseEpic<FOnlinePresenceResultEpic>> promise = this->PendingPromises.Make(FOnlinePresenceResultEpic{ MakeShared<FUniqueNetIdEpic>(static_cast<FUniqueNetIdEpic const&>(User)), false });
+	TFuture<FOnlinePresenceResultEpic> future = promise->GetFuture();
+
+	this->QueryPresence(User, FOnPresenceTaskCompleteDelegate::CreateLambda([promise](const FUniqueNetId& UserId, const bool bWasSuccessful)
+		{
+			FOnlinePresenceResultEpic result;
+			result.UserId = MakeShared<FUniqueNetIdEpic>(static_cast<FUniqueNetIdEpic const&>(UserId));
+			result.bWasSuccessful = bWasSuccessful;
+			promise->SetValue(MoveTemp(result));
+		}));
+
+	return future;
+}
+
 EOnlineCachedResult::Type FOnlinePresenceEpic::GetCachedPresence(const FUniqueNetId& User, TSharedPtr<FOnlineUserPresence>& OutPresence)
 {
 	EOnlineCachedResult::Type result = EOnlineCachedResult::NotFound;
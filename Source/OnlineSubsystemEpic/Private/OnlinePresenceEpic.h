@@ -1,10 +1,17 @@
 #pragma once
 #pragma once
 
+#include "Async/Future.h"
 #include "Interfaces/OnlinePresenceInterface.h"
 #include "OnlineSubsystemEpic.h"
+#include "OnlineRequestCoalescerEpic.h"
+#include "OnlinePromiseTrackerEpic.h"
+#include "OnlineApiTypesEpic.h"
 #include "eos_sdk.h"
 
+struct FPresenceAdditionalData;
+class FUniqueNetIdEpic;
+
 class FOnlinePresenceEpic
 	: public IOnlinePresence
 {
@@ -15,11 +22,23 @@ private:
 
 	EOS_NotificationId OnPresenceChangedHandle;
 
+	/** The promises of the future based API that are still outstanding */
+	FOnlinePromiseTrackerEpic PendingPromises;
+
+	/** Joins overlapping presence queries for the same local and target user */
+	TOnlineRequestCoalescerEpic<TPair<EOS_EpicAccountId, EOS_EpicAccountId>, bool> QueryPresenceCoalescer;
+
 	static void EOS_QueryPresenceComplete(EOS_Presence_QueryPresenceCallbackInfo const* data);
 	static void EOS_OnPresenceChanged(EOS_Presence_PresenceChangedCallbackInfo const* data);
 	static void EOS_SetPresenceComplete(EOS_Presence_SetPresenceCallbackInfo const* data);
 	static void EOS_QueryExternalAccountMappingsForPresenceComplete(EOS_Connect_QueryExternalAccountMappingsCallbackInfo const* data);
 
+	/** Journals a presence update, to be sent once the user is back online */
+	void DeferSetPresence(FUniqueNetIdEpic const& User, FOnlineUserPresenceStatus const& Status);
+
+	/** Passes a presence query through the rate limiter. Used for first attempts and retries alike */
+	void IssueQueryPresence(FPresenceAdditionalData* AdditionalData, EOS_EpicAccountId LocalUserId, EOS_EpicAccountId TargetUserId);
+
 	EOnlinePresenceState::Type EOSPresenceStateToUEPresenceState(EOS_Presence_EStatus status) const;
 
 	EOS_Presence_EStatus UEPresenceStateToEOSPresenceState(EOnlinePresenceState::Type status) const;
@@ -35,6 +54,28 @@ public:
 	virtual EOnlineCachedResult::Type GetCachedPresence(const FUniqueNetId& User, TSharedPtr<FOnlineUserPresence>& OutPresence) override;
 
 	virtual EOnlineCachedResult::Type GetCachedPresenceForApp(const FUniqueNetId& LocalUserId, const FUniqueNetId& User, const FString& AppId, TSharedPtr<FOnlineUserPresence>& OutPresence) override;
+
+	// Future based API.
+	// The returned futures complete from within the EOS callback, so continuations attached with Then/Next
+	// run in the same tick as the completion and can immediately issue the next request.
+
+	/** Same as SetPresence, but returns a future instead of taking a delegate */
+	TFuture<FOnlinePresenceResultEpic> SetPresenceAsync(const FUniqueNetId& User, const FOnlineUserPresenceStatus& Status);
+
+	/** Same as QueryPresence, but returns a future instead of taking a delegate */
+	TFuture<FOnlinePresenceResultEpic> QueryPresenceAsync(const FUniqueNetId& User);
+
+	/** Fails the futures of the operations still running. Called by the subsystem on shutdown */
+	void FailPendingFutures()
+	{
+		this->PendingPromises.FailAll();
+	}
+
+	/** How many presence queries joined an in-flight query instead of calling the SDK */
+	FEpicCoalescerMetrics const& GetQueryPresenceCoalescerMetrics() const
+	{
+		return this->QueryPresenceCoalescer.GetMetrics();
+	}
 };
 
 typedef TSharedPtr<class FOnlinePresenceEpic, ESPMode::ThreadSafe> FOnlinePresenceEpicPtr;
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+/** The part of a tracked promise the tracker needs, independent of the result type */
+class FOnlineTrackedPromiseBaseEpic
+{
+public:
+	virtual ~FOnlineTrackedPromiseBaseEpic() = default;
+
+	/** Completes the promise with its failed result, unless it is completed already */
+	virtual void Fail() = 0;
+};
+
+/**
+ * A promise of the future based API.
+ * A plain TPromise asserts if it is destroyed without a value, which happens whenever the operation behind it
+ * never completes, e.g. because the interface is shut down. This promise completes with a failed result instead,
+ * either when it is destroyed or when its tracker fails it.
+ */
+template<typename ResultType>
+class TOnlineTrackedPromiseEpic
+	: public FOnlineTrackedPromiseBaseEpic
+{
+public:
+	explicit TOnlineTrackedPromiseEpic(ResultType&& InFailedResult)
+		: FailedResult(MoveTemp(InFailedResult))
+		, bIsSet(false)
+	{
+	}
+
+	virtual ~TOnlineTrackedPromiseEpic()
+	{
+		this->SetValue(MoveTemp(this->FailedResult));
+	}
+
+	TFuture<ResultType> GetFuture()
+	{
+		return this->Promise.GetFuture();
+	}
+
+	/** Completes the promise. Ignored if it is completed already, e.g. because it was failed on shutdown */
+	void SetValue(ResultType&& Result)
+	{
+		if (!this->bIsSet)
+		{
+			this->bIsSet = true;
+			this->Promise.SetValue(MoveTemp(Result));
+		}
+	}
+
+	virtual void Fail() override
+	{
+		this->SetValue(MoveTemp(this->FailedResult));
+	}
+
+	bool IsSet() const
+	{
+		return this->bIsSet;
+	}
+
+private:
+	TPromise<ResultType> Promise;
+	ResultType FailedResult;
+	bool bIsSet;
+};
+
+/**
+ * Keeps track of the promises an interface handed out, so the ones still outstanding can be failed on shutdown.
+ * The tracker is not thread safe, it is used from the game thread only.
+ */
+class FOnlinePromiseTrackerEpic
+{
+public:
+	FOnlinePromiseTrackerEpic()
+		: bIsShutDown(false)
+	{
+	}
+
+	/**
+	 * Makes a promise
+	 * @param FailedResult - The result the promise completes with if its operation never completes
+	 * @returns - The promise. After FailAll it is failed already
+	 */
+	template<typename ResultType>
+	TSharedRef<TOnlineTrackedPromiseEpic<ResultType>> Make(ResultType FailedResult)
+	{
+		TSharedRef<TOnlineTrackedPromiseEpic<ResultType>> promise = MakeShared<TOnlineTrackedPromiseEpic<ResultType>>(MoveTemp(FailedResult));
+		if (this->bIsShutDown)
+		{
+			promise->Fail();
+			return promise;
+		}
+
+		// Promises that are gone completed already, their entries are dropped here instead of on completion
+		this->Promises.RemoveAll([](TWeakPtr<FOnlineTrackedPromiseBaseEpic> const& Entry)
+			{
+				return !Entry.IsValid();
+			});
+		this->Promises.Add(promise);
+		return promise;
+	}
+
+	/** Fails every outstanding promise, in the order they were made. Promises made afterwards fail right away */
+	void FailAll()
+	{
+		this->bIsShutDown = true;
+
+		// Continuations run inside Fail and might make further promises
+		TArray<TWeakPtr<FOnlineTrackedPromiseBaseEpic>> promises = MoveTemp(this->Promises);
+		for (TWeakPtr<FOnlineTrackedPromiseBaseEpic> const& entry : promises)
+		{
+			if (TSharedPtr<FOnlineTrackedPromiseBaseEpic> promise = entry.Pin())
+			{
+				promise->Fail();
+			}
+		}
+	}
+
+private:
+	TArray<TWeakPtr<FOnlineTrackedPromiseBaseEpic>> Promises;
+	bool bIsShutDown;
+};
@@ -0,0 +1,221 @@
+#include "OnlineRateLimiterEpic.h"
+#include "OnlineSubsystem.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ConfigCacheIni.h"
+
+FOnlineRateLimiterEpic::FOnlineRateLimiterEpic()
+	: LastRefillTime(FPlatformTime::Seconds())
+	, TotalQueued(0)
+	, NextHoldToken(1)
+{
+	SetRate(this->Families[static_cast<int32>(EEpicOperation::Login)].Bucket, 5.f);
+	SetRate(this->Families[static_cast<int32>(EEpicOperation::Session)].Bucket, 10.f);
+	SetRate(this->Families[static_cast<int32>(EEpicOperation::UserInfo)].Bucket, 20.f);
+	SetRate(this->Families[static_cast<int32>(EEpicOperation::Presence)].Bucket, 10.f);
+	SetRate(this->GlobalBucket, 30.f);
+}
+
+void FOnlineRateLimiterEpic::LoadConfig()
+{
+	auto readRate = [](TCHAR const* Key, FBucket& Bucket)
+	{
+		float rate = Bucket.Rate;
+		if (GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), Key, rate, GEngineIni))
+		{
+			SetRate(Bucket, FMath::Max(0.f, rate));
+		}
+	};
+
+	readRate(TEXT("RateLimitLogin"), this->Families[static_cast<int32>(EEpicOperation::Login)].Bucket);
+	readRate(TEXT("RateLimitSession"), this->Families[static_cast<int32>(EEpicOperation::Session)].Bucket);
+	readRate(TEXT("RateLimitUserInfo"), this->Families[static_cast<int32>(EEpicOperation::UserInfo)].Bucket);
+	readRate(TEXT("RateLimitPresence"), this->Families[static_cast<int32>(EEpicOperation::Presence)].Bucket);
+	readRate(TEXT("RateLimitGlobal"), this->GlobalBucket);
+}
+
+void FOnlineRateLimiterEpic::Submit(EEpicOperation Operation, TUniqueFunction<void()>&& Request, TUniqueFunction<void()>&& Cancel)
+{
+	FFamily& family = this->Families[static_cast<int32>(Operation)];
+
+	// Send right away, unless something is already waiting.
+	// Waiting requests of the same or a higher priority must not be overtaken.
+	this->Refill();
+	double now = FPlatformTime::Seconds();
+	if (!IsHeld(family, now) && !this->HasSendableQueued(GetPriority(Operation), now) && family.Bucket.HasToken() && this->GlobalBucket.HasToken())
+	{
+		this->Dispatch(family, Request);
+		return;
+	}
+
+	family.Queue.Add(FQueuedRequest{ now, MoveTemp(Request), MoveTemp(Cancel) });
+	this->TotalQueued += 1;
+
+	family.Metrics.QueueDepth = family.Queue.Num();
+	family.Metrics.MaxQueueDepth = FMath::Max(family.Metrics.MaxQueueDepth, family.Metrics.QueueDepth);
+}
+
+void FOnlineRateLimiterEpic::Tick(float DeltaTime)
+{
+	if (this->TotalQueued == 0)
+	{
+		return;
+	}
+
+	this->Refill();
+
+	double now = FPlatformTime::Seconds();
+	while (this->TotalQueued > 0 && this->GlobalBucket.HasToken())
+	{
+		// Pick the sendable family with the highest priority.
+		// Between families of the same priority, the one that waited the longest goes first.
+		FFamily* next = nullptr;
+		int32 nextPriority = MAX_int32;
+		for (int32 i = 0; i < static_cast<int32>(EEpicOperation::Num); ++i)
+		{
+			FFamily& family = this->Families[i];
+			if (family.Queue.Num() == 0 || !family.Bucket.HasToken() || IsHeld(family, now))
+			{
+				continue;
+			}
+
+			int32 priority = GetPriority(static_cast<EEpicOperation>(i));
+			if (priority < nextPriority || (priority == nextPriority && family.Queue[0].QueueTime < next->Queue[0].QueueTime))
+			{
+				next = &family;
+				nextPriority = priority;
+			}
+		}
+
+		if (!next)
+		{
+			break;
+		}
+
+		FQueuedRequest queued = MoveTemp(next->Queue[0]);
+		next->Queue.RemoveAt(0, 1, false);
+		this->TotalQueued -= 1;
+
+		double waitTime = now - queued.QueueTime;
+		next->Metrics.QueueDepth = next->Queue.Num();
+		next->Metrics.Delayed += 1;
+		next->Metrics.TotalWaitTime += waitTime;
+		next->Metrics.MaxWaitTime = FMath::Max(next->Metrics.MaxWaitTime, waitTime);
+
+		this->Dispatch(*next, queued.Request);
+	}
+}
+
+void FOnlineRateLimiterEpic::Reset()
+{
+	for (FFamily& family : this->Families)
+	{
+		family.Holds.Empty();
+	}
+
+	// Cancelling a request runs its completion code, which might queue further requests. Those are cancelled as well.
+	while (this->TotalQueued > 0)
+	{
+		TArray<FQueuedRequest> dropped;
+		for (FFamily& family : this->Families)
+		{
+			dropped.Append(MoveTemp(family.Queue));
+			family.Queue.Empty();
+			family.Metrics.QueueDepth = 0;
+		}
+		this->TotalQueued = 0;
+
+		for (FQueuedRequest& queued : dropped)
+		{
+			queued.Cancel();
+		}
+	}
+}
+
+uint32 FOnlineRateLimiterEpic::Hold(EEpicOperation Operation, double MaxSeconds)
+{
+	uint32 holdToken = this->NextHoldToken++;
+	this->Families[static_cast<int32>(Operation)].Holds.Add(holdToken, FPlatformTime::Seconds() + MaxSeconds);
+	return holdToken;
+}
+
+void FOnlineRateLimiterEpic::Release(EEpicOperation Operation, uint32 HoldToken)
+{
+	// Holds that timed out were dropped already, their token is unknown by now and the holds placed since stay in place
+	this->Families[static_cast<int32>(Operation)].Holds.Remove(HoldToken);
+}
+
+bool FOnlineRateLimiterEpic::IsHeld(FFamily& Family, double Now)
+{
+	for (auto It = Family.Holds.CreateIterator(); It; ++It)
+	{
+		if (Now >= It.Value())
+		{
+			UE_LOG_ONLINE(Warning, TEXT("Hold on queued EOS requests timed out, sending them anyway"));
+			It.RemoveCurrent();
+		}
+	}
+	return Family.Holds.Num() > 0;
+}
+
+bool FOnlineRateLimiterEpic::HasSendableQueued(int32 Priority, double Now)
+{
+	if (this->TotalQueued == 0)
+	{
+		return false;
+	}
+
+	// Lower priorities and families out of tokens can't be sent before this request anyway
+	for (int32 i = 0; i < static_cast<int32>(EEpicOperation::Num); ++i)
+	{
+		FFamily& family = this->Families[i];
+		if (family.Queue.Num() > 0 && GetPriority(static_cast<EEpicOperation>(i)) <= Priority && family.Bucket.HasToken() && !IsHeld(family, Now))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 FOnlineRateLimiterEpic::GetPriority(EEpicOperation Operation)
+{
+	switch (Operation)
+	{
+	case EEpicOperation::Login:
+		return 0;
+	case EEpicOperation::Session:
+		return 1;
+	default:
+		// User info and presence share the lowest priority
+		return 2;
+	}
+}
+
+void FOnlineRateLimiterEpic::Refill()
+{
+	double now = FPlatformTime::Seconds();
+	double passed = now - this->LastRefillTime;
+	this->LastRefillTime = now;
+
+	for (FFamily& family : this->Families)
+	{
+		family.Bucket.Refill(passed);
+	}
+	this->GlobalBucket.Refill(passed);
+}
+
+void FOnlineRateLimiterEpic::Dispatch(FFamily& Family, TUniqueFunction<void()>& Request)
+{
+	Family.Bucket.Take();
+	this->GlobalBucket.Take();
+	Family.Metrics.Dispatched += 1;
+
+	Request();
+}
+
+void FOnlineRateLimiterEpic::SetRate(FBucket& Bucket, float Rate)
+{
+	// A bucket holds one second worth of requests, which is the largest burst it lets through
+	Bucket.Rate = Rate;
+	Bucket.Size = FMath::Max(1.f, Rate);
+	Bucket.Tokens = Bucket.Size;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSubsystemEpicTypes.h"
+
+/** Metrics of a single operation family */
+struct FEpicRateLimiterMetrics
+{
+	/** The number of requests currently waiting */
+	int32 QueueDepth = 0;
+
+	/** The highest number of requests that were waiting at the same time */
+	int32 MaxQueueDepth = 0;
+
+	/** The number of requests sent to the SDK */
+	uint64 Dispatched = 0;
+
+	/** The number of requests that had to wait before being sent */
+	uint64 Delayed = 0;
+
+	/** The accumulated time in seconds the delayed requests waited */
+	double TotalWaitTime = 0;
+
+	/** The longest time in seconds a request waited */
+	double MaxWaitTime = 0;
+
+	/** The average time in seconds a delayed request waited */
+	double GetAverageWaitTime() const
+	{
+		return this->Delayed > 0 ? this->TotalWaitTime / this->Delayed : 0;
+	}
+};
+
+/**
+ * Client side rate limiter in front of the EOS SDK calls.
+ * Every operation family has a token bucket, and all families share a global bucket.
+ * A request is sent right away when its family and the global bucket have a token and nothing is waiting,
+ * otherwise it is queued. Queued requests are sent from the subsystem tick, families with a higher priority first.
+ * The limiter is not thread safe, it is used from the game thread only.
+ */
+class FOnlineRateLimiterEpic
+{
+public:
+	FOnlineRateLimiterEpic();
+
+	/** Reads the rate limits from the OnlineSubsystemEpic section of the engine config */
+	void LoadConfig();
+
+	/**
+	 * Sends a request to the SDK now, or queues it until the rate limits allow it.
+	 * @param Operation - The family of the request
+	 * @param Request - Issues the SDK call
+	 * @param Cancel - Releases what the request owns and completes it as failed. Called instead of Request if the request is dropped by Reset
+	 */
+	void Submit(EEpicOperation Operation, TUniqueFunction<void()>&& Request, TUniqueFunction<void()>&& Cancel);
+
+	/** Sends queued requests as far as the rate limits allow */
+	void Tick(float DeltaTime);
+
+	/** Drops all queued requests without sending them. Their operations complete as failed */
+	void Reset();
+
+	/**
+	 * Holds back the requests of a family, they are queued until the family is released again.
+	 * Every hold is tracked on its own, the family is sent again once each hold was released or timed out.
+	 * @param Operation - The family to hold
+	 * @param MaxSeconds - The time after which the hold is dropped, even if it was never released
+	 * @returns - The token to release the hold with
+	 */
+	uint32 Hold(EEpicOperation Operation, double MaxSeconds);
+
+	/** Releases a hold placed with Hold(). Releasing a hold that timed out already does nothing */
+	void Release(EEpicOperation Operation, uint32 HoldToken);
+
+	/** Returns the metrics of an operation family */
+	FEpicRateLimiterMetrics const& GetMetrics(EEpicOperation Operation) const
+	{
+		return this->Families[static_cast<int32>(Operation)].Metrics;
+	}
+
+private:
+	struct FBucket
+	{
+		/** Tokens regained per second. 0 disables the limit */
+		float Rate = 0;
+
+		/** The maximum number of tokens */
+		float Size = 0;
+
+		/** The current number of tokens */
+		float Tokens = 0;
+
+		bool HasToken() const
+		{
+			return this->Rate <= 0 || this->Tokens >= 1.f;
+		}
+
+		void Take()
+		{
+			if (this->Rate > 0)
+			{
+				this->Tokens -= 1.f;
+			}
+		}
+
+		void Refill(double Seconds)
+		{
+			this->Tokens = FMath::Min(this->Size, this->Tokens + static_cast<float>(Seconds) * this->Rate);
+		}
+	};
+
+	struct FQueuedRequest
+	{
+		double QueueTime;
+		TUniqueFunction<void()> Request;
+		TUniqueFunction<void()> Cancel;
+	};
+
+	struct FFamily
+	{
+		FBucket Bucket;
+		TArray<FQueuedRequest> Queue;
+		FEpicRateLimiterMetrics Metrics;
+
+		/** The holds placed on the family, with the time each one runs out, even if it isn't released */
+		TMap<uint32, double> Holds;
+	};
+
+	/** Whether a family is held at the given time. Drops holds that have timed out */
+	static bool IsHeld(FFamily& Family, double Now);
+
+	/** Whether a family of the given or a higher priority has requests waiting that could be sent right now */
+	bool HasSendableQueued(int32 Priority, double Now);
+
+	/** The dispatch priority of a family, lower values are sent first */
+	static int32 GetPriority(EEpicOperation Operation);
+
+	/** Refills all buckets for the time passed since the last refill */
+	void Refill();
+
+	/** Sends a request and updates the metrics */
+	void Dispatch(FFamily& Family, TUniqueFunction<void()>& Request);
+
+	/** Sets the rate of a bucket and fills it up */
+	static void SetRate(FBucket& Bucket, float Rate);
+
+	FFamily Families[static_cast<int32>(EEpicOperation::Num)];
+
+	/** Shared by all families, limits the overall number of SDK calls */
+	FBucket GlobalBucket;
+
+	/** The time the buckets were last refilled */
+	double LastRefillTime;
+
+	/** The number of requests waiting in all families */
+	int32 TotalQueued;
+
+	/** The token of the next hold */
+	uint32 NextHoldToken;
+};
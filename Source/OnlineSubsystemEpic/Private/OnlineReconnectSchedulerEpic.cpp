@@ -0,0 +1,136 @@
+#include "OnlineReconnectSchedulerEpic.h"
+#include "OnlineSubsystem.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ConfigCacheIni.h"
+
+FOnlineReconnectSchedulerEpic::FOnlineReconnectSchedulerEpic()
+	: BaseDelay(5.f)
+	, MaxDelay(120.f)
+	, MaxAttempts(6)
+	, MaxInFlight(1)
+{
+}
+
+void FOnlineReconnectSchedulerEpic::LoadConfig()
+{
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("ReconnectBaseDelay"), this->BaseDelay, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("ReconnectMaxDelay"), this->MaxDelay, GEngineIni);
+	GConfig->GetInt(TEXT("OnlineSubsystemEpic"), TEXT("ReconnectMaxAttempts"), this->MaxAttempts, GEngineIni);
+	GConfig->GetInt(TEXT("OnlineSubsystemEpic"), TEXT("ReconnectMaxInFlight"), this->MaxInFlight, GEngineIni);
+
+	this->BaseDelay = FMath::Max(0.f, this->BaseDelay);
+	this->MaxDelay = FMath::Max(this->BaseDelay, this->MaxDelay);
+	this->MaxAttempts = FMath::Max(0, this->MaxAttempts);
+	this->MaxInFlight = FMath::Max(1, this->MaxInFlight);
+}
+
+void FOnlineReconnectSchedulerEpic::Schedule(int32 LocalUserNum, bool bPersistentAuth, TUniqueFunction<void()>&& Reconnect)
+{
+	if (this->MaxAttempts == 0)
+	{
+		return;
+	}
+
+	auto isUser = [LocalUserNum](FReconnect const& Entry) { return Entry.LocalUserNum == LocalUserNum; };
+	if (this->Pending.ContainsByPredicate(isUser) || this->InFlight.ContainsByPredicate(isUser))
+	{
+		return;
+	}
+
+	double delay = this->GetDelay(1);
+	UE_LOG_ONLINE(Display, TEXT("Local user %d lost their login, reconnecting in %.2fs"), LocalUserNum, delay);
+
+	this->Pending.Add(FReconnect{ LocalUserNum, bPersistentAuth, 1, FPlatformTime::Seconds() + delay, MakeShared<TUniqueFunction<void()>>(MoveTemp(Reconnect)) });
+}
+
+void FOnlineReconnectSchedulerEpic::Finished(int32 LocalUserNum, bool bWasSuccessful)
+{
+	int32 index = this->InFlight.IndexOfByPredicate([LocalUserNum](FReconnect const& Entry) { return Entry.LocalUserNum == LocalUserNum; });
+	if (index == INDEX_NONE)
+	{
+		// Cancelled while it was running
+		return;
+	}
+
+	FReconnect reconnect = MoveTemp(this->InFlight[index]);
+	this->InFlight.RemoveAtSwap(index);
+
+	if (bWasSuccessful)
+	{
+		UE_LOG_ONLINE(Display, TEXT("Reconnected local user %d"), LocalUserNum);
+		return;
+	}
+
+	if (reconnect.Attempt >= this->MaxAttempts)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("Giving up reconnecting local user %d after %d attempts"), LocalUserNum, reconnect.Attempt);
+		return;
+	}
+
+	reconnect.Attempt += 1;
+	double delay = this->GetDelay(reconnect.Attempt);
+	UE_LOG_ONLINE(Display, TEXT("Reconnecting local user %d failed, trying again in %.2fs"), LocalUserNum, delay);
+
+	reconnect.DueTime = FPlatformTime::Seconds() + delay;
+	this->Pending.Add(MoveTemp(reconnect));
+}
+
+void FOnlineReconnectSchedulerEpic::Cancel(int32 LocalUserNum)
+{
+	auto isUser = [LocalUserNum](FReconnect const& Entry) { return Entry.LocalUserNum == LocalUserNum; };
+	this->Pending.RemoveAll(isUser);
+	this->InFlight.RemoveAll(isUser);
+}
+
+void FOnlineReconnectSchedulerEpic::Tick(float DeltaTime)
+{
+	double now = FPlatformTime::Seconds();
+	while (this->Pending.Num() > 0 && this->InFlight.Num() < this->MaxInFlight)
+	{
+		// Persistent auth first, as it doesn't depend on the user. Otherwise the one that is due the longest.
+		int32 next = INDEX_NONE;
+		for (int32 i = 0; i < this->Pending.Num(); ++i)
+		{
+			FReconnect const& entry = this->Pending[i];
+			if (entry.DueTime > now)
+			{
+				continue;
+			}
+
+			if (next == INDEX_NONE
+				|| (entry.bPersistentAuth && !this->Pending[next].bPersistentAuth)
+				|| (entry.bPersistentAuth == this->Pending[next].bPersistentAuth && entry.DueTime < this->Pending[next].DueTime))
+			{
+				next = i;
+			}
+		}
+
+		if (next == INDEX_NONE)
+		{
+			break;
+		}
+
+		this->InFlight.Add(MoveTemp(this->Pending[next]));
+		this->Pending.RemoveAtSwap(next);
+
+		FReconnect const& started = this->InFlight.Last();
+		UE_LOG_ONLINE(Verbose, TEXT("Starting reconnect of local user %d (attempt %d)"), started.LocalUserNum, started.Attempt);
+
+		// Starting the login might finish or cancel it right away, so don't call through the array
+		TSharedRef<TUniqueFunction<void()>> reconnect = started.Reconnect;
+		(*reconnect)();
+	}
+}
+
+void FOnlineReconnectSchedulerEpic::Reset()
+{
+	this->Pending.Empty();
+	this->InFlight.Empty();
+}
+
+double FOnlineReconnectSchedulerEpic::GetDelay(int32 Attempt) const
+{
+	// Full jitter, every client picks a point anywhere in the window
+	double window = FMath::Min<double>(this->MaxDelay, this->BaseDelay * FMath::Pow(2.f, static_cast<float>(Attempt - 1)));
+	return window * FMath::FRand();
+}
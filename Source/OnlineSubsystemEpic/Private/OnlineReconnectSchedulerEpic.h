@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Spreads the re-logins of users that lost their connection.
+ * After a backend outage every client loses its login at about the same time. Logging everyone in again right away
+ * would hit the recovering backend with a spike of logins, most of them getting rejected again.
+ * Instead every reconnect waits for a random delay, and only a limited number of reconnects run at the same time.
+ * Reconnects that don't need any user input (persistent auth) are started before the others.
+ * The scheduler is not thread safe, it is used from the game thread only.
+ */
+class FOnlineReconnectSchedulerEpic
+{
+public:
+	FOnlineReconnectSchedulerEpic();
+
+	/** Reads the reconnect settings from the OnlineSubsystemEpic section of the engine config */
+	void LoadConfig();
+
+	/**
+	 * Schedules the reconnect of a local user. Does nothing if the user already has a reconnect scheduled or running.
+	 * @param LocalUserNum - The user to reconnect
+	 * @param bPersistentAuth - Whether the reconnect works without user input, these are started first
+	 * @param Reconnect - Starts the re-login. Must be followed by a call to Finished once the login is done
+	 */
+	void Schedule(int32 LocalUserNum, bool bPersistentAuth, TUniqueFunction<void()>&& Reconnect);
+
+	/**
+	 * Reports the outcome of a reconnect. Failed reconnects are scheduled again with a longer delay,
+	 * until the maximum number of attempts is reached.
+	 */
+	void Finished(int32 LocalUserNum, bool bWasSuccessful);
+
+	/** Drops the scheduled reconnect of a user, e.g. because the game logs them in itself */
+	void Cancel(int32 LocalUserNum);
+
+	/** Starts the reconnects that are due, as far as the in-flight limit allows */
+	void Tick(float DeltaTime);
+
+	/** Drops all scheduled reconnects without starting them */
+	void Reset();
+
+private:
+	struct FReconnect
+	{
+		int32 LocalUserNum;
+		bool bPersistentAuth;
+		int32 Attempt;
+		double DueTime;
+
+		// Shared, so the function survives being called while its entry moves between the lists
+		TSharedRef<TUniqueFunction<void()>> Reconnect;
+	};
+
+	/** A random delay for the given attempt. The upper bound doubles with every attempt, up to the max delay */
+	double GetDelay(int32 Attempt) const;
+
+	/** The upper bound in seconds for the delay of the first attempt */
+	float BaseDelay;
+
+	/** The upper bound in seconds for the delay of any attempt */
+	float MaxDelay;
+
+	/** The number of attempts after which a user is not reconnected anymore */
+	int32 MaxAttempts;
+
+	/** The number of reconnects that may run at the same time. 1 reconnects one user after the other */
+	int32 MaxInFlight;
+
+	/** Reconnects waiting for their delay to pass or for a free slot */
+	TArray<FReconnect> Pending;
+
+	/** Reconnects that were started and didn't finish yet */
+	TArray<FReconnect> InFlight;
+};
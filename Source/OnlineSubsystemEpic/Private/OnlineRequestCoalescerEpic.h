@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Counters of a request coalescer */
+struct FEpicCoalescerMetrics
+{
+	/** The number of requests made, including the ones that joined an in-flight request */
+	uint64 Requests = 0;
+
+	/** The number of requests that joined an in-flight request instead of being sent */
+	uint64 Hits = 0;
+
+	/** The fraction of requests that didn't need an SDK call of their own */
+	double GetHitRate() const
+	{
+		return this->Requests > 0 ? static_cast<double>(this->Hits) / this->Requests : 0;
+	}
+};
+
+/**
+ * Joins identical requests that overlap in time.
+ * The first request for a key is sent to the SDK. Every further request for the same key
+ * made while the first one is in flight only registers its completion, and gets the same result.
+ * The coalescer is not thread safe, it is used from the game thread only.
+ * @param KeyType - Identifies a request, usually the operation's arguments. Needs GetTypeHash and operator==
+ * @param ResultType - The result passed to every completion
+ */
+template<typename KeyType, typename ResultType>
+class TOnlineRequestCoalescerEpic
+{
+public:
+	using FCompletion = TUniqueFunction<void(ResultType const&)>;
+
+	/**
+	 * Registers the completion of a request.
+	 * @param Key - The key of the request
+	 * @param Completion - Called with the result, once the request for the key is done
+	 * @returns - True if the caller has to send the request, false if it joined one already in flight
+	 */
+	bool Join(KeyType const& Key, FCompletion&& Completion)
+	{
+		this->Metrics.Requests += 1;
+
+		TArray<FCompletion>* waiting = this->InFlight.Find(Key);
+		if (waiting)
+		{
+			this->Metrics.Hits += 1;
+			waiting->Add(MoveTemp(Completion));
+			return false;
+		}
+
+		this->InFlight.Add(Key).Add(MoveTemp(Completion));
+		return true;
+	}
+
+	/** Finishes the request for a key and passes the result to every completion that joined it */
+	void Complete(KeyType const& Key, ResultType const& Result)
+	{
+		TArray<FCompletion>* waiting = this->InFlight.Find(Key);
+		if (!waiting)
+		{
+			return;
+		}
+
+		// Remove the entry before calling out, a completion might start a new request for the same key
+		TArray<FCompletion> completions = MoveTemp(*waiting);
+		this->InFlight.Remove(Key);
+
+		for (FCompletion& completion : completions)
+		{
+			completion(Result);
+		}
+	}
+
+	/**
+	 * Drops all in-flight requests, passing a failed result to every completion that joined them.
+	 * @param FailedResult - The result the completions get, e.g. false or an error code
+	 */
+	void Reset(ResultType const& FailedResult)
+	{
+		// Move the entries out before calling out, a completion might start a new request
+		TMap<KeyType, TArray<FCompletion>> inFlight = MoveTemp(this->InFlight);
+		this->InFlight.Empty();
+
+		for (TPair<KeyType, TArray<FCompletion>>& request : inFlight)
+		{
+			for (FCompletion& completion : request.Value)
+			{
+				completion(FailedResult);
+			}
+		}
+	}
+
+	FEpicCoalescerMetrics const& GetMetrics() const
+	{
+		return this->Metrics;
+	}
+
+private:
+	/** The completions waiting for each in-flight request */
+	TMap<KeyType, TArray<FCompletion>> InFlight;
+
+	FEpicCoalescerMetrics Metrics;
+};
@@ -0,0 +1,131 @@
+#include "OnlineRetryPolicyEpic.h"
+#include "OnlineSubsystem.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ConfigCacheIni.h"
+
+FOnlineRetryPolicyEpic::FOnlineRetryPolicyEpic()
+	: MaxAttempts(3)
+	, BaseDelay(0.5f)
+	, MaxDelay(8.f)
+	, Jitter(0.5f)
+	, BudgetSize(10.f)
+	, BudgetRefillRate(0.5f)
+	, LastRefillTime(FPlatformTime::Seconds())
+{
+	for (float& budget : this->Budgets)
+	{
+		budget = this->BudgetSize;
+	}
+}
+
+void FOnlineRetryPolicyEpic::LoadConfig()
+{
+	GConfig->GetInt(TEXT("OnlineSubsystemEpic"), TEXT("RetryMaxAttempts"), this->MaxAttempts, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("RetryBaseDelay"), this->BaseDelay, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("RetryMaxDelay"), this->MaxDelay, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("RetryJitter"), this->Jitter, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("RetryBudget"), this->BudgetSize, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("RetryBudgetRefillRate"), this->BudgetRefillRate, GEngineIni);
+
+	// Clamp everything into a sane range, the config is user input after all
+	this->MaxAttempts = FMath::Max(1, this->MaxAttempts);
+	this->BaseDelay = FMath::Max(0.f, this->BaseDelay);
+	this->MaxDelay = FMath::Max(this->BaseDelay, this->MaxDelay);
+	this->Jitter = FMath::Clamp(this->Jitter, 0.f, 1.f);
+	this->BudgetSize = FMath::Max(0.f, this->BudgetSize);
+	this->BudgetRefillRate = FMath::Max(0.f, this->BudgetRefillRate);
+
+	for (float& budget : this->Budgets)
+	{
+		budget = this->BudgetSize;
+	}
+}
+
+bool FOnlineRetryPolicyEpic::IsRetryable(EOS_EResult Result)
+{
+	switch (Result)
+	{
+	case EOS_EResult::EOS_TimedOut:
+	case EOS_EResult::EOS_TooManyRequests:
+	case EOS_EResult::EOS_ServiceFailure:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool FOnlineRetryPolicyEpic::ScheduleRetry(EEpicOperation Operation, EOS_EResult Result, int32 Attempt, TUniqueFunction<void()>&& Retry, TUniqueFunction<void()>&& Fail)
+{
+	if (!IsRetryable(Result) || Attempt >= this->MaxAttempts)
+	{
+		return false;
+	}
+
+	// Refill the budgets for the time that passed since the last retry
+	double now = FPlatformTime::Seconds();
+	float refill = static_cast<float>(now - this->LastRefillTime) * this->BudgetRefillRate;
+	for (float& budget : this->Budgets)
+	{
+		budget = FMath::Min(this->BudgetSize, budget + refill);
+	}
+	this->LastRefillTime = now;
+
+	float& budget = this->Budgets[static_cast<int32>(Operation)];
+	if (budget < 1.f)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("Retry budget exhausted, not retrying operation that failed with %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Result)));
+		return false;
+	}
+	budget -= 1.f;
+
+	double delay = this->GetBackoffDelay(Attempt);
+	UE_LOG_ONLINE(Verbose, TEXT("Operation failed with %s, retrying in %.2fs (attempt %d of %d)"), UTF8_TO_TCHAR(EOS_EResult_ToString(Result)), delay, Attempt + 1, this->MaxAttempts);
+
+	this->PendingRetries.Add(FPendingRetry{ now + delay, MoveTemp(Retry), MoveTemp(Fail) });
+	return true;
+}
+
+void FOnlineRetryPolicyEpic::Tick(float DeltaTime)
+{
+	if (this->PendingRetries.Num() == 0)
+	{
+		return;
+	}
+
+	// Move the due retries out first, as reissuing an operation might schedule further retries
+	double now = FPlatformTime::Seconds();
+	TArray<FPendingRetry> dueRetries;
+	for (int32 i = this->PendingRetries.Num() - 1; i >= 0; --i)
+	{
+		if (this->PendingRetries[i].DueTime <= now)
+		{
+			dueRetries.Add(MoveTemp(this->PendingRetries[i]));
+			this->PendingRetries.RemoveAtSwap(i, 1, false);
+		}
+	}
+
+	for (FPendingRetry& retry : dueRetries)
+	{
+		retry.Retry();
+	}
+}
+
+void FOnlineRetryPolicyEpic::Reset()
+{
+	// Move the retries out first, failing an operation runs its completion code, which might ask for another retry
+	TArray<FPendingRetry> droppedRetries = MoveTemp(this->PendingRetries);
+	this->PendingRetries.Empty();
+	for (FPendingRetry& retry : droppedRetries)
+	{
+		retry.Fail();
+	}
+}
+
+double FOnlineRetryPolicyEpic::GetBackoffDelay(int32 Attempt) const
+{
+	// Exponential backoff, capped at the max delay
+	double delay = FMath::Min<double>(this->MaxDelay, this->BaseDelay * FMath::Pow(2.f, static_cast<float>(Attempt - 1)));
+
+	// Randomize part of the delay, so clients that failed together don't retry together
+	return delay * (1.0 - this->Jitter * FMath::FRand());
+}
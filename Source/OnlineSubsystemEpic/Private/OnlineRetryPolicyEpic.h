@@ -0,0 +1,81 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSubsystemEpicTypes.h"
+#include "eos_sdk.h"
+
+/**
+ * Central retry policy for the EOS async operations.
+ * Callbacks that fail ask the policy whether the failure is final. Transient failures are
+ * rescheduled with exponential backoff and jitter, and reissued from the subsystem tick.
+ * Every retry costs one token from the budget of its operation family. The budgets refill over time,
+ * so a backend outage turns into final failures instead of a retry storm.
+ * The policy is not thread safe, it is used from the game thread only.
+ */
+class FOnlineRetryPolicyEpic
+{
+public:
+	FOnlineRetryPolicyEpic();
+
+	/** Reads the retry settings from the OnlineSubsystemEpic section of the engine config */
+	void LoadConfig();
+
+	/** Whether a result code describes a transient failure, that might succeed if the operation is reissued */
+	static bool IsRetryable(EOS_EResult Result);
+
+	/**
+	 * Schedules a retry for a failed operation, if the result is retryable
+	 * and neither the attempt limit nor the family's budget are exhausted.
+	 * @param Operation - The family of the failed operation
+	 * @param Result - The result the operation failed with
+	 * @param Attempt - The number of attempts made so far, starting at 1
+	 * @param Retry - Reissues the operation. Called from Tick once the backoff delay has passed
+	 * @param Fail - Completes the operation as failed and releases what it owns. Called instead of Retry if the retry is dropped by Reset
+	 * @returns - True if the retry was scheduled, false if the failure is final
+	 */
+	bool ScheduleRetry(EEpicOperation Operation, EOS_EResult Result, int32 Attempt, TUniqueFunction<void()>&& Retry, TUniqueFunction<void()>&& Fail);
+
+	/** Reissues all operations whose backoff delay has passed */
+	void Tick(float DeltaTime);
+
+	/** Drops all pending retries without reissuing them. Their operations complete as failed */
+	void Reset();
+
+private:
+	struct FPendingRetry
+	{
+		double DueTime;
+		TUniqueFunction<void()> Retry;
+		TUniqueFunction<void()> Fail;
+	};
+
+	/** The delay before reissuing an operation for the given attempt, including jitter */
+	double GetBackoffDelay(int32 Attempt) const;
+
+	/** The maximum number of attempts, including the first one */
+	int32 MaxAttempts;
+
+	/** The delay in seconds before the first retry. Doubled for every further retry */
+	float BaseDelay;
+
+	/** The upper bound in seconds for the delay between two attempts */
+	float MaxDelay;
+
+	/** The fraction of the delay that is randomized. 0 disables jitter, 1 is full jitter */
+	float Jitter;
+
+	/** The number of retries a family can do in a burst */
+	float BudgetSize;
+
+	/** The number of retries a family regains per second */
+	float BudgetRefillRate;
+
+	/** The current budget of every family */
+	float Budgets[static_cast<int32>(EEpicOperation::Num)];
+
+	/** The time the budgets were last refilled */
+	double LastRefillTime;
+
+	/** All retries waiting for their backoff delay to pass */
+	TArray<FPendingRetry> PendingRetries;
+};
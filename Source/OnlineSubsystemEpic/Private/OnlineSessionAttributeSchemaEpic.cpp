@@ -0,0 +1,279 @@
+#include "OnlineSessionAttributeSchemaEpic.h"
+#include "OnlineSubsystem.h"
+#include "Misc/Base64.h"
+
+char const* FOnlineSessionAttributeArenaEpic::Store(FString const& String)
+{
+	FTCHARToUTF8 utf8(*String);
+	return this->Store(utf8.Get(), utf8.Length());
+}
+
+char const* FOnlineSessionAttributeArenaEpic::Store(char const* Utf8, int32 Length)
+{
+	char* dest = nullptr;
+	if (this->InlineUsed + Length + 1 <= InlineSize)
+	{
+		dest = this->Inline + this->InlineUsed;
+		this->InlineUsed += Length + 1;
+	}
+	else
+	{
+		TArray<char>& block = this->Overflow.AddDefaulted_GetRef();
+		block.SetNumUninitialized(Length + 1);
+		dest = block.GetData();
+	}
+
+	FMemory::Memcpy(dest, Utf8, Length);
+	dest[Length] = '\0';
+	return dest;
+}
+
+void FOnlineSessionAttributeArenaEpic::Reset()
+{
+	this->InlineUsed = 0;
+	this->Overflow.Reset();
+}
+
+FOnlineSessionAttributeSchemaEpic::FOnlineSessionAttributeSchemaEpic()
+{
+	// The settings of FOnlineSessionSettings that are sent as attributes
+	this->RegisterAttribute(TEXT("NumPublicConnections"), EOnlineKeyValuePairDataType::Int32);
+	this->RegisterAttribute(TEXT("NumPrivateConnections"), EOnlineKeyValuePairDataType::Int32);
+	this->RegisterAttribute(TEXT("bUsesPresence"), EOnlineKeyValuePairDataType::Bool);
+	this->RegisterAttribute(TEXT("bIsLANMatch"), EOnlineKeyValuePairDataType::Bool);
+	this->RegisterAttribute(TEXT("bIsDedicated"), EOnlineKeyValuePairDataType::Bool);
+	this->RegisterAttribute(TEXT("bUsesStats"), EOnlineKeyValuePairDataType::Bool);
+	this->RegisterAttribute(TEXT("bAllowInvites"), EOnlineKeyValuePairDataType::Bool);
+	this->RegisterAttribute(TEXT("bAntiCheatProtected"), EOnlineKeyValuePairDataType::Bool);
+	this->RegisterAttribute(TEXT("BuildUniqueId"), EOnlineKeyValuePairDataType::Int32);
+}
+
+void FOnlineSessionAttributeSchemaEpic::RegisterAttribute(FName Name, EOnlineKeyValuePairDataType::Type DataType)
+{
+	EOS_ESessionAttributeType attributeType;
+	if (!ToAttributeType(DataType, attributeType))
+	{
+		UE_LOG_ONLINE_SESSION(Warning, TEXT("Can't register session attribute \"%s\", data of type \"%s\" is not supported."), *Name.ToString(), EOnlineKeyValuePairDataType::ToString(DataType));
+		return;
+	}
+
+	FTCHARToUTF8 utf8(*Name.ToString());
+	FAttribute& attribute = this->Attributes.FindOrAdd(Name);
+	attribute.Utf8Name = TArray<char>(utf8.Get(), utf8.Length() + 1);
+	attribute.AttributeType = attributeType;
+	attribute.DataType = DataType;
+}
+
+bool FOnlineSessionAttributeSchemaEpic::ToAttributeType(EOnlineKeyValuePairDataType::Type DataType, EOS_ESessionAttributeType& OutAttributeType)
+{
+	switch (DataType)
+	{
+	case EOnlineKeyValuePairDataType::Bool:
+		OutAttributeType = EOS_ESessionAttributeType::EOS_AT_BOOLEAN;
+		return true;
+	case EOnlineKeyValuePairDataType::Int32:
+	case EOnlineKeyValuePairDataType::UInt32:
+	case EOnlineKeyValuePairDataType::Int64:
+		OutAttributeType = EOS_ESessionAttributeType::EOS_AT_INT64;
+		return true;
+	case EOnlineKeyValuePairDataType::Float:
+	case EOnlineKeyValuePairDataType::Double:
+		OutAttributeType = EOS_ESessionAttributeType::EOS_AT_DOUBLE;
+		return true;
+	case EOnlineKeyValuePairDataType::String:
+	case EOnlineKeyValuePairDataType::UInt64:
+	case EOnlineKeyValuePairDataType::Json:
+	case EOnlineKeyValuePairDataType::Blob:
+		OutAttributeType = EOS_ESessionAttributeType::EOS_AT_STRING;
+		return true;
+	default:
+		return false;
+	}
+}
+
+char const* FOnlineSessionAttributeSchemaEpic::GetUtf8Name(FName Name, FOnlineSessionAttributeArenaEpic& Arena) const
+{
+	if (FAttribute const* attribute = this->Attributes.Find(Name))
+	{
+		return attribute->Utf8Name.GetData();
+	}
+	return Arena.Store(Name.ToString());
+}
+
+bool FOnlineSessionAttributeSchemaEpic::Marshal(FName Name, FVariantData const& Data, FOnlineSessionAttributeArenaEpic& Arena, EOS_Sessions_AttributeData& OutAttribute, FString& Error) const
+{
+	EOS_ESessionAttributeType attributeType;
+	if (!ToAttributeType(Data.GetType(), attributeType))
+	{
+		Error = FString::Printf(TEXT("Data of type \"%s\" not supported."), EOnlineKeyValuePairDataType::ToString(Data.GetType()));
+		return false;
+	}
+
+	FAttribute const* attribute = this->Attributes.Find(Name);
+	// Compare the data types, not the SDK types. Several data types share an SDK type but can't be read back as each other
+	if (attribute && attribute->DataType != Data.GetType())
+	{
+		Error = FString::Printf(TEXT("Type mismatch for session setting attribute, data of type \"%s\" doesn't match the registered type \"%s\"."),
+			EOnlineKeyValuePairDataType::ToString(Data.GetType()), EOnlineKeyValuePairDataType::ToString(attribute->DataType));
+		return false;
+	}
+
+	OutAttribute.ApiVersion = EOS_SESSIONS_SESSIONATTRIBUTEDATA_API_LATEST;
+	OutAttribute.Key = attribute ? attribute->Utf8Name.GetData() : Arena.Store(Name.ToString());
+	OutAttribute.ValueType = attributeType;
+
+	switch (Data.GetType())
+	{
+	case EOnlineKeyValuePairDataType::Bool:
+	{
+		bool value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsBool = value ? EOS_TRUE : EOS_FALSE;
+		break;
+	}
+	case EOnlineKeyValuePairDataType::Int32:
+	{
+		int32 value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsInt64 = value;
+		break;
+	}
+	case EOnlineKeyValuePairDataType::UInt32:
+	{
+		uint32 value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsInt64 = value;
+		break;
+	}
+	case EOnlineKeyValuePairDataType::Int64:
+	{
+		int64 value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsInt64 = value;
+		break;
+	}
+	case EOnlineKeyValuePairDataType::UInt64:
+	{
+		uint64 value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsUtf8 = Arena.Store(FString::Printf(TEXT("%llu"), value));
+		break;
+	}
+	case EOnlineKeyValuePairDataType::Float:
+	{
+		float value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsDouble = value;
+		break;
+	}
+	case EOnlineKeyValuePairDataType::Double:
+	{
+		double value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsDouble = value;
+		break;
+	}
+	case EOnlineKeyValuePairDataType::String:
+	{
+		FString value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsUtf8 = Arena.Store(value);
+		break;
+	}
+	case EOnlineKeyValuePairDataType::Json:
+	{
+		OutAttribute.Value.AsUtf8 = Arena.Store(Data.ToString());
+		break;
+	}
+	case EOnlineKeyValuePairDataType::Blob:
+	{
+		TArray<uint8> value;
+		Data.GetValue(value);
+		OutAttribute.Value.AsUtf8 = Arena.Store(FBase64::Encode(value));
+		break;
+	}
+	default:
+		checkNoEntry();
+		return false;
+	}
+	return true;
+}
+
+bool FOnlineSessionAttributeSchemaEpic::Unmarshal(EOS_Sessions_AttributeData const& Attribute, FName& OutName, FVariantData& OutData) const
+{
+	OutName = FName(UTF8_TO_TCHAR(Attribute.Key));
+
+	FAttribute const* attribute = this->Attributes.Find(OutName);
+	if (attribute && attribute->AttributeType != Attribute.ValueType)
+	{
+		UE_LOG_ONLINE_SESSION(Warning, TEXT("Session attribute \"%s\" doesn't have the registered type, it is ignored."), *OutName.ToString());
+		return false;
+	}
+
+	switch (Attribute.ValueType)
+	{
+	case EOS_ESessionAttributeType::EOS_AT_BOOLEAN:
+		OutData.SetValue(Attribute.Value.AsBool == EOS_TRUE);
+		return true;
+	case EOS_ESessionAttributeType::EOS_AT_INT64:
+	{
+		int64 value = Attribute.Value.AsInt64;
+		switch (attribute ? attribute->DataType : EOnlineKeyValuePairDataType::Int64)
+		{
+		case EOnlineKeyValuePairDataType::Int32:
+			OutData.SetValue(static_cast<int32>(value));
+			break;
+		case EOnlineKeyValuePairDataType::UInt32:
+			OutData.SetValue(static_cast<uint32>(value));
+			break;
+		default:
+			OutData.SetValue(value);
+			break;
+		}
+		return true;
+	}
+	case EOS_ESessionAttributeType::EOS_AT_DOUBLE:
+	{
+		double value = Attribute.Value.AsDouble;
+		if (attribute && attribute->DataType == EOnlineKeyValuePairDataType::Float)
+		{
+			OutData.SetValue(static_cast<float>(value));
+		}
+		else
+		{
+			OutData.SetValue(value);
+		}
+		return true;
+	}
+	case EOS_ESessionAttributeType::EOS_AT_STRING:
+	{
+		FString value = UTF8_TO_TCHAR(Attribute.Value.AsUtf8);
+		switch (attribute ? attribute->DataType : EOnlineKeyValuePairDataType::String)
+		{
+		case EOnlineKeyValuePairDataType::UInt64:
+			OutData.SetValue(FCString::Strtoui64(*value, nullptr, 10));
+			break;
+		case EOnlineKeyValuePairDataType::Json:
+			OutData.SetJsonValueFromString(value);
+			break;
+		case EOnlineKeyValuePairDataType::Blob:
+		{
+			TArray<uint8> blob;
+			if (!FBase64::Decode(value, blob))
+			{
+				UE_LOG_ONLINE_SESSION(Warning, TEXT("Session attribute \"%s\" is not valid base64, it is ignored."), *OutName.ToString());
+				return false;
+			}
+			OutData.SetValue(blob);
+			break;
+		}
+		default:
+			OutData.SetValue(value);
+			break;
+		}
+		return true;
+	}
+	default:
+		return false;
+	}
+}
@@ -8,6 +8,13 @@
 #include "Utilities.h"
 #include "eos_auth.h"
 #include "OnlineSubsystemEpic.h"
+#include "OnlineRetryPolicyEpic.h"
+#include "OnlineRateLimiterEpic.h"
+#include "OnlineWriteJournalEpic.h"
+#include "OnlineSessionAttributeSchemaEpic.h"
+#include "OnlineSessionPingerEpic.h"
+#include "OnlineSessionSearchFilterEpic.h"
+#include "Misc/ConfigCacheIni.h"
 #include "Interfaces/VoiceInterface.h"
 
 // ---------------------------------------------
@@ -37,6 +44,7 @@ typedef struct FSessionStateChangeAdditionalData
 {
 	FOnlineSessionEpic* OnlineSessionPtr;
 	FName SessionName;
+	int32 Attempt = 1;
 } FSessionStateChangeAdditionalData;
 
 /**
@@ -47,6 +55,8 @@ typedef struct FUpdateSessionAdditionalData
 {
 	FOnlineSessionEpic* OnlineSessionPtr;
 	FOnlineSessionSettings OldSessionSettings;
+	FOnlineSessionSettings SentSessionSettings;
+	uint32 Batch;
 } FUpdateSessionAdditionalData;
 
 /**
@@ -55,19 +65,22 @@ typedef struct FUpdateSessionAdditionalData
  */
 typedef struct FFindSessionsAdditionalData {
 	FOnlineSessionEpic* OnlineSessionPtr;
-	double SearchStartTime;
+	uint32 SearchId;
+	EOS_ProductUserId LocalUserId;
+	int32 Attempt = 1;
 } FFindSessionsAdditionalData;
 
 typedef struct FJoinSessionAdditionalData
 {
 	FOnlineSessionEpic* OnlineSessionPtr;
 	FName SessionName;
+	int32 Attempt = 1;
 } FJoinSessionAdditionalData;
 
 typedef struct FFindFriendSessionAdditionalData
 {
 	FOnlineSessionEpic* OnlineSessionPtr;
-	double SearchCreationTime;
+	uint32 SearchId;
 	FUniqueNetId const& SearchingUserId;
 } FFindFriendSessionAdditionalData;
 
@@ -82,6 +95,7 @@ typedef struct FCreateSessionAdditionalData
 {
 	FOnlineSessionEpic* OnlineSessionPtr;
 	TSharedRef<FUniqueNetId const> CreatingUserId;
+	FOnlineSessionSettings SentSessionSettings;
 } FCreateSessionAdditionalData;
 
 
@@ -130,95 +144,6 @@ void FOnlineSessionEpic::SetSessionDetails(FOnlineSession* session, EOS_SessionD
 	//	session->SessionSettings.BuildUniqueId = this->Subsystem->GetBuildUniqueId();
 }
 
-/**
- * Creates EOS Attribute data from UE4s variant data
- * @param attributeName - The name for the data.
- * @param variantData - The variable data itself
- * @outAttributeData - The EOS AttributeData populated with the variant data
- * @error - The error message if the creation was unsuccessful
- * @returns - True if the creation was successful, false otherwise
-*/
-EOS_Sessions_AttributeData FOnlineSessionEpic::CreateEOSAttributeData(FString const attributeName, FVariantData const variantData, FString& error)
-{
-	EOS_Sessions_AttributeData outAttributeData;
-	outAttributeData.ApiVersion = EOS_SESSIONS_SESSIONATTRIBUTEDATA_API_LATEST;
-	outAttributeData.Key = TCHAR_TO_UTF8(*attributeName);
-
-	bool success = false;
-	if (variantData.GetType() == EOnlineKeyValuePairDataType::Json
-		|| variantData.GetType() == EOnlineKeyValuePairDataType::UInt32
-		|| variantData.GetType() == EOnlineKeyValuePairDataType::UInt64
-		|| variantData.GetType() == EOnlineKeyValuePairDataType::Blob)
-	{
-		error = FString::Printf(TEXT("Data of type \"%s\" not supported."), EOnlineKeyValuePairDataType::ToString(variantData.GetType()));
-		success = false;
-	}
-	else if (variantData.GetType() == EOnlineKeyValuePairDataType::Empty)
-	{
-		// Ignore the data
-		success = true;
-	}
-	else if (variantData.GetType() == EOnlineKeyValuePairDataType::Bool)
-	{
-		bool data;
-		variantData.GetValue(data);
-		outAttributeData.Value.AsBool = data;
-		outAttributeData.ValueType = EOS_ESessionAttributeType::EOS_AT_BOOLEAN;
-		success = true;
-	}
-	else if (variantData.GetType() == EOnlineKeyValuePairDataType::Float)
-	{
-		float data;
-		variantData.GetValue(data);
-		outAttributeData.Value.AsDouble = data;
-		outAttributeData.ValueType = EOS_ESessionAttributeType::EOS_AT_DOUBLE;
-		success = true;
-	}
-	else if (variantData.GetType() == EOnlineKeyValuePairDataType::Double)
-	{
-		double data;
-		variantData.GetValue(data);
-		outAttributeData.Value.AsDouble = data;
-		outAttributeData.ValueType = EOS_ESessionAttributeType::EOS_AT_DOUBLE;
-		success = true;
-	}
-	else if (variantData.GetType() == EOnlineKeyValuePairDataType::Int64)
-	{
-		int64 iData;
-		variantData.GetValue(iData);
-		outAttributeData.Value.AsInt64 = iData;
-		outAttributeData.ValueType = EOS_ESessionAttributeType::EOS_AT_INT64;
-		success = true;
-	}
-	else if (variantData.GetType() == EOnlineKeyValuePairDataType::Int32)
-	{
-		int32 iData;
-		variantData.GetValue(iData);
-		outAttributeData.Value.AsInt64 = iData;
-		outAttributeData.ValueType = EOS_ESessionAttributeType::EOS_AT_INT64;
-		success = true;
-	}
-	else if (variantData.GetType() == EOnlineKeyValuePairDataType::String)
-	{
-		FString sData;
-		variantData.GetValue(sData);
-		outAttributeData.Value.AsUtf8 = TCHAR_TO_UTF8(*sData);
-		outAttributeData.ValueType = EOS_ESessionAttributeType::EOS_AT_STRING;
-		success = true;
-	}
-	else
-	{
-		error = TEXT("Type mismatch for session setting attribute.");
-		success = false;
-	}
-
-	if (success)
-	{
-		return outAttributeData;
-	}
-	return EOS_Sessions_AttributeData();
-}
-
 /** Get a resolved connection string from a session info */
 bool FOnlineSessionEpic::GetConnectStringFromSessionInfo(TSharedPtr<FOnlineSessionInfoEpic>& SessionInfo, FString& ConnectInfo, int32 PortOverride)
 {
@@ -249,6 +174,12 @@ void FOnlineSessionEpic::UpdateSessionSearchParameters(TSharedRef<FOnlineSession
 	FOnlineSearchSettings SearchSettings = sessionSearchPtr->QuerySettings;
 	for (auto param : SearchSettings.SearchParams)
 	{
+		// Parameters the backend can't evaluate are applied to the results, once they arrived
+		if (!FOnlineSessionSearchFilterEpic::IsSupportedByBackend(param.Value))
+		{
+			continue;
+		}
+
 		EOS_EOnlineComparisonOp compOp = EOS_EOnlineComparisonOp::EOS_CO_ANYOF;
 		switch (param.Value.ComparisonOp)
 		{
@@ -259,103 +190,35 @@ void FOnlineSessionEpic::UpdateSessionSearchParameters(TSharedRef<FOnlineSession
 			compOp = EOS_EOnlineComparisonOp::EOS_CO_NOTEQUAL;
 			break;
 		case EOnlineComparisonOp::GreaterThan:
-		{
-			if (!param.Value.Data.IsNumeric())
-			{
-				error = FString::Printf(TEXT("%s is not a valid comparison op for non numeric types."), *EOnlineComparisonOp::ToString(EOnlineComparisonOp::GreaterThan));
-			}
-			else
-			{
-				compOp = EOS_EOnlineComparisonOp::EOS_CO_GREATERTHAN;
-			}
+			compOp = EOS_EOnlineComparisonOp::EOS_CO_GREATERTHAN;
 			break;
-		}
 		case EOnlineComparisonOp::GreaterThanEquals:
-		{
-			if (!param.Value.Data.IsNumeric())
-			{
-				error = FString::Printf(TEXT("%s is not a valid comparison op for non numeric types."), *EOnlineComparisonOp::ToString(EOnlineComparisonOp::GreaterThanEquals));
-			}
-			else
-			{
-				compOp = EOS_EOnlineComparisonOp::EOS_CO_GREATERTHANOREQUAL;
-			}
+			compOp = EOS_EOnlineComparisonOp::EOS_CO_GREATERTHANOREQUAL;
 			break;
-		}
 		case EOnlineComparisonOp::LessThan:
-		{
-			if (!param.Value.Data.IsNumeric())
-			{
-				error = FString::Printf(TEXT("%s is not a valid comparison op for non numeric types."), *EOnlineComparisonOp::ToString(EOnlineComparisonOp::LessThan));
-			}
-			else
-			{
-				compOp = EOS_EOnlineComparisonOp::EOS_CO_LESSTHAN;
-			}
+			compOp = EOS_EOnlineComparisonOp::EOS_CO_LESSTHAN;
 			break;
-		}
 		case EOnlineComparisonOp::LessThanEquals:
-		{
-			if (!param.Value.Data.IsNumeric())
-			{
-				error = FString::Printf(TEXT("%s is not a valid comparison op for non numeric types."), *EOnlineComparisonOp::ToString(EOnlineComparisonOp::LessThanEquals));
-			}
-			else
-			{
-				compOp = EOS_EOnlineComparisonOp::EOS_CO_LESSTHANOREQUAL;
-			}
+			compOp = EOS_EOnlineComparisonOp::EOS_CO_LESSTHANOREQUAL;
 			break;
-		}
 		case EOnlineComparisonOp::Near:
-		{
-			if (!param.Value.Data.IsNumeric())
-			{
-				error = FString::Printf(TEXT("%s is not a valid comparison op for non numeric types."), *EOnlineComparisonOp::ToString(EOnlineComparisonOp::Near));
-			}
-			else
-			{
-				compOp = EOS_EOnlineComparisonOp::EOS_CO_DISTANCE;
-			}
+			compOp = EOS_EOnlineComparisonOp::EOS_CO_DISTANCE;
 			break;
-		}
 		case EOnlineComparisonOp::In:
-		{
-			if (param.Value.Data.GetType() != EOnlineKeyValuePairDataType::String)
-			{
-				error = FString::Printf(TEXT("%s is not a valid comparison op for non string types."), *EOnlineComparisonOp::ToString(EOnlineComparisonOp::In));
-			}
-			else
-			{
-				compOp = EOS_EOnlineComparisonOp::EOS_CO_ANYOF;
-			}
+			compOp = EOS_EOnlineComparisonOp::EOS_CO_ANYOF;
 			break;
-		}
 		case EOnlineComparisonOp::NotIn:
-		{
-			if (param.Value.Data.GetType() != EOnlineKeyValuePairDataType::String)
-			{
-				error = FString::Printf(TEXT("%s is not a valid comparison op for non string types."), *EOnlineComparisonOp::ToString(EOnlineComparisonOp::NotIn));
-			}
-			else
-			{
-				compOp = EOS_EOnlineComparisonOp::EOS_CO_NOTANYOF;
-			}
+			compOp = EOS_EOnlineComparisonOp::EOS_CO_NOTANYOF;
 			break;
-		}
 		default:
 			checkNoEntry();
 			break;
 		}
 
-		if (!error.IsEmpty())
-		{
-			// ToDo: Maybe return nullptr here?
-			return;
-		}
-
 		// Create the attribute data struct
-		EOS_Sessions_AttributeData attributeData = CreateEOSAttributeData(param.Key.ToString(), param.Value.Data, error);
-		if (error.IsEmpty())
+		FOnlineSessionAttributeArenaEpic arena;
+		EOS_Sessions_AttributeData attributeData;
+		if (this->Subsystem->SessionAttributeSchema->Marshal(param.Key, param.Value.Data, arena, attributeData, error))
 		{
 			EOS_SessionSearch_SetParameterOptions eosParam = {
 				EOS_SESSIONSEARCH_SETPARAMETER_API_LATEST,
@@ -373,349 +236,455 @@ void FOnlineSessionEpic::UpdateSessionSearchParameters(TSharedRef<FOnlineSession
 	}
 }
 
-void FOnlineSessionEpic::CreateSessionModificationHandle(FOnlineSessionSettings const& NewSessionSettings, EOS_HSessionModification& ModificationHandle, FString& Error)
+namespace
 {
-	// Note on GoTo usage:
-	// Goto was used here to remove duplicate calls to Printf
-	// and make error handling easier in general.
-	// Initializations need to be put in their own scope
+	/** The most results the backend returns for a search */
+	constexpr int32 MaxBackendSearchResults = 200;
 
-	EOS_EResult eosResult = EOS_EResult::EOS_Success;
-	FString setting;
-	FVariantData data;
-	FString error;
-
-	// NumPublicConnections
+	/** Whether a setting differs from the one sent before. Everything differs if nothing was sent yet */
+	template<typename ValueType>
+	bool HasSettingChanged(FOnlineSessionSettings const& NewSessionSettings, FOnlineSessionSettings const* OldSessionSettings, ValueType FOnlineSessionSettings::* Setting)
 	{
-		setting = TEXT("NumPublicConnections");
-		data.SetValue(NewSessionSettings.NumPublicConnections);
+		return !OldSessionSettings || NewSessionSettings.*Setting != OldSessionSettings->*Setting;
+	}
 
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
+	/** The permission level of the session. More restrictive settings take precedence */
+	EOS_EOnlineSessionPermissionLevel GetPermissionLevel(FOnlineSessionSettings const& SessionSettings)
+	{
+		EOS_EOnlineSessionPermissionLevel permissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_InviteOnly;
+		if (SessionSettings.bShouldAdvertise)
 		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
-			};
-
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-			if (eosResult != EOS_EResult::EOS_Success)
+			if (SessionSettings.bAllowJoinViaPresence)
+			{
+				permissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_PublicAdvertised;
+			}
+			if (SessionSettings.bAllowJoinViaPresenceFriendsOnly)
 			{
-				goto handleError;
+				permissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_JoinViaPresence;
 			}
 		}
-		else
+		return permissionLevel;
+	}
+
+	/** Whether the results of a search are ordered by a Near parameter. Sorting them by ping would undo that */
+	bool HasNearParameter(FOnlineSessionSearch const& SearchSettings)
+	{
+		for (TPair<FName, FOnlineSessionSearchParam> const& param : SearchSettings.QuerySettings.SearchParams)
 		{
-			goto handleError;
+			if (param.Value.ComparisonOp == EOnlineComparisonOp::Near)
+			{
+				return true;
+			}
 		}
+		return false;
 	}
+}
 
-	// NumPrivateConnections
+int32 FOnlineSessionEpic::CreateSessionModificationHandle(FOnlineSessionSettings const& NewSessionSettings, FOnlineSessionSettings const* OldSessionSettings, EOS_HSessionModification& ModificationHandle, FString& Error)
+{
+	FOnlineSessionAttributeSchemaEpic const& schema = *this->Subsystem->SessionAttributeSchema;
+
+	// Holds the strings of one attribute at a time, the SDK copies them when the attribute is added
+	FOnlineSessionAttributeArenaEpic arena;
+	int32 numChanges = 0;
+
+	// Releases and defaults the handle, so a failed write never reaches the backend
+	auto fail = [&Error, &ModificationHandle](FName Setting, FString const& Reason)
 	{
-		setting = TEXT("NumPrivateConnections");
-		data.SetValue(NewSessionSettings.NumPrivateConnections);
+		Error = FString::Printf(TEXT("Cannot update setting: %s - %s"), *Setting.ToString(), *Reason);
+		EOS_SessionModification_Release(ModificationHandle);
+		ModificationHandle = EOS_HSessionModification();
+		return 0;
+	};
+	auto eosError = [](EOS_EResult Result)
+	{
+		return FString::Printf(TEXT("Error Code: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Result)));
+	};
 
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
+	FString reason;
+	auto addAttribute = [&](FName Name, FVariantData const& Data, EOnlineDataAdvertisementType::Type AdvertisementType)
+	{
+		EOS_Sessions_AttributeData attrData;
+		if (!schema.Marshal(Name, Data, arena, attrData, reason))
 		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
-			};
-
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-			if (eosResult != EOS_EResult::EOS_Success)
-			{
-				goto handleError;
-			}
+			return false;
 		}
-		else
+
+		EOS_SessionModification_AddAttributeOptions attrOpts = {
+			EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
+			&attrData,
+			AdvertisementType == EOnlineDataAdvertisementType::DontAdvertise ? EOS_ESessionAttributeAdvertisementType::EOS_SAAT_DontAdvertise : EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
+		};
+		EOS_EResult eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
+		arena.Reset();
+		numChanges += 1;
+
+		if (eosResult != EOS_EResult::EOS_Success)
 		{
-			goto handleError;
+			reason = eosError(eosResult);
+			return false;
 		}
-	}
+		return true;
+	};
 
-	// bUsesPresence
+	// The settings of FOnlineSessionSettings that are sent as attributes
+	struct FIntSetting
 	{
-		setting = TEXT("bUsesPresence");
-		data.SetValue(NewSessionSettings.bShouldAdvertise);
+		FName Name;
+		int32 FOnlineSessionSettings::* Member;
+	};
+	struct FBoolSetting
+	{
+		FName Name;
+		bool FOnlineSessionSettings::* Member;
+	};
+	static FIntSetting const intSettings[] = {
+		{ TEXT("NumPublicConnections"), &FOnlineSessionSettings::NumPublicConnections },
+		{ TEXT("NumPrivateConnections"), &FOnlineSessionSettings::NumPrivateConnections },
+		{ TEXT("BuildUniqueId"), &FOnlineSessionSettings::BuildUniqueId }
+	};
+	static FBoolSetting const boolSettings[] = {
+		{ TEXT("bUsesPresence"), &FOnlineSessionSettings::bUsesPresence },
+		{ TEXT("bIsLANMatch"), &FOnlineSessionSettings::bIsLANMatch },
+		{ TEXT("bIsDedicated"), &FOnlineSessionSettings::bIsDedicated },
+		{ TEXT("bUsesStats"), &FOnlineSessionSettings::bUsesStats },
+		{ TEXT("bAllowInvites"), &FOnlineSessionSettings::bAllowInvites },
+		{ TEXT("bAntiCheatProtected"), &FOnlineSessionSettings::bAntiCheatProtected }
+	};
 
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
+	for (FIntSetting const& setting : intSettings)
+	{
+		if (HasSettingChanged(NewSessionSettings, OldSessionSettings, setting.Member)
+			&& !addAttribute(setting.Name, FVariantData(NewSessionSettings.*setting.Member), EOnlineDataAdvertisementType::ViaOnlineService))
 		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
-			};
-
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-			if (eosResult != EOS_EResult::EOS_Success)
-			{
-				goto handleError;
-			}
+			return fail(setting.Name, reason);
 		}
-		else
+	}
+	for (FBoolSetting const& setting : boolSettings)
+	{
+		if (HasSettingChanged(NewSessionSettings, OldSessionSettings, setting.Member)
+			&& !addAttribute(setting.Name, FVariantData(NewSessionSettings.*setting.Member), EOnlineDataAdvertisementType::ViaOnlineService))
 		{
-			goto handleError;
+			return fail(setting.Name, reason);
 		}
 	}
 
 	// bAllowJoinInProgress
+	if (HasSettingChanged(NewSessionSettings, OldSessionSettings, &FOnlineSessionSettings::bAllowJoinInProgress))
 	{
+		numChanges += 1;
 		EOS_SessionModification_SetJoinInProgressAllowedOptions joinInProgresOpts = {
-		EOS_SESSIONMODIFICATION_SETJOININPROGRESSALLOWED_API_LATEST,
-		NewSessionSettings.bAllowJoinInProgress
+			EOS_SESSIONMODIFICATION_SETJOININPROGRESSALLOWED_API_LATEST,
+			NewSessionSettings.bAllowJoinInProgress
 		};
-		eosResult = EOS_SessionModification_SetJoinInProgressAllowed(ModificationHandle, &joinInProgresOpts);
+		EOS_EResult eosResult = EOS_SessionModification_SetJoinInProgressAllowed(ModificationHandle, &joinInProgresOpts);
 		if (eosResult != EOS_EResult::EOS_Success)
 		{
-			setting = TEXT("JoinInProgress");
-			goto handleError;
+			return fail(TEXT("JoinInProgress"), eosError(eosResult));
 		}
 	}
 
-	// bIsLANMatch
+	// bShouldAdvertise || bAllowJoinViaPresence || bAllowJoinViaPresenceFriendsOnly
+	EOS_EOnlineSessionPermissionLevel permissionLevel = GetPermissionLevel(NewSessionSettings);
+	if (!OldSessionSettings || permissionLevel != GetPermissionLevel(*OldSessionSettings))
 	{
-		setting = TEXT("bIsLANMatch");
-		data.SetValue(NewSessionSettings.bIsLANMatch);
-
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
-		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
-			};
-
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-			if (eosResult != EOS_EResult::EOS_Success)
-			{
-				goto handleError;
-			}
-		}
-		else
+		numChanges += 1;
+		EOS_SessionModification_SetPermissionLevelOptions permissionOpts = {
+			EOS_SESSIONMODIFICATION_SETPERMISSIONLEVEL_API_LATEST,
+			permissionLevel
+		};
+		EOS_EResult eosResult = EOS_SessionModification_SetPermissionLevel(ModificationHandle, &permissionOpts);
+		if (eosResult != EOS_EResult::EOS_Success)
 		{
-			goto handleError;
+			return fail(TEXT("bShouldAdvertise || bAllowJoinViaPresence || bAllowJoinViaPresenceFriendsOnly"), eosError(eosResult));
 		}
 	}
 
-	// bIsDedicated
+	// FSessionSettings[]
+	for (TPair<FName, FOnlineSessionSetting> const& s : NewSessionSettings.Settings)
 	{
-		setting = TEXT("bIsDedicated");
-		data.SetValue(NewSessionSettings.bIsDedicated);
-
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
+		if (OldSessionSettings)
 		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
-			};
-
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-			if (eosResult != EOS_EResult::EOS_Success)
+			FOnlineSessionSetting const* oldSetting = OldSessionSettings->Settings.Find(s.Key);
+			if (oldSetting && oldSetting->Data == s.Value.Data && oldSetting->AdvertisementType == s.Value.AdvertisementType)
 			{
-				goto handleError;
+				continue;
 			}
 		}
-		else
+
+		if (!addAttribute(s.Key, s.Value.Data, s.Value.AdvertisementType))
 		{
-			goto handleError;
+			return fail(s.Key, reason);
 		}
 	}
 
-	// bUsesStats
+	// Settings that were sent before, but were removed since
+	if (OldSessionSettings)
 	{
-		setting = TEXT("bUsesStats");
-		data.SetValue(NewSessionSettings.bUsesStats);
-
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
+		for (TPair<FName, FOnlineSessionSetting> const& s : OldSessionSettings->Settings)
 		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
-			};
-
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-			if (eosResult != EOS_EResult::EOS_Success)
+			if (NewSessionSettings.Settings.Contains(s.Key))
 			{
-				goto handleError;
+				continue;
 			}
-		}
-		else
-		{
-			goto handleError;
-		}
-	}
 
-	// bAllowInvites
-	{
-		setting = TEXT("bAllowInvites");
-		data.SetValue(NewSessionSettings.bAllowInvites);
-
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
-		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
+			numChanges += 1;
+			EOS_SessionModification_RemoveAttributeOptions removeOpts = {
+				EOS_SESSIONMODIFICATION_REMOVEATTRIBUTE_API_LATEST,
+				schema.GetUtf8Name(s.Key, arena)
 			};
-
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
+			EOS_EResult eosResult = EOS_SessionModification_RemoveAttribute(ModificationHandle, &removeOpts);
+			arena.Reset();
 			if (eosResult != EOS_EResult::EOS_Success)
 			{
-				goto handleError;
+				return fail(s.Key, eosError(eosResult));
 			}
 		}
-		else
-		{
-			goto handleError;
-		}
 	}
 
-	// bShouldAdvertise || bAllowJoinViaPresence || bAllowJoinViaPresenceFriendsOnly
-	// More restrictive from left to right. More restrictive takes precedence.
+	// Set the total players, which are (public + private) connections
+	int32 maxPlayers = NewSessionSettings.NumPrivateConnections + NewSessionSettings.NumPublicConnections;
+	if (!OldSessionSettings || maxPlayers != OldSessionSettings->NumPrivateConnections + OldSessionSettings->NumPublicConnections)
 	{
-		EOS_EOnlineSessionPermissionLevel permissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_InviteOnly;
-		if (NewSessionSettings.bShouldAdvertise)
-		{
-			if (NewSessionSettings.bAllowJoinViaPresence)
-			{
-				permissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_PublicAdvertised;
-			}
-			if (NewSessionSettings.bAllowJoinViaPresenceFriendsOnly)
-			{
-				permissionLevel = permissionLevel = EOS_EOnlineSessionPermissionLevel::EOS_OSPF_JoinViaPresence;
-			}
-		}
-		EOS_SessionModification_SetPermissionLevelOptions permissionOpts{
-			EOS_SESSIONMODIFICATION_SETPERMISSIONLEVEL_API_LATEST,
-			permissionLevel
+		numChanges += 1;
+		EOS_SessionModification_SetMaxPlayersOptions playerOpts = {
+			EOS_SESSIONMODIFICATION_SETMAXPLAYERS_API_LATEST,
+			static_cast<uint32_t>(maxPlayers)
 		};
-		eosResult = EOS_SessionModification_SetPermissionLevel(ModificationHandle, &permissionOpts);
+		EOS_EResult eosResult = EOS_SessionModification_SetMaxPlayers(ModificationHandle, &playerOpts);
 		if (eosResult != EOS_EResult::EOS_Success)
 		{
-			setting = TEXT("bShouldAdvertise || bAllowJoinViaPresence || bAllowJoinViaPresenceFriendsOnly");
-			goto handleError;
+			return fail(TEXT("MaxPlayers"), eosError(eosResult));
 		}
 	}
 
-	// bAntiCheatProtected
-	{
-		setting = TEXT("bAntiCheatProtected");
-		data.SetValue(NewSessionSettings.bAntiCheatProtected);
+	return numChanges;
+}
 
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
+// ---------------------------------------------
+// Rate limited SDK requests
+//
+// Each helper passes one SDK call through the rate limiter.
+// They are used for the first attempt as well as for retries.
+// ---------------------------------------------
+
+void FOnlineSessionEpic::IssueUpdateSession(FName SessionName, EOS_HSessionModification ModificationHandle, void* ClientData, EOS_Sessions_OnUpdateSessionCallback Callback)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Session, [this, ModificationHandle, ClientData, Callback]()
 		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
+			EOS_Sessions_UpdateSessionOptions updateSessionOptions = {
+				EOS_SESSIONS_UPDATESESSION_API_LATEST,
+				ModificationHandle
 			};
+			EOS_Sessions_UpdateSession(this->sessionsHandle, &updateSessionOptions, ClientData, Callback);
 
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-			if (eosResult != EOS_EResult::EOS_Success)
-			{
-				goto handleError;
-			}
-		}
-		else
+			// The SDK copies what it needs, the handle can be released right away
+			EOS_SessionModification_Release(ModificationHandle);
+		}, [SessionName, ModificationHandle, ClientData, Callback]()
 		{
-			goto handleError;
-		}
-	}
+			// Dropped on shutdown, the update completes as failed
+			EOS_SessionModification_Release(ModificationHandle);
+			FTCHARToUTF8 sessionNameUtf8(*SessionName.ToString());
+			EOS_Sessions_UpdateSessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = ClientData;
+			info.SessionName = sessionNameUtf8.Get();
+			Callback(&info);
+		});
+}
 
-	// BuildUniqueId
-	{
-		setting = TEXT("BuildUniqueId");
-		data.SetValue(NewSessionSettings.BuildUniqueId);
+void FOnlineSessionEpic::IssueStartSession(FSessionStateChangeAdditionalData* Context)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Session, [this, Context]()
+		{
+			FTCHARToUTF8 sessionNameUtf8(*Context->SessionName.ToString());
+			EOS_Sessions_StartSessionOptions startSessionOpts = {
+				EOS_SESSIONS_STARTSESSION_API_LATEST,
+				sessionNameUtf8.Get()
+			};
+			EOS_Sessions_StartSession(this->sessionsHandle, &startSessionOpts, Context, &FOnlineSessionEpic::OnEOSStartSessionComplete);
+		}, [Context]()
+		{
+			// Dropped on shutdown, the start completes as failed
+			EOS_Sessions_StartSessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = Context;
+			OnEOSStartSessionComplete(&info);
+		});
+}
 
-		EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, data, Error);
-		if (Error.IsEmpty())
+void FOnlineSessionEpic::IssueEndSession(FSessionStateChangeAdditionalData* Context)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Session, [this, Context]()
 		{
-			EOS_SessionModification_AddAttributeOptions attrOpts = {
-			   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-			   &attrData,
-			   EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise
+			FTCHARToUTF8 sessionNameUtf8(*Context->SessionName.ToString());
+			EOS_Sessions_EndSessionOptions endSessionOpts = {
+				EOS_SESSIONS_ENDSESSION_API_LATEST,
+				sessionNameUtf8.Get()
 			};
+			EOS_Sessions_EndSession(this->sessionsHandle, &endSessionOpts, Context, &FOnlineSessionEpic::OnEOSEndSessionComplete);
+		}, [Context]()
+		{
+			// Dropped on shutdown, the end completes as failed
+			EOS_Sessions_EndSessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = Context;
+			OnEOSEndSessionComplete(&info);
+		});
+}
 
-			eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-			if (eosResult != EOS_EResult::EOS_Success)
-			{
-				goto handleError;
-			}
-		}
-		else
+void FOnlineSessionEpic::IssueDestroySession(FSessionStateChangeAdditionalData* Context)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Session, [this, Context]()
 		{
-			goto handleError;
-		}
-	}
+			FTCHARToUTF8 sessionNameUtf8(*Context->SessionName.ToString());
+			EOS_Sessions_DestroySessionOptions destroySessionOpts = {
+				EOS_SESSIONS_DESTROYSESSION_API_LATEST,
+				sessionNameUtf8.Get()
+			};
+			EOS_Sessions_DestroySession(this->sessionsHandle, &destroySessionOpts, Context, &FOnlineSessionEpic::OnEOSDestroySessionComplete);
+		}, [Context]()
+		{
+			// Dropped on shutdown, the destroy completes as failed
+			EOS_Sessions_DestroySessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = Context;
+			OnEOSDestroySessionComplete(&info);
+		});
+}
 
-	// FSessionSettings[]
-	{
-		for (auto s : NewSessionSettings.Settings)
+void FOnlineSessionEpic::IssueJoinSession(FJoinSessionAdditionalData* Context)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Session, [this, Context]()
 		{
-			setting = s.Key.ToString();
-			EOS_ESessionAttributeAdvertisementType advertisementType;
-			if (s.Value.AdvertisementType == EOnlineDataAdvertisementType::DontAdvertise)
+			FTCHARToUTF8 sessionNameUtf8(*Context->SessionName.ToString());
+			EOS_Sessions_JoinSessionOptions joinSessionOpts = {
+				EOS_SESSIONS_JOINSESSION_API_LATEST,
+				sessionNameUtf8.Get()
+			};
+			EOS_Sessions_JoinSession(this->sessionsHandle, &joinSessionOpts, Context, &FOnlineSessionEpic::OnEOSJoinSessionComplete);
+		}, [Context]()
+		{
+			// Dropped on shutdown, the join completes as failed
+			EOS_Sessions_JoinSessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = Context;
+			OnEOSJoinSessionComplete(&info);
+		});
+}
+
+void FOnlineSessionEpic::IssueFindSessions(FFindSessionsAdditionalData* Context, EOS_HSessionSearch SearchHandle)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Session, [this, Context, SearchHandle]()
+		{
+			// A search given up on before it was sent doesn't need to be sent at all
+			FSessionSearch* search = this->SessionSearches.Find(Context->SearchId);
+			if (search && search->FinishTime != 0)
 			{
-				advertisementType = EOS_ESessionAttributeAdvertisementType::EOS_SAAT_DontAdvertise;
+				EOS_SessionSearch_Release(SearchHandle);
+				search->SearchHandle = nullptr;
+				delete Context;
+				return;
 			}
-			else
+
+			EOS_SessionSearch_FindOptions findOptions = {
+				EOS_SESSIONSEARCH_FIND_API_LATEST,
+				Context->LocalUserId
+			};
+			EOS_SessionSearch_Find(SearchHandle, &findOptions, Context, &FOnlineSessionEpic::OnEOSFindSessionComplete);
+		}, [Context]()
+		{
+			// Dropped on shutdown, the search completes as failed
+			EOS_SessionSearch_FindCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = Context;
+			OnEOSFindSessionComplete(&info);
+		});
+}
+
+void FOnlineSessionEpic::IssueRegisterPlayers(FName SessionName, TArray<TSharedRef<const FUniqueNetId>> const& Players)
+{
+	FRegisterPlayersAdditionalData* additionalData = new FRegisterPlayersAdditionalData();
+	additionalData->OnlineSessionPtr = this;
+	additionalData->SessionName = SessionName;
+	additionalData->RegisteredPlayers = Players;
+
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::Session, [this, additionalData]()
+		{
+			TArray<EOS_ProductUserId> productUserIds;
+			for (TSharedRef<const FUniqueNetId> const& player : additionalData->RegisteredPlayers)
 			{
-				advertisementType = EOS_ESessionAttributeAdvertisementType::EOS_SAAT_Advertise;
+				productUserIds.Add(StaticCastSharedRef<FUniqueNetIdEpic const>(player)->ToProductUserId());
 			}
 
-			EOS_Sessions_AttributeData attrData = CreateEOSAttributeData(setting, s.Value.Data, Error);
-			if (Error.IsEmpty())
-			{
-				EOS_SessionModification_AddAttributeOptions attrOpts = {
-				   EOS_SESSIONMODIFICATION_ADDATTRIBUTE_API_LATEST,
-				   &attrData,
-				   advertisementType
-				};
+			FTCHARToUTF8 sessionNameUtf8(*additionalData->SessionName.ToString());
+			EOS_Sessions_RegisterPlayersOptions registerPlayerOpts = {
+				EOS_SESSIONS_REGISTERPLAYERS_API_LATEST,
+				sessionNameUtf8.Get(),
+				productUserIds.GetData(),
+				static_cast<uint32_t>(productUserIds.Num())
+			};
+			EOS_Sessions_RegisterPlayers(this->sessionsHandle, &registerPlayerOpts, additionalData, &FOnlineSessionEpic::OnEOSRegisterPlayersComplete);
+		}, [additionalData]()
+		{
+			// Dropped on shutdown, the registration completes as failed
+			EOS_Sessions_RegisterPlayersCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = additionalData;
+			OnEOSRegisterPlayersComplete(&info);
+		});
+}
 
-				eosResult = EOS_SessionModification_AddAttribute(ModificationHandle, &attrOpts);
-				if (eosResult != EOS_EResult::EOS_Success)
-				{
-					goto handleError;
-				}
-			}
-			else
+// ---------------------------------------------
+// Offline writes
+//
+// Writes made while the session owner is offline are journaled,
+// and sent once the connection is back.
+// ---------------------------------------------
+
+bool FOnlineSessionEpic::ShouldDeferWrite(FNamedOnlineSession const& Session) const
+{
+	EOS_ProductUserId ownerId = nullptr;
+	if (Session.LocalOwnerId.IsValid() && Session.LocalOwnerId->GetType() == EPIC_SUBSYSTEM)
+	{
+		ownerId = StaticCastSharedPtr<FUniqueNetIdEpic const>(Session.LocalOwnerId)->ToProductUserId();
+	}
+	return this->Subsystem->WriteJournal->ShouldDefer(ownerId);
+}
+
+void FOnlineSessionEpic::DeferUpdateSession(FName SessionName)
+{
+	this->Subsystem->WriteJournal->Record(FString::Printf(TEXT("UpdateSession:%s"), *SessionName.ToString()), [this, SessionName]()
+		{
+			if (FNamedOnlineSession* session = this->GetNamedSession(SessionName))
 			{
-				goto handleError;
+				FOnlineSessionSettings settings = session->SessionSettings;
+				this->UpdateSession(SessionName, settings, true);
 			}
-		}
-	}
+		});
+}
 
-	// Set the total players, which are (public + private) connections
+void FOnlineSessionEpic::DeferRegisterPlayers(FName SessionName, TArray<TSharedRef<const FUniqueNetId>> const& Players)
+{
+	TArray<TSharedRef<const FUniqueNetId>>& deferred = this->DeferredRegistrations.FindOrAdd(SessionName);
+	for (TSharedRef<const FUniqueNetId> const& player : Players)
 	{
-		EOS_SessionModification_SetMaxPlayersOptions playerOpts = {};
-		playerOpts.ApiVersion = EOS_SESSIONMODIFICATION_SETMAXPLAYERS_API_LATEST;
-		playerOpts.MaxPlayers = NewSessionSettings.NumPrivateConnections + NewSessionSettings.NumPublicConnections;
-
-		eosResult = EOS_SessionModification_SetMaxPlayers(ModificationHandle, &playerOpts);
-		if (eosResult != EOS_EResult::EOS_Success)
+		if (deferred.IndexOfByPredicate(FUniqueNetIdMatcher(*player)) == INDEX_NONE)
 		{
-			setting = TEXT("MaxPlayers");
-			goto handleError;
+			deferred.Add(player);
 		}
 	}
-	return;
 
-handleError:
-	// If there's an error, assign it to Error and default the ModificationHandle
-	Error = FString::Printf(TEXT("Cannot update setting: %s - Error Code: %s"), *setting, UTF8_TO_TCHAR(EOS_EResult_ToString(eosResult)));
-	ModificationHandle = EOS_HSessionModification();
+	// All players journaled for the session are registered in one call
+	this->Subsystem->WriteJournal->Record(FString::Printf(TEXT("RegisterPlayers:%s"), *SessionName.ToString()), [this, SessionName]()
+		{
+			TArray<TSharedRef<const FUniqueNetId>> players;
+			this->DeferredRegistrations.RemoveAndCopyValue(SessionName, players);
+			if (players.Num() > 0 && this->GetNamedSession(SessionName))
+			{
+				this->IssueRegisterPlayers(SessionName, players);
+			}
+		});
 }
 
 // ---------------------------------------------
@@ -735,6 +704,7 @@ void FOnlineSessionEpic::OnEOSCreateSessionComplete(const EOS_Sessions_UpdateSes
 	if (ResultCode != EOS_EResult::EOS_Success)
 	{
 		UE_LOG_ONLINE_SESSION(Warning, TEXT("Update Session failed. Error Code: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(ResultCode)));
+		delete additionalData;
 		thisPtr->RemoveNamedSession(sessionName);
 		thisPtr->TriggerOnCreateSessionCompleteDelegates(sessionName, false);
 		return;
@@ -744,10 +714,14 @@ void FOnlineSessionEpic::OnEOSCreateSessionComplete(const EOS_Sessions_UpdateSes
 	if (!session)
 	{
 		UE_LOG_ONLINE_SESSION(Fatal, TEXT("CreateSession complete callback called, but session \"%s\" not found."), *sessionName.ToString());
+		delete additionalData;
 		thisPtr->TriggerOnCreateSessionCompleteDelegates(sessionName, false);
 		return;
 	}
 
+	// Updates of the session are diffed against what the backend has now
+	thisPtr->SentSessionSettings.Add(sessionName, additionalData->SentSessionSettings);
+
 	// --------------------------
 	// Create a new session info class, that includes the session id and host address
 	// --------------------------
@@ -759,6 +733,7 @@ void FOnlineSessionEpic::OnEOSCreateSessionComplete(const EOS_Sessions_UpdateSes
 	// Add the host to the list of registered players,
 	// without updating the number of slots.
 	session->RegisteredPlayers.Add(additionalData->CreatingUserId);
+	thisPtr->PublishSessionSnapshot();
 
 	// Get the session handle for a given session
 	EOS_HActiveSession activeSessionHandle = nullptr;
@@ -798,6 +773,23 @@ void FOnlineSessionEpic::OnEOSStartSessionComplete(const EOS_Sessions_StartSessi
 	FSessionStateChangeAdditionalData* context = (FSessionStateChangeAdditionalData*)Data->ClientData;
 	FOnlineSessionEpic* thisPtr = context->OnlineSessionPtr;
 	FName sessionName = context->SessionName;
+
+	// Transient failures reissue the start with the same context
+	if (thisPtr->Subsystem->RetryPolicy->ScheduleRetry(EEpicOperation::Session, Data->ResultCode, context->Attempt, [context]()
+		{
+			context->Attempt += 1;
+			context->OnlineSessionPtr->IssueStartSession(context);
+		}, [context]()
+		{
+			// Dropped on shutdown, the start completes as failed
+			EOS_Sessions_StartSessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = context;
+			OnEOSStartSessionComplete(&info);
+		}))
+	{
+		return;
+	}
 	delete(context);
 
 	/** Result code for the operation. EOS_Success is returned for a successful operation, otherwise one of the error codes is returned. See eos_common.h */
@@ -812,6 +804,7 @@ void FOnlineSessionEpic::OnEOSStartSessionComplete(const EOS_Sessions_StartSessi
 	if (FNamedOnlineSession* session = thisPtr->GetNamedSession(sessionName))
 	{
 		session->SessionState = EOnlineSessionState::InProgress;
+		thisPtr->PublishSessionSnapshot();
 		thisPtr->TriggerOnStartSessionCompleteDelegates(sessionName, true);
 	}
 	else
@@ -829,25 +822,35 @@ void FOnlineSessionEpic::OnEOSUpdateSessionComplete(const EOS_Sessions_UpdateSes
 	/** Context that was passed into EOS_Sessions_UpdateSession */
 	FUpdateSessionAdditionalData* context = (FUpdateSessionAdditionalData*)Data->ClientData;
 	FOnlineSessionEpic* thisPtr = context->OnlineSessionPtr;
-	FOnlineSessionSettings oldSettings = context->OldSessionSettings;
+	FOnlineSessionSettings oldSettings = MoveTemp(context->OldSessionSettings);
+	FOnlineSessionSettings sentSettings = MoveTemp(context->SentSessionSettings);
+	TPair<FName, uint32> batchKey = MakeTuple(sessionName, context->Batch);
+
+	// Cleanup the additional resources.
+	delete(context);
 
 	if (ResultCode != EOS_EResult::EOS_Success)
 	{
+		// Revert local only changes, unless newer ones are waiting to be sent
 		FNamedOnlineSession* session = thisPtr->GetNamedSession(sessionName);
-		if (session)
+		if (session && !thisPtr->PendingSessionUpdates.Contains(sessionName))
 		{
-			// Revert local only changes
 			session->SessionSettings = oldSettings;
+			thisPtr->RefreshPresenceSessionFlag();
 		}
 		UE_LOG_ONLINE_SESSION(Warning, TEXT("[EOS SDK] Failed to update session - Error Code: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(ResultCode)));
-		thisPtr->TriggerOnCreateSessionCompleteDelegates(sessionName, false);
+		thisPtr->SessionUpdateCoalescer.Complete(batchKey, false);
 		return;
 	}
 
-	UE_LOG_ONLINE_SESSION(Display, TEXT("Updated session: %s"), *sessionName.ToString());
+	// The next update is diffed against what the backend has now
+	if (thisPtr->GetNamedSession(sessionName))
+	{
+		thisPtr->SentSessionSettings.Add(sessionName, MoveTemp(sentSettings));
+	}
 
-	// Cleanup the additional resources.
-	delete(context);
+	UE_LOG_ONLINE_SESSION(Display, TEXT("Updated session: %s"), *sessionName.ToString());
+	thisPtr->SessionUpdateCoalescer.Complete(batchKey, true);
 }
 
 void FOnlineSessionEpic::OnEOSEndSessionComplete(const EOS_Sessions_EndSessionCallbackInfo* Data)
@@ -857,6 +860,23 @@ void FOnlineSessionEpic::OnEOSEndSessionComplete(const EOS_Sessions_EndSessionCa
 	FSessionStateChangeAdditionalData* context = (FSessionStateChangeAdditionalData*)Data->ClientData;
 	FOnlineSessionEpic* thisPtr = context->OnlineSessionPtr;
 	FName sessionName = context->SessionName;
+
+	// Transient failures reissue the end with the same context
+	if (thisPtr->Subsystem->RetryPolicy->ScheduleRetry(EEpicOperation::Session, Data->ResultCode, context->Attempt, [context]()
+		{
+			context->Attempt += 1;
+			context->OnlineSessionPtr->IssueEndSession(context);
+		}, [context]()
+		{
+			// Dropped on shutdown, the end completes as failed
+			EOS_Sessions_EndSessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = context;
+			OnEOSEndSessionComplete(&info);
+		}))
+	{
+		return;
+	}
 	delete(context);
 
 	/** Result code for the operation. EOS_Success is returned for a successful operation, otherwise one of the error codes is returned. See eos_common.h */
@@ -871,6 +891,7 @@ void FOnlineSessionEpic::OnEOSEndSessionComplete(const EOS_Sessions_EndSessionCa
 	if (FNamedOnlineSession* session = thisPtr->GetNamedSession(sessionName))
 	{
 		session->SessionState = EOnlineSessionState::Ended;
+		thisPtr->PublishSessionSnapshot();
 		thisPtr->TriggerOnEndSessionCompleteDelegates(sessionName, true);
 	}
 	else
@@ -887,6 +908,23 @@ void FOnlineSessionEpic::OnEOSDestroySessionComplete(const EOS_Sessions_DestroyS
 	FSessionStateChangeAdditionalData* context = (FSessionStateChangeAdditionalData*)Data->ClientData;
 	FOnlineSessionEpic* thisPtr = context->OnlineSessionPtr;
 	FName sessionName = context->SessionName;
+
+	// Transient failures reissue the destroy with the same context
+	if (thisPtr->Subsystem->RetryPolicy->ScheduleRetry(EEpicOperation::Session, Data->ResultCode, context->Attempt, [context]()
+		{
+			context->Attempt += 1;
+			context->OnlineSessionPtr->IssueDestroySession(context);
+		}, [context]()
+		{
+			// Dropped on shutdown, the destroy completes as failed
+			EOS_Sessions_DestroySessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = context;
+			OnEOSDestroySessionComplete(&info);
+		}))
+	{
+		return;
+	}
 	delete(context);
 
 	/** Result code for the operation. EOS_Success is returned for a successful operation, otherwise one of the error codes is returned. See eos_common.h */
@@ -906,104 +944,279 @@ void FOnlineSessionEpic::OnEOSDestroySessionComplete(const EOS_Sessions_DestroyS
 	else
 	{
 		UE_LOG_ONLINE_SESSION(Warning, TEXT("Session \"%s\" changed on backend, but local session not found."), *sessionName.ToString());
+
+		// The session is gone on the backend either way
+		thisPtr->TriggerOnDestroySessionCompleteDelegates(sessionName, true);
 	}
 }
 
 void FOnlineSessionEpic::OnEOSFindSessionComplete(const EOS_SessionSearch_FindCallbackInfo* Data)
 {
-	// Context that was passed into EOS_Sessions_UpdateSession
-	// Copy the session ptr and start time, then free
-	FFindSessionsAdditionalData* context = (FFindSessionsAdditionalData*)Data->ClientData;
-	FOnlineSessionEpic* thisPtr = context->OnlineSessionPtr;
-	double searchStartTime = context->SearchStartTime;
-	delete(context);
+	// Context that was passed into EOS_SessionSearch_Find
+	// Copy the session ptr and search id, then free
+	FFindSessionsAdditionalData* context = (FFindSessionsAdditionalData*)Data->ClientData;
+	FOnlineSessionEpic* thisPtr = context->OnlineSessionPtr;
+	uint32 searchId = context->SearchId;
+
+	FSessionSearch* currentSearch = thisPtr->SessionSearches.Find(searchId);
+
+	// Transient failures run the same search again, unless it was given up on. The search handle stays alive until the backend answered.
+	if (currentSearch && currentSearch->FinishTime == 0)
+	{
+		EOS_HSessionSearch searchHandle = currentSearch->SearchHandle;
+		if (thisPtr->Subsystem->RetryPolicy->ScheduleRetry(EEpicOperation::Session, Data->ResultCode, context->Attempt, [context, searchHandle]()
+			{
+				context->Attempt += 1;
+				context->OnlineSessionPtr->IssueFindSessions(context, searchHandle);
+			}, [context]()
+			{
+				// Dropped on shutdown, the search completes as failed
+				EOS_SessionSearch_FindCallbackInfo info = {};
+				info.ResultCode = EOS_EResult::EOS_Canceled;
+				info.ClientData = context;
+				OnEOSFindSessionComplete(&info);
+			}))
+		{
+			return;
+		}
+	}
+	delete(context);
+
+	if (!currentSearch)
+	{
+		UE_LOG_ONLINE_SESSION(Warning, TEXT("Session search %u completed, but session not in session search list!"), searchId);
+		return;
+	}
+
+	EOS_HSessionSearch searchHandle = currentSearch->SearchHandle;
+	currentSearch->SearchHandle = nullptr;
+	checkf(searchHandle, TEXT("%s called, but the EOS session search handle is invalid"), *FString(__FUNCTION__));
+
+	if (currentSearch->FinishTime != 0)
+	{
+		// Cancelled or timed out while the backend was searching, nobody waits for the results anymore
+		UE_LOG_ONLINE_SESSION(Verbose, TEXT("Dropping the results of session search %u, it was given up on"), searchId);
+		EOS_SessionSearch_Release(searchHandle);
+		return;
+	}
+
+	if (Data->ResultCode != EOS_EResult::EOS_Success)
+	{
+		EOS_SessionSearch_Release(searchHandle);
+		UE_LOG_ONLINE_SESSION(Warning, TEXT("Error in %s\r\n    Message: [EOS SDK] Couldn't find session. Error: %s"), *FString(__FUNCTION__), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+		thisPtr->FinishSessionSearch(searchId, false);
+		return;
+	}
+
+	// Get how many results we got
+	EOS_SessionSearch_GetSearchResultCountOptions searchResultCountOptions = {
+		EOS_SESSIONSEARCH_GETSEARCHRESULTCOUNT_API_LATEST
+	};
+	uint32 resultCount = EOS_SessionSearch_GetSearchResultCount(searchHandle, &searchResultCountOptions);
+	UE_CLOG_ONLINE_SESSION(resultCount == 0, Display, TEXT("No sessions found"));
+
+	// The results are converted in slices from Tick, the handle stays alive until the last one is done.
+	// The backend answered, so the search can't time out anymore.
+	currentSearch->SearchHandle = searchHandle;
+	currentSearch->Deadline = 0;
+	currentSearch->bConverting = true;
+	currentSearch->ResultCount = resultCount;
+	currentSearch->NextResult = 0;
+	currentSearch->SearchSettings->SearchResults.Reserve(resultCount);
+
+	// The first slice is converted right away, small searches complete without waiting for the next frame
+	thisPtr->ConvertSessionSearchResults(searchId, thisPtr->GetSearchResultSliceEnd(FPlatformTime::Seconds()));
+}
+
+double FOnlineSessionEpic::GetSearchResultSliceEnd(double Now) const
+{
+	return this->SearchResultFrameBudget > 0.f ? Now + this->SearchResultFrameBudget / 1000.0 : 0;
+}
+
+bool FOnlineSessionEpic::ConvertSearchResult(EOS_HSessionSearch SearchHandle, uint32 Index, FOnlineSessionSearchResult& OutResult, FString& Error)
+{
+	EOS_SessionSearch_CopySearchResultByIndexOptions copySearchResultsByIndex = {
+		EOS_SESSIONSEARCH_COPYSEARCHRESULTBYINDEX_API_LATEST,
+		Index
+	};
+	EOS_HSessionDetails sessionDetailsHandle = nullptr;
+	EOS_EResult eosResult = EOS_SessionSearch_CopySearchResultByIndex(SearchHandle, &copySearchResultsByIndex, &sessionDetailsHandle);
+	if (eosResult != EOS_EResult::EOS_Success)
+	{
+		Error = FString::Printf(TEXT("[EOS SDK] Couldn't get session details handle.\r\n    Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(eosResult)));
+		return false;
+	}
+
+	// The SDK allocates the session info, it is released once the details are taken over
+	EOS_SessionDetails_Info* eosSessionInfo = nullptr;
+	EOS_SessionDetails_CopyInfoOptions copyInfoOptions = {
+		EOS_SESSIONDETAILS_COPYINFO_API_LATEST
+	};
+	eosResult = EOS_SessionDetails_CopyInfo(sessionDetailsHandle, &copyInfoOptions, &eosSessionInfo);
+	if (eosResult != EOS_EResult::EOS_Success)
+	{
+		EOS_SessionDetails_Release(sessionDetailsHandle);
+		Error = FString::Printf(TEXT("[EOS SDK] Couldn't copy session info.\r\n    Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(eosResult)));
+		return false;
+	}
+
+	// The ping is measured once all results are converted
+	OutResult.PingInMs = -1;
+	this->SetSessionDetails(&OutResult.Session, eosSessionInfo);
+	EOS_SessionDetails_Info_Release(eosSessionInfo);
+
+	// The attributes become the settings of the result, so they can be read and filtered like the settings of a local session
+	EOS_SessionDetails_GetSessionAttributeCountOptions attributeCountOptions = {
+		EOS_SESSIONDETAILS_GETSESSIONATTRIBUTECOUNT_API_LATEST
+	};
+	uint32 attributeCount = EOS_SessionDetails_GetSessionAttributeCount(sessionDetailsHandle, &attributeCountOptions);
+	for (uint32 i = 0; i < attributeCount; ++i)
+	{
+		EOS_SessionDetails_CopySessionAttributeByIndexOptions copyAttributeOptions = {
+			EOS_SESSIONDETAILS_COPYSESSIONATTRIBUTEBYINDEX_API_LATEST,
+			i
+		};
+		EOS_SessionDetails_Attribute* attribute = nullptr;
+		if (EOS_SessionDetails_CopySessionAttributeByIndex(sessionDetailsHandle, &copyAttributeOptions, &attribute) == EOS_EResult::EOS_Success)
+		{
+			FName name;
+			FVariantData data;
+			if (attribute->Data && this->Subsystem->SessionAttributeSchema->Unmarshal(*attribute->Data, name, data))
+			{
+				OutResult.Session.SessionSettings.Settings.Add(name, FOnlineSessionSetting(data, EOnlineDataAdvertisementType::ViaOnlineService));
+			}
+			EOS_SessionDetails_Attribute_Release(attribute);
+		}
+	}
+
+	EOS_SessionDetails_Release(sessionDetailsHandle);
+	return true;
+}
+
+void FOnlineSessionEpic::ConvertSessionSearchResults(uint32 SearchId, double SliceEnd)
+{
+	FSessionSearch* search = this->SessionSearches.Find(SearchId);
+	if (!search || !search->bConverting)
+	{
+		return;
+	}
+
+	// Cancelled or timed out while the results were converted
+	if (search->FinishTime != 0)
+	{
+		UE_LOG_ONLINE_SESSION(Verbose, TEXT("Dropping the results of session search %u, it was given up on"), SearchId);
+		EOS_SessionSearch_Release(search->SearchHandle);
+		search->SearchHandle = nullptr;
+		search->bConverting = false;
+		return;
+	}
+
+	// At least one result is converted per slice, so a search always makes progress
+	TSharedRef<FOnlineSessionSearch> searchRef = search->SearchSettings;
+	int32 sliceStart = searchRef->SearchResults.Num();
+	uint32 converted = 0;
+	while (search->NextResult < search->ResultCount && (converted == 0 || SliceEnd == 0 || FPlatformTime::Seconds() < SliceEnd))
+	{
+		FString error;
+		FOnlineSessionSearchResult searchResult;
+		if (this->ConvertSearchResult(search->SearchHandle, search->NextResult, searchResult, error))
+		{
+			searchRef->SearchResults.Add(MoveTemp(searchResult));
+		}
+		else
+		{
+			UE_LOG_ONLINE_SESSION(Warning, TEXT("Error in %s\r\n    Message: %s"), *FString(__FUNCTION__), *error);
+			search->bConversionFailed = true;
+		}
+		search->NextResult += 1;
+		converted += 1;
+	}
+
+	uint32 done = search->NextResult;
+	uint32 total = search->ResultCount;
+	bool bWasSuccessful = !search->bConversionFailed;
+	if (search->Filter)
+	{
+		search->Filter->Filter(searchRef->SearchResults, sliceStart);
+	}
+	if (done == total)
+	{
+		EOS_SessionSearch_Release(search->SearchHandle);
+		search->SearchHandle = nullptr;
+		search->bConverting = false;
+
+		if (search->Filter)
+		{
+			search->Filter->Finish(searchRef->SearchResults, searchRef->MaxSearchResults);
+		}
+	}
+
+	// Listeners may start new searches, the search entry isn't used past this point
+	if (converted > 0 && !search->bBackground)
+	{
+		TriggerOnFindSessionsProgressDelegates(searchRef, static_cast<int32>(done), static_cast<int32>(total));
+	}
+
+	if (done == total)
+	{
+		this->PingSessionSearchResults(SearchId, bWasSuccessful);
+	}
+}
+
+void FOnlineSessionEpic::PingSessionSearchResults(uint32 SearchId, bool bWasSuccessful)
+{
+	FSessionSearch* search = this->SessionSearches.Find(SearchId);
+	if (!search)
+	{
+		return;
+	}
 
-	FString error;
+	TSharedRef<FOnlineSessionSearch> searchRef = search->SearchSettings;
+	FOnlineSessionPingerEpicPtr pinger = this->Subsystem->SessionPinger;
 
-	TTuple<EOS_HSessionSearch, TSharedRef<FOnlineSessionSearch>>* currentSearch = thisPtr->SessionSearches.Find(searchStartTime);
-	if (currentSearch)
+	TArray<TSharedPtr<FInternetAddr>> hosts;
+	hosts.Reserve(searchRef->SearchResults.Num());
+	for (FOnlineSessionSearchResult const& searchResult : searchRef->SearchResults)
 	{
-		EOS_EResult eosResult = Data->ResultCode;
-		if (eosResult == EOS_EResult::EOS_Success)
-		{
-			TSharedRef<FOnlineSessionSearch> searchRef = currentSearch->Value;
-			EOS_HSessionSearch searchHandle = currentSearch->Key;
-			checkf(searchHandle, TEXT("%s called, but the EOS session search handle is invalid"), *FString(__FUNCTION__));
+		TSharedPtr<FOnlineSessionInfoEpic> sessionInfo = StaticCastSharedPtr<FOnlineSessionInfoEpic>(searchResult.Session.SessionInfo);
+		hosts.Add(sessionInfo.IsValid() ? sessionInfo->HostAddr : nullptr);
+	}
 
-			// Get how many results we got
-			EOS_SessionSearch_GetSearchResultCountOptions searchResultCountOptions = {
-				EOS_SESSIONSEARCH_GETSEARCHRESULTCOUNT_API_LATEST
-			};
-			uint32 resultCount = EOS_SessionSearch_GetSearchResultCount(searchHandle, &searchResultCountOptions);
+	// The search completes once the hosts answered, with the results sorted by their ping unless they're ordered by a Near parameter
+	bool bSortByPing = pinger && pinger->ShouldSortByPing() && !HasNearParameter(*searchRef);
+	if (hosts.Num() > 0 && pinger && pinger->Ping(hosts, [this, SearchId, searchRef, bWasSuccessful, bSort = bSortByPing](TArray<int32> const& PingsInMs)
+		{
+			FSessionSearch* search = this->SessionSearches.Find(SearchId);
+			if (!search || search->FinishTime != 0)
+			{
+				return;
+			}
 
-			if (resultCount > 0)
+			// The caller may have changed the results in the meantime
+			if (searchRef->SearchResults.Num() == PingsInMs.Num())
 			{
-				for (uint32 i = 0; i < resultCount; ++i)
+				for (int32 i = 0; i < PingsInMs.Num(); ++i)
 				{
-					EOS_SessionSearch_CopySearchResultByIndexOptions copySearchResultsByIndex = {
-						EOS_SESSIONSEARCH_COPYSEARCHRESULTBYINDEX_API_LATEST,
-						i
-					};
-					EOS_HSessionDetails sessionDetailsHandle;
-					eosResult = EOS_SessionSearch_CopySearchResultByIndex(searchHandle, &copySearchResultsByIndex, &sessionDetailsHandle);
-					if (eosResult == EOS_EResult::EOS_Success)
-					{
-						// Allocate space for the session infos
-						EOS_SessionDetails_Info* eosSessionInfo = new EOS_SessionDetails_Info();
-
-						// Copy the session details
-						EOS_SessionDetails_CopyInfoOptions copyInfoOptions = {
-							EOS_SESSIONDETAILS_COPYINFO_API_LATEST
-						};
-						eosResult = EOS_SessionDetails_CopyInfo(sessionDetailsHandle, &copyInfoOptions, &eosSessionInfo);
-						if (eosResult == EOS_EResult::EOS_Success)
-						{
-							// Create a new search result.
-							// Ping is set to -1, as we have no way of retrieving it for now
-							FOnlineSessionSearchResult searchResult;
-							searchResult.PingInMs = -1;
-
-							// Take the session from the search results and update its details
-							thisPtr->SetSessionDetails(&searchResult.Session, eosSessionInfo);
-
-							// Add the session to the list of search results.
-							searchRef->SearchResults.Add(searchResult);
-						}
-						else
+					searchRef->SearchResults[i].PingInMs = PingsInMs[i];
+				}
+				if (bSort)
+				{
+					searchRef->SearchResults.StableSort([](FOnlineSessionSearchResult const& A, FOnlineSessionSearchResult const& B)
 						{
-							error = FString::Printf(TEXT("[EOS SDK] Couldn't copy session info.\r\n    Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
-						}
-
-						// Release the prevously allocated memory for the session info;
-						EOS_SessionDetails_Info_Release(eosSessionInfo);
-					}
-					else
-					{
-						error = FString::Printf(TEXT("[EOS SDK] Couldn't get session details handle.\r\n    Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
-					}
+							return A.PingInMs < B.PingInMs;
+						});
 				}
 			}
-			else
-			{
-				UE_LOG_ONLINE_SESSION(Display, TEXT("No sessions found"));
-			}
 
-			EOS_SessionSearch_Release(searchHandle);
-			searchRef->SearchState = EOnlineAsyncTaskState::Done;
-		}
-		else
-		{
-			error = FString::Printf(TEXT("[EOS SDK] Couldn't find session. Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
-		}
-	}
-	else
+			UE_LOG_ONLINE_SESSION(Display, TEXT("Finished session search %u"), SearchId);
+			this->FinishSessionSearch(SearchId, bWasSuccessful);
+		}))
 	{
-		error = TEXT("Session search completed, but session not in session search list!");
+		return;
 	}
 
-	UE_CLOG_ONLINE_SESSION(!error.IsEmpty(), Warning, TEXT("Error in %s\r\n    Message: %s"), *FString(__FUNCTION__), *error);
-	UE_CLOG_ONLINE_SESSION(error.IsEmpty(), Display, TEXT("Finished session search with start time %f"), searchStartTime);
-	thisPtr->TriggerOnFindSessionsCompleteDelegates(error.IsEmpty());
+	UE_LOG_ONLINE_SESSION(Display, TEXT("Finished session search %u"), SearchId);
+	this->FinishSessionSearch(SearchId, bWasSuccessful);
 }
 
 void FOnlineSessionEpic::OnEOSJoinSessionComplete(const EOS_Sessions_JoinSessionCallbackInfo* Data)
@@ -1016,6 +1229,23 @@ void FOnlineSessionEpic::OnEOSJoinSessionComplete(const EOS_Sessions_JoinSession
 
 	FName sessionName = additionalData->SessionName;
 
+	// Transient failures reissue the join with the same additional data
+	if (thisPtr->Subsystem->RetryPolicy->ScheduleRetry(EEpicOperation::Session, Data->ResultCode, additionalData->Attempt, [additionalData]()
+		{
+			additionalData->Attempt += 1;
+			additionalData->OnlineSessionPtr->IssueJoinSession(additionalData);
+		}, [additionalData]()
+		{
+			// Dropped on shutdown, the join completes as failed
+			EOS_Sessions_JoinSessionCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = additionalData;
+			OnEOSJoinSessionComplete(&info);
+		}))
+	{
+		return;
+	}
+
 	delete(additionalData);
 
 	if (Data->ResultCode != EOS_EResult::EOS_Success)
@@ -1046,7 +1276,7 @@ void FOnlineSessionEpic::OnEOSFindFriendSessionComplete(const EOS_SessionSearch_
 	FOnlineSessionEpic* thisPtr = additionalData->OnlineSessionPtr;
 	checkf(thisPtr, TEXT("%s called, but \"this\" missing from ClientData"), *FString(__FUNCTION__));
 
-	double searchCreationTime = additionalData->SearchCreationTime;
+	uint32 searchId = additionalData->SearchId;
 
 	FUniqueNetId const& searchingUserId = additionalData->SearchingUserId;
 
@@ -1060,10 +1290,10 @@ void FOnlineSessionEpic::OnEOSFindFriendSessionComplete(const EOS_SessionSearch_
 	if (eosResult == EOS_EResult::EOS_Success)
 	{
 		// Retrieve the EOS session search handle and the local session search, into which we're going to write the results.
-		EOS_HSessionSearch sessionSearchHandle = thisPtr->SessionSearches.Find(searchCreationTime)->Key;
+		EOS_HSessionSearch sessionSearchHandle = thisPtr->SessionSearches.Find(searchId)->SearchHandle;
 		checkf(sessionSearchHandle, TEXT("%s called, but the EOS session search handle is invalid"), *FString(__FUNCTION__));
 
-		TSharedRef<FOnlineSessionSearch> localSessionSearch = thisPtr->SessionSearches.Find(searchCreationTime)->Value;
+		TSharedRef<FOnlineSessionSearch> localSessionSearch = thisPtr->SessionSearches.Find(searchId)->SearchSettings;
 
 		// Get how many results we got
 		EOS_SessionSearch_GetSearchResultCountOptions searchResultCountOptions = {
@@ -1072,48 +1302,13 @@ void FOnlineSessionEpic::OnEOSFindFriendSessionComplete(const EOS_SessionSearch_
 		uint32 resultCount = EOS_SessionSearch_GetSearchResultCount(sessionSearchHandle, &searchResultCountOptions);
 		if (resultCount > 0)
 		{
+			// Friends only have a few sessions, they are converted in one go
 			for (uint32 i = 0; i < resultCount; ++i)
 			{
-				EOS_SessionSearch_CopySearchResultByIndexOptions copySearchResultsByIndex = {
-					EOS_SESSIONSEARCH_COPYSEARCHRESULTBYINDEX_API_LATEST,
-					i
-				};
-				EOS_HSessionDetails sessionDetailsHandle;
-				eosResult = EOS_SessionSearch_CopySearchResultByIndex(sessionSearchHandle, &copySearchResultsByIndex, &sessionDetailsHandle);
-				if (eosResult == EOS_EResult::EOS_Success)
-				{
-					// Allocate space for the session infos
-					EOS_SessionDetails_Info* eosSessionInfo = (EOS_SessionDetails_Info*)malloc(sizeof(EOS_SessionDetails_Info));
-
-					// Copy the session details
-					EOS_SessionDetails_CopyInfoOptions copyInfoOptions = {
-						EOS_SESSIONDETAILS_COPYINFO_API_LATEST
-					};
-					eosResult = EOS_SessionDetails_CopyInfo(sessionDetailsHandle, &copyInfoOptions, &eosSessionInfo);
-					if (eosResult == EOS_EResult::EOS_Success)
-					{
-						// Create a new search result.
-						// Ping is set to -1, as we have no way of retrieving it for now
-						FOnlineSessionSearchResult searchResult;
-						searchResult.PingInMs = -1;
-
-						// Take the session from the search results and update its details
-						thisPtr->SetSessionDetails(&searchResult.Session, eosSessionInfo);
-
-						// Add the session to the list of search results.
-						searchResults.Add(searchResult);
-					}
-					else
-					{
-						error = FString::Printf(TEXT("[EOS SDK] Couldn't copy session info.\r\n    Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
-					}
-
-					// Release the prevously allocated memory for the session info;
-					EOS_SessionDetails_Info_Release(eosSessionInfo);
-				}
-				else
+				FOnlineSessionSearchResult searchResult;
+				if (thisPtr->ConvertSearchResult(sessionSearchHandle, i, searchResult, error))
 				{
-					error = FString::Printf(TEXT("[EOS SDK] Couldn't get session details handle.\r\n    Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+					searchResults.Add(MoveTemp(searchResult));
 				}
 			}
 
@@ -1132,6 +1327,15 @@ void FOnlineSessionEpic::OnEOSFindFriendSessionComplete(const EOS_SessionSearch_
 	// Report an error if there was any
 	UE_CLOG_ONLINE_SESSION(!error.IsEmpty(), Warning, TEXT("%s"), *error);
 
+	// The search is done, only its results are kept for a while
+	if (FSessionSearch* search = thisPtr->SessionSearches.Find(searchId))
+	{
+		EOS_SessionSearch_Release(search->SearchHandle);
+		search->SearchHandle = nullptr;
+		search->FinishTime = FPlatformTime::Seconds();
+		search->SearchSettings->SearchState = error.IsEmpty() ? EOnlineAsyncTaskState::Done : EOnlineAsyncTaskState::Failed;
+	}
+
 	// Get the local index of the user that started the search
 	IOnlineIdentityPtr identityPtr = thisPtr->Subsystem->GetIdentityInterface();
 	FPlatformUserId userIdx = identityPtr->GetPlatformUserIdFromUniqueNetId(searchingUserId);
@@ -1177,6 +1381,14 @@ void FOnlineSessionEpic::OnEOSRegisterPlayersComplete(const EOS_Sessions_Registe
 		return;
 	}
 
+	// The players stay registered locally, the backend learns about them once the connection is back
+	if (thisPtr->Subsystem->WriteJournal->NoteResult(Data->ResultCode))
+	{
+		thisPtr->DeferRegisterPlayers(sessionName, registeredPlayers);
+		thisPtr->TriggerOnRegisterPlayersCompleteDelegates(sessionName, registeredPlayers, true);
+		return;
+	}
+
 	if (Data->ResultCode != EOS_EResult::EOS_Success)
 	{
 		for (int32 i = 0; i < registeredPlayers.Num(); ++i)
@@ -1195,6 +1407,7 @@ void FOnlineSessionEpic::OnEOSRegisterPlayersComplete(const EOS_Sessions_Registe
 		}
 
 		UE_LOG_ONLINE_SESSION(Warning, TEXT("[EOS SDK] Couldn't find session.\r\n    Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+		thisPtr->PublishSessionSnapshot();
 		thisPtr->TriggerOnRegisterPlayersCompleteDelegates(sessionName, TArray<TSharedRef<const FUniqueNetId>>(), false);
 		return;
 	}
@@ -1242,6 +1455,7 @@ void FOnlineSessionEpic::OnEOSUnRegisterPlayersComplete(const EOS_Sessions_Unreg
 		}
 
 		UE_LOG_ONLINE_SESSION(Warning, TEXT("[EOS SDK] Couldn't find session.\r\n    Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Data->ResultCode)));
+		thisPtr->PublishSessionSnapshot();
 		thisPtr->TriggerOnUnregisterPlayersCompleteDelegates(sessionName, TArray<TSharedRef<const FUniqueNetId>>(), false);
 		return;
 	}
@@ -1373,7 +1587,30 @@ void FOnlineSessionEpic::OnEOSSessionInviteAccepted(const EOS_Sessions_SessionIn
 
 FOnlineSessionEpic::FOnlineSessionEpic(FOnlineSubsystemEpic* InSubsystem)
 	: Subsystem(InSubsystem)
-{
+	, SessionUpdateFlushWindow(0.1f)
+	, NextSessionUpdateBatch(0)
+	, NextSessionSearchId(0)
+	, NextMultiSessionSearchId(1)
+	, SessionSearchTimeout(30.f)
+	, SessionSearchCacheTTL(0.f)
+	, SearchResultFrameBudget(2.f)
+	, SearchFilterOverfetch(4)
+	, bHasPresenceSession(false)
+	, SessionSnapshot(new FSessionStateSnapshot())
+	, SnapshotEpoch(0)
+	, SnapshotFlips(0)
+{
+	this->SnapshotReaders[0] = 0;
+	this->SnapshotReaders[1] = 0;
+
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("SessionUpdateFlushWindow"), this->SessionUpdateFlushWindow, GEngineIni);
+	this->SessionUpdateFlushWindow = FMath::Max(0.f, this->SessionUpdateFlushWindow);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("SessionSearchTimeout"), this->SessionSearchTimeout, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("SessionSearchCacheTTL"), this->SessionSearchCacheTTL, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("SearchResultFrameBudget"), this->SearchResultFrameBudget, GEngineIni);
+	GConfig->GetInt(TEXT("OnlineSubsystemEpic"), TEXT("SearchFilterOverfetch"), this->SearchFilterOverfetch, GEngineIni);
+	this->SearchFilterOverfetch = FMath::Max(1, this->SearchFilterOverfetch);
+
 	// Get the sessions handle
 	EOS_HPlatform hPlatform = this->Subsystem->PlatformHandle;
 	check(hPlatform);
@@ -1396,6 +1633,19 @@ FOnlineSessionEpic::FOnlineSessionEpic(FOnlineSubsystemEpic* InSubsystem)
 
 FOnlineSessionEpic::~FOnlineSessionEpic()
 {
+	delete this->SessionSnapshot.Load();
+	for (TPair<FSessionStateSnapshot const*, uint64> const& retired : this->RetiredSnapshots)
+	{
+		delete retired.Key;
+	}
+	for (TPair<uint32, FSessionSearch> const& search : this->SessionSearches)
+	{
+		if (search.Value.SearchHandle)
+		{
+			EOS_SessionSearch_Release(search.Value.SearchHandle);
+		}
+	}
+
 	EOS_Sessions_RemoveNotifySessionInviteReceived(this->sessionsHandle, this->sessionInviteRecivedCallbackHandle);
 	EOS_Sessions_RemoveNotifySessionInviteAccepted(this->sessionsHandle, this->sessionInviteAcceptedCallbackHandle);
 }
@@ -1403,38 +1653,48 @@ FOnlineSessionEpic::~FOnlineSessionEpic()
 FNamedOnlineSession* FOnlineSessionEpic::GetNamedSession(FName SessionName)
 {
 	FScopeLock ScopeLock(&SessionLock);
-	for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
+	if (int32 const* slot = this->SessionSlotByName.Find(SessionName))
 	{
-		if (Sessions[SearchIndex].SessionName == SessionName)
-		{
-			return &Sessions[SearchIndex];
-		}
+		return this->SessionSlots[*slot].Get();
 	}
 	return nullptr;
 }
 
 void FOnlineSessionEpic::RemoveNamedSession(FName SessionName)
 {
-	FScopeLock ScopeLock(&SessionLock);
-	for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
 	{
-		if (Sessions[SearchIndex].SessionName == SessionName)
+		FScopeLock ScopeLock(&SessionLock);
+		int32 slot = INDEX_NONE;
+		if (!this->SessionSlotByName.RemoveAndCopyValue(SessionName, slot))
 		{
-			Sessions.RemoveAtSwap(SearchIndex);
 			return;
 		}
+		this->SessionSlots[slot].Reset();
+		this->FreeSessionSlots.Add(slot);
+		this->PublishSessionSnapshot();
+	}
+	this->RefreshPresenceSessionFlag();
+
+	// Journaled writes of a session that is gone can't be sent anymore
+	this->Subsystem->WriteJournal->Discard(FString::Printf(TEXT("UpdateSession:%s"), *SessionName.ToString()));
+	this->Subsystem->WriteJournal->Discard(FString::Printf(TEXT("RegisterPlayers:%s"), *SessionName.ToString()));
+	this->DeferredRegistrations.Remove(SessionName);
+	this->SentSessionSettings.Remove(SessionName);
+
+	// Callers waiting for an update that won't be sent anymore fail
+	FPendingSessionUpdate pending;
+	if (this->PendingSessionUpdates.RemoveAndCopyValue(SessionName, pending))
+	{
+		this->SessionUpdateCoalescer.Complete(MakeTuple(SessionName, pending.Batch), false);
 	}
 }
 
 EOnlineSessionState::Type FOnlineSessionEpic::GetSessionState(FName SessionName) const
 {
-	FScopeLock ScopeLock(&SessionLock);
-	for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
+	FSnapshotReadScope snapshot(*this);
+	if (FSessionStateSnapshot::FEntry const* entry = snapshot->Sessions.Find(SessionName))
 	{
-		if (Sessions[SearchIndex].SessionName == SessionName)
-		{
-			return Sessions[SearchIndex].SessionState;
-		}
+		return entry->State;
 	}
 
 	return EOnlineSessionState::NoSession;
@@ -1443,20 +1703,175 @@ EOnlineSessionState::Type FOnlineSessionEpic::GetSessionState(FName SessionName)
 bool FOnlineSessionEpic::HasPresenceSession()
 {
 	FScopeLock ScopeLock(&SessionLock);
-	for (int32 SearchIndex = 0; SearchIndex < Sessions.Num(); SearchIndex++)
+	return this->bHasPresenceSession;
+}
+
+FNamedOnlineSession* FOnlineSessionEpic::AddSessionToSlot(TUniquePtr<FNamedOnlineSession>&& Session)
+{
+	FName sessionName = Session->SessionName;
+	bool bUsesPresence = Session->SessionSettings.bUsesPresence;
+
+	// A session with the same name is replaced
+	int32 slot = INDEX_NONE;
+	if (int32 const* existingSlot = this->SessionSlotByName.Find(sessionName))
+	{
+		UE_LOG_ONLINE_SESSION(Warning, TEXT("Replacing local session \"%s\""), *sessionName.ToString());
+		slot = *existingSlot;
+	}
+	else if (this->FreeSessionSlots.Num() > 0)
+	{
+		slot = this->FreeSessionSlots.Pop(false);
+	}
+	else
+	{
+		slot = this->SessionSlots.AddDefaulted();
+	}
+
+	this->SessionSlots[slot] = MoveTemp(Session);
+	this->SessionSlotByName.Add(sessionName, slot);
+	this->bHasPresenceSession |= bUsesPresence;
+	this->PublishSessionSnapshot();
+
+	return this->SessionSlots[slot].Get();
+}
+
+void FOnlineSessionEpic::RefreshPresenceSessionFlag()
+{
+	FScopeLock ScopeLock(&SessionLock);
+	this->bHasPresenceSession = false;
+	for (TPair<FName, int32> const& entry : this->SessionSlotByName)
 	{
-		if (Sessions[SearchIndex].SessionSettings.bUsesPresence)
+		if (this->SessionSlots[entry.Value]->SessionSettings.bUsesPresence)
 		{
-			return true;
+			this->bHasPresenceSession = true;
+			break;
 		}
 	}
-
-	return false;
 }
 
 void FOnlineSessionEpic::Tick(float DeltaTime)
 {
-	// ToDo: Iterate through all session searches and cancel them if timeout has been reached
+	double now = FPlatformTime::Seconds();
+
+	// Fail the searches the backend didn't answer in time, and drop finished ones once their results are old
+	if (this->SessionSearches.Num() > 0)
+	{
+		TArray<uint32> timedOut;
+		for (auto it = this->SessionSearches.CreateIterator(); it; ++it)
+		{
+			FSessionSearch const& search = it.Value();
+			if (search.FinishTime == 0)
+			{
+				if (search.Deadline > 0 && now >= search.Deadline)
+				{
+					timedOut.Add(it.Key());
+				}
+			}
+			else if (!search.SearchHandle && now - search.FinishTime >= FinishedSearchRetention)
+			{
+				it.RemoveCurrent();
+			}
+		}
+		for (uint32 searchId : timedOut)
+		{
+			UE_LOG_ONLINE_SESSION(Warning, TEXT("Session search %u timed out"), searchId);
+			this->FinishSessionSearch(searchId, false);
+		}
+	}
+
+	// Convert the next slice of search results. All searches share the budget of the frame.
+	if (this->SessionSearches.Num() > 0)
+	{
+		TArray<uint32> converting;
+		for (TPair<uint32, FSessionSearch> const& search : this->SessionSearches)
+		{
+			if (search.Value.bConverting)
+			{
+				converting.Add(search.Key);
+			}
+		}
+
+		double sliceEnd = this->GetSearchResultSliceEnd(now);
+		for (uint32 searchId : converting)
+		{
+			if (sliceEnd > 0 && FPlatformTime::Seconds() >= sliceEnd)
+			{
+				break;
+			}
+			this->ConvertSessionSearchResults(searchId, sliceEnd);
+		}
+	}
+
+	// Cached results are served stale for another TTL, after that they are dropped
+	for (auto it = this->SessionSearchCache.CreateIterator(); it; ++it)
+	{
+		if (!it.Value().bRefreshing && now - it.Value().Time >= 2 * this->SessionSearchCacheTTL)
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	// Send the updates whose flush window ended
+	if (this->PendingSessionUpdates.Num() > 0)
+	{
+		TArray<FName> due;
+		for (TPair<FName, FPendingSessionUpdate> const& pending : this->PendingSessionUpdates)
+		{
+			if (pending.Value.FlushTime <= now)
+			{
+				due.Add(pending.Key);
+			}
+		}
+		for (FName const& sessionName : due)
+		{
+			this->FlushSessionUpdate(sessionName);
+		}
+	}
+
+	// Free the snapshots no reader can be looking at anymore, see SnapshotReaders.
+	// Readers of the previous epoch might have loaded any snapshot replaced before the last flip.
+	// Readers that count themselves from now on load the current snapshot.
+	FScopeLock ScopeLock(&SessionLock);
+	uint32 previousEpoch = 1 - this->SnapshotEpoch.Load();
+	if (this->RetiredSnapshots.Num() > 0 && this->SnapshotReaders[previousEpoch].Load() == 0)
+	{
+		int32 freed = 0;
+		while (freed < this->RetiredSnapshots.Num() && this->RetiredSnapshots[freed].Value < this->SnapshotFlips)
+		{
+			delete this->RetiredSnapshots[freed].Key;
+			freed += 1;
+		}
+		this->RetiredSnapshots.RemoveAt(0, freed, false);
+
+		// The snapshots replaced since the last flip wait for the readers of the current epoch
+		if (this->RetiredSnapshots.Num() > 0)
+		{
+			this->SnapshotEpoch.Store(previousEpoch);
+			this->SnapshotFlips += 1;
+		}
+	}
+}
+
+void FOnlineSessionEpic::PublishSessionSnapshot()
+{
+	FScopeLock ScopeLock(&SessionLock);
+
+	FSessionStateSnapshot* snapshot = new FSessionStateSnapshot();
+	snapshot->Sessions.Reserve(this->SessionSlotByName.Num());
+	for (TPair<FName, int32> const& slot : this->SessionSlotByName)
+	{
+		FNamedOnlineSession const& session = *this->SessionSlots[slot.Value];
+		FSessionStateSnapshot::FEntry& entry = snapshot->Sessions.Add(slot.Key);
+		entry.State = session.SessionState;
+		for (TSharedRef<const FUniqueNetId> const& player : session.RegisteredPlayers)
+		{
+			entry.RegisteredPlayers.Add(FSessionStateSnapshot::MakePlayerKey(*player));
+		}
+	}
+
+	// Readers might still use the old snapshot, it is freed once they are done with it
+	FSessionStateSnapshot const* retired = this->SessionSnapshot.Exchange(snapshot);
+	this->RetiredSnapshots.Emplace(retired, this->SnapshotFlips);
 }
 
 TSharedPtr<const FUniqueNetId> FOnlineSessionEpic::CreateSessionIdFromString(const FString& SessionIdStr)
@@ -1495,6 +1910,7 @@ bool FOnlineSessionEpic::CreateSession(const FUniqueNetId& HostingPlayerId, FNam
 			checkf(Session, TEXT("Failed to create new named session"));
 
 			Session->SessionState = EOnlineSessionState::Creating;
+			this->PublishSessionSnapshot();
 			Session->NumOpenPrivateConnections = NewSessionSettings.NumPrivateConnections;
 			Session->NumOpenPublicConnections = NewSessionSettings.NumPublicConnections;
 
@@ -1537,26 +1953,24 @@ bool FOnlineSessionEpic::CreateSession(const FUniqueNetId& HostingPlayerId, FNam
 			EOS_EResult eosResult = EOS_Sessions_CreateSessionModification(this->sessionsHandle, &createSessionOptions, &modificationHandle);
 			if (eosResult == EOS_EResult::EOS_Success)
 			{
-				this->CreateSessionModificationHandle(NewSessionSettings, modificationHandle, Err);
+				this->CreateSessionModificationHandle(NewSessionSettings, nullptr, modificationHandle, Err);
 				if (Err.IsEmpty())
 				{
 					// Update the remote session
-					EOS_Sessions_UpdateSessionOptions updateSessionOptions = {
-						EOS_SESSIONS_UPDATESESSION_API_LATEST,
-						modificationHandle
-					};
 					FCreateSessionAdditionalData* addionalData = new FCreateSessionAdditionalData {
 						this,
-						HostingPlayerId.AsShared()
+						HostingPlayerId.AsShared(),
+						NewSessionSettings
 					};
-					EOS_Sessions_UpdateSession(this->sessionsHandle, &updateSessionOptions, addionalData, &FOnlineSessionEpic::OnEOSCreateSessionComplete);
+					// The update releases the handle once it was sent
+					this->IssueUpdateSession(SessionName, modificationHandle, addionalData, &FOnlineSessionEpic::OnEOSCreateSessionComplete);
 
 					// Mark the creation operation as pending
 					Result = ONLINE_IO_PENDING;
 				}
 				else
 				{
-					// We failed to create a new session, remove it from the local list
+					// We failed to create a new session, remove it from the local list. The handle was released with the error
 					this->RemoveNamedSession(SessionName);
 				}
 			}
@@ -1568,9 +1982,6 @@ bool FOnlineSessionEpic::CreateSession(const FUniqueNetId& HostingPlayerId, FNam
 				// We failed to create a new session, remove it from the local list
 				this->RemoveNamedSession(SessionName);
 			}
-
-			// No matter the update result, release the memory for the SessionModification handle
-			EOS_SessionModification_Release(modificationHandle);
 		}
 	}
 
@@ -1597,18 +2008,13 @@ bool FOnlineSessionEpic::StartSession(FName SessionName)
 		{
 			sessionState = EOnlineSessionState::Starting;
 
-			EOS_Sessions_StartSessionOptions startSessionOpts = {
-				EOS_SESSIONS_STARTSESSION_API_LATEST,
-				TCHAR_TO_UTF8(*SessionName.ToString())
-			};
-
 			// Allocate struct for additional information, 
 			//as the callback doesn't expose the session that was started
 			FSessionStateChangeAdditionalData* additionalInfo = new FSessionStateChangeAdditionalData{
 				this,
 				SessionName
 			};
-			EOS_Sessions_StartSession(this->sessionsHandle, &startSessionOpts, additionalInfo, &FOnlineSessionEpic::OnEOSStartSessionComplete);
+			this->IssueStartSession(additionalInfo);
 			resultCode = ONLINE_IO_PENDING;
 		}
 		else
@@ -1627,7 +2033,7 @@ bool FOnlineSessionEpic::StartSession(FName SessionName)
 		{
 			UE_LOG_ONLINE_SESSION(Warning, TEXT("%s"), *error);
 		}
-		TriggerOnCreateSessionCompleteDelegates(SessionName, (resultCode == ONLINE_SUCCESS) ? true : false);
+		TriggerOnStartSessionCompleteDelegates(SessionName, (resultCode == ONLINE_SUCCESS) ? true : false);
 	}
 
 	return resultCode == ONLINE_IO_PENDING || resultCode == ONLINE_SUCCESS;
@@ -1641,52 +2047,41 @@ bool FOnlineSessionEpic::UpdateSession(FName SessionName, FOnlineSessionSettings
 	if (FNamedOnlineSession* session = this->GetNamedSession(SessionName))
 	{
 		// Make a copy of the old settings
-		FOnlineSessionSettings oldSettings = FOnlineSessionSettings();
+		FOnlineSessionSettings oldSettings = session->SessionSettings;
 
 		// Update the local session with the new settings 
 		session->SessionSettings = UpdatedSessionSettings;
+		this->RefreshPresenceSessionFlag();
 
 		// Only do work if the online data should be refreshed
-		if (bShouldRefreshOnlineData)
+		if (bShouldRefreshOnlineData && this->ShouldDeferWrite(*session))
 		{
-			EOS_HSessionModification sessionModificationHandle = {};
-			this->CreateSessionModificationHandle(UpdatedSessionSettings, sessionModificationHandle, err);
-			if (err.IsEmpty())
+			// Sent once the owner is back online
+			this->DeferUpdateSession(SessionName);
+			result = ONLINE_SUCCESS;
+		}
+		else if (bShouldRefreshOnlineData)
+		{
+			// Calls within the flush window are sent as one update, every caller completes with its result
+			FPendingSessionUpdate* pending = this->PendingSessionUpdates.Find(SessionName);
+			if (!pending)
 			{
-				// Modify the local session with the modified session options
-				EOS_Sessions_UpdateSessionModificationOptions sessionModificationOptions =
-				{
-					EOS_SESSIONS_UPDATESESSIONMODIFICATION_API_LATEST,
-					TCHAR_TO_UTF8(*SessionName.ToString())
-				};
-				EOS_EResult eosResult = EOS_Sessions_UpdateSessionModification(this->sessionsHandle, &sessionModificationOptions, &sessionModificationHandle);
-				if (eosResult == EOS_EResult::EOS_Success)
+				pending = &this->PendingSessionUpdates.Add(SessionName, FPendingSessionUpdate{
+					FPlatformTime::Seconds() + this->SessionUpdateFlushWindow,
+					oldSettings,
+					this->NextSessionUpdateBatch++
+				});
+			}
+			this->SessionUpdateCoalescer.Join(MakeTuple(SessionName, pending->Batch), [this, SessionName](bool const& bWasSuccessful)
 				{
-					// Update the remote session
-					EOS_Sessions_UpdateSessionOptions updateSessionOptions = {};
-					updateSessionOptions.ApiVersion = EOS_SESSIONS_UPDATESESSION_API_LATEST;
-					updateSessionOptions.SessionModificationHandle = sessionModificationHandle;
-
-					FUpdateSessionAdditionalData* additionalInfo = new FUpdateSessionAdditionalData{
-						this,
-						oldSettings
-					};
-
-					EOS_Sessions_UpdateSession(this->sessionsHandle, &updateSessionOptions, additionalInfo, &FOnlineSessionEpic::OnEOSCreateSessionComplete);
-					result = ONLINE_IO_PENDING;
+					this->TriggerOnUpdateSessionCompleteDelegates(SessionName, bWasSuccessful);
+				});
 
-					EOS_SessionModification_Release(sessionModificationHandle);
-				}
-				else
-				{
-					char const* resultStr = EOS_EResult_ToString(eosResult);
-					err = FString::Printf(TEXT("[EOS SDK] Error modifying session options - Error Code: %s"), resultStr);
-				}
-			}
-			else
+			if (this->SessionUpdateFlushWindow <= 0.f)
 			{
-				err = FString::Printf(TEXT("[EOS SDK] Error creating session modification - Error Code: %s"), *err);
+				this->FlushSessionUpdate(SessionName);
 			}
+			result = ONLINE_IO_PENDING;
 		}
 		else
 		{
@@ -1707,11 +2102,76 @@ bool FOnlineSessionEpic::UpdateSession(FName SessionName, FOnlineSessionSettings
 				UE_LOG_ONLINE_SESSION(Warning, TEXT("%s"), *err);
 			}
 		}
-		TriggerOnCreateSessionCompleteDelegates(SessionName, (result == ONLINE_SUCCESS) ? true : false);
+		TriggerOnUpdateSessionCompleteDelegates(SessionName, (result == ONLINE_SUCCESS) ? true : false);
 	}
 	return result == ONLINE_IO_PENDING || result == ONLINE_SUCCESS;
 }
 
+void FOnlineSessionEpic::FlushSessionUpdate(FName SessionName)
+{
+	FPendingSessionUpdate pending;
+	if (!this->PendingSessionUpdates.RemoveAndCopyValue(SessionName, pending))
+	{
+		return;
+	}
+
+	TPair<FName, uint32> batchKey = MakeTuple(SessionName, pending.Batch);
+	FNamedOnlineSession* session = this->GetNamedSession(SessionName);
+	if (!session)
+	{
+		this->SessionUpdateCoalescer.Complete(batchKey, false);
+		return;
+	}
+
+	// Create a modification handle for the existing session
+	FString err;
+	EOS_HSessionModification sessionModificationHandle = nullptr;
+	FTCHARToUTF8 sessionNameUtf8(*SessionName.ToString());
+	EOS_Sessions_UpdateSessionModificationOptions sessionModificationOptions =
+	{
+		EOS_SESSIONS_UPDATESESSIONMODIFICATION_API_LATEST,
+		sessionNameUtf8.Get()
+	};
+	EOS_EResult eosResult = EOS_Sessions_UpdateSessionModification(this->sessionsHandle, &sessionModificationOptions, &sessionModificationHandle);
+	if (eosResult == EOS_EResult::EOS_Success)
+	{
+		// Only send what changed since the last update the backend accepted
+		int32 numChanges = this->CreateSessionModificationHandle(session->SessionSettings, this->SentSessionSettings.Find(SessionName), sessionModificationHandle, err);
+		if (!err.IsEmpty())
+		{
+			err = FString::Printf(TEXT("[EOS SDK] Error creating session modification - Error Code: %s"), *err);
+		}
+		else if (numChanges == 0)
+		{
+			UE_LOG_ONLINE_SESSION(Verbose, TEXT("Settings of session \"%s\" didn't change, skipping the update"), *SessionName.ToString());
+			EOS_SessionModification_Release(sessionModificationHandle);
+			this->SessionUpdateCoalescer.Complete(batchKey, true);
+			return;
+		}
+		else
+		{
+			// Update the remote session
+			FUpdateSessionAdditionalData* additionalInfo = new FUpdateSessionAdditionalData{
+				this,
+				pending.OldSessionSettings,
+				session->SessionSettings,
+				pending.Batch
+			};
+
+			this->IssueUpdateSession(SessionName, sessionModificationHandle, additionalInfo, &FOnlineSessionEpic::OnEOSUpdateSessionComplete);
+			return;
+		}
+	}
+	else
+	{
+		char const* resultStr = EOS_EResult_ToString(eosResult);
+		err = FString::Printf(TEXT("[EOS SDK] Error modifying session options - Error Code: %s"), UTF8_TO_TCHAR(resultStr));
+	}
+
+	UE_LOG_ONLINE_SESSION(Warning, TEXT("%s"), *err);
+	this->SessionUpdateCoalescer.Complete(batchKey, false);
+}
+
 bool FOnlineSessionEpic::EndSession(FName SessionName)
 {
 	FString error;
@@ -1723,16 +2183,13 @@ bool FOnlineSessionEpic::EndSession(FName SessionName)
 		if (sessionState == EOnlineSessionState::InProgress)
 		{
 			session->SessionState = EOnlineSessionState::Ending;
+			this->PublishSessionSnapshot();
 
-			EOS_Sessions_EndSessionOptions endSessionOptions = {
-				EOS_SESSIONS_ENDSESSION_API_LATEST,
-				TCHAR_TO_UTF8(*SessionName.ToString())
-			};
 			FSessionStateChangeAdditionalData* additionalInfo = new FSessionStateChangeAdditionalData{
 				this,
 				SessionName
 			};
-			EOS_Sessions_EndSession(this->sessionsHandle, &endSessionOptions, additionalInfo, &FOnlineSessionEpic::OnEOSEndSessionComplete);
+			this->IssueEndSession(additionalInfo);
 
 			resultCode = ONLINE_IO_PENDING;
 		}
@@ -1755,7 +2212,7 @@ bool FOnlineSessionEpic::EndSession(FName SessionName)
 				UE_LOG_ONLINE_SESSION(Warning, TEXT("%s"), *error);
 			}
 		}
-		TriggerOnCreateSessionCompleteDelegates(SessionName, (resultCode == ONLINE_SUCCESS) ? true : false);
+		TriggerOnEndSessionCompleteDelegates(SessionName, (resultCode == ONLINE_SUCCESS) ? true : false);
 	}
 	return resultCode == ONLINE_IO_PENDING || resultCode == ONLINE_SUCCESS;
 }
@@ -1768,19 +2225,16 @@ bool FOnlineSessionEpic::DestroySession(FName SessionName, const FOnDestroySessi
 	if (FNamedOnlineSession* session = this->GetNamedSession(SessionName))
 	{
 		EOnlineSessionState::Type sessionState = this->GetSessionState(SessionName);
-		if (sessionState == EOnlineSessionState::Destroying)
+		if (sessionState != EOnlineSessionState::Destroying)
 		{
 			session->SessionState = EOnlineSessionState::Destroying;
+			this->PublishSessionSnapshot();
 
 			FSessionStateChangeAdditionalData* additionalInfo = new FSessionStateChangeAdditionalData{
 				this,
 				SessionName
 			};
-			EOS_Sessions_DestroySessionOptions destroySessionOpts = {
-				EOS_SESSIONS_DESTROYSESSION_API_LATEST,
-				TCHAR_TO_UTF8(*SessionName.ToString())
-			};
-			EOS_Sessions_DestroySession(this->sessionsHandle, &destroySessionOpts, additionalInfo, &FOnlineSessionEpic::OnEOSDestroySessionComplete);
+			this->IssueDestroySession(additionalInfo);
 
 			resultCode = ONLINE_IO_PENDING;
 		}
@@ -1803,7 +2257,7 @@ bool FOnlineSessionEpic::DestroySession(FName SessionName, const FOnDestroySessi
 				UE_LOG_ONLINE_SESSION(Warning, TEXT("%s"), *error);
 			}
 		}
-		TriggerOnCreateSessionCompleteDelegates(SessionName, (resultCode == ONLINE_SUCCESS) ? true : false);
+		TriggerOnDestroySessionCompleteDelegates(SessionName, (resultCode == ONLINE_SUCCESS) ? true : false);
 	}
 	return resultCode == ONLINE_IO_PENDING || resultCode == ONLINE_SUCCESS;
 }
@@ -1811,11 +2265,12 @@ bool FOnlineSessionEpic::DestroySession(FName SessionName, const FOnDestroySessi
 bool FOnlineSessionEpic::IsPlayerInSession(FName SessionName, const FUniqueNetId& UniqueId)
 {
 	// Improvement: Maybe call SDK backend?
-	if (FNamedOnlineSession* session = this->GetNamedSession(SessionName))
 	{
-		return session->RegisteredPlayers.ContainsByPredicate([&UniqueId](TSharedRef<const FUniqueNetId> id) {
-			return *id == UniqueId;
-			});
+		FSnapshotReadScope snapshot(*this);
+		if (FSessionStateSnapshot::FEntry const* entry = snapshot->Sessions.Find(SessionName))
+		{
+			return entry->RegisteredPlayers.Contains(FSessionStateSnapshot::MakePlayerKey(UniqueId));
+		}
 	}
 
 	UE_LOG_ONLINE_SESSION(Warning, TEXT("No session with name \"%s\" found"), *SessionName.ToString());
@@ -1852,6 +2307,7 @@ bool FOnlineSessionEpic::FindSessions(const FUniqueNetId& SearchingPlayerId, con
 	FString error;
 	uint32 result = ONLINE_FAIL;
 	SearchSettings->SearchState = EOnlineAsyncTaskState::NotStarted;
+	SearchSettings->SearchResults.Empty();
 
 	FUniqueNetIdEpic const epicNetId = static_cast<FUniqueNetIdEpic>(SearchingPlayerId);
 	if (epicNetId.IsEpicAccountIdValid())
@@ -1862,54 +2318,52 @@ bool FOnlineSessionEpic::FindSessions(const FUniqueNetId& SearchingPlayerId, con
 		}
 		else
 		{
-			EOS_Sessions_CreateSessionSearchOptions sessionSearchOpts = {
-				EOS_SESSIONS_CREATESESSIONSEARCH_API_LATEST,
-				static_cast<uint32_t>(SearchSettings->MaxSearchResults)
-			};
-
-			// Handle where the session search is stored
-			EOS_HSessionSearch sessionSearchHandle = nullptr;
-			EOS_EResult eosResult = EOS_Sessions_CreateSessionSearch(this->sessionsHandle, &sessionSearchOpts, &sessionSearchHandle);
-			if (eosResult == EOS_EResult::EOS_Success)
+			FString cacheKey;
+			FCachedSessionSearch* cached = nullptr;
+			if (this->SessionSearchCacheTTL > 0.f)
 			{
-				UpdateSessionSearchParameters(SearchSettings, sessionSearchHandle, error);
-				if (error.IsEmpty()) // Only proceeded if there was no error
-				{
-					// Locally store the session search so it can be accessed later
-					double searchCreationTime = FDateTime::UtcNow().ToUnixTimestamp();
-
-					// Mark the search as in progress
-					SearchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
-
-					// Create pointer to a local, default session search object so the user can later access it
-					TSharedRef<FOnlineSessionSearch> sessionSearch = MakeShared<FOnlineSessionSearch>();
-
-					// Mark the session as in progress
-					sessionSearch->SearchState = EOnlineAsyncTaskState::InProgress;
-
-					// Store the EOS session search handle and the local session search object
-					TTuple<EOS_HSessionSearch, TSharedRef<FOnlineSessionSearch>> value(sessionSearchHandle, sessionSearch);
-					this->SessionSearches.Add(searchCreationTime, value);
-
+				cacheKey = MakeSessionSearchCacheKey(*SearchSettings);
+				cached = this->SessionSearchCache.Find(cacheKey);
+			}
 
-					EOS_SessionSearch_FindOptions findOptions = {
-						EOS_SESSIONSEARCH_FIND_API_LATEST,
-						epicNetId.ToProductUserId()
-					};
-					FFindSessionsAdditionalData* additionalData = new FFindSessionsAdditionalData{
-						this,
-						searchCreationTime
-					};
-					EOS_SessionSearch_Find(sessionSearchHandle, &findOptions, additionalData, &FOnlineSessionEpic::OnEOSFindSessionComplete);
+			if (cached)
+			{
+				// Cached results are served right away. Stale ones are refreshed in the background for the next search
+				SearchSettings->SearchResults = cached->Results;
+				result = ONLINE_SUCCESS;
 
+				if (FPlatformTime::Seconds() - cached->Time < this->SessionSearchCacheTTL)
+				{
+					this->SessionSearchCacheMetrics.Hits += 1;
+				}
+				else
+				{
+					this->SessionSearchCacheMetrics.StaleHits += 1;
+					if (!cached->bRefreshing)
+					{
+						TSharedRef<FOnlineSessionSearch> refresh = MakeShared<FOnlineSessionSearch>();
+						refresh->QuerySettings = SearchSettings->QuerySettings;
+						refresh->MaxSearchResults = SearchSettings->MaxSearchResults;
 
-					// Mark the operation as pending
-					result = ONLINE_IO_PENDING;
+						FString refreshError;
+						cached->bRefreshing = this->StartSessionSearch(epicNetId.ToProductUserId(), refresh, cacheKey, true, refreshError);
+						UE_CLOG_ONLINE_SESSION(!refreshError.IsEmpty(), Warning, TEXT("Couldn't refresh cached session search: %s"), *refreshError);
+					}
 				}
 			}
 			else
 			{
-				error = FString::Printf(TEXT("[EOS SDK] Couldn't create sessionsearch. Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(eosResult)));
+				if (!cacheKey.IsEmpty())
+				{
+					this->SessionSearchCacheMetrics.Misses += 1;
+				}
+
+				// The results are written into the callers object, which is where they are expected to be.
+				if (this->StartSessionSearch(epicNetId.ToProductUserId(), SearchSettings, cacheKey, false, error))
+				{
+					// Mark the operation as pending
+					result = ONLINE_IO_PENDING;
+				}
 			}
 		}
 	}
@@ -1921,13 +2375,86 @@ bool FOnlineSessionEpic::FindSessions(const FUniqueNetId& SearchingPlayerId, con
 	if (result != ONLINE_IO_PENDING)
 	{
 		UE_CLOG_ONLINE_SESSION(!error.IsEmpty(), Warning, TEXT("%s"), *error);
-		SearchSettings->SearchState = EOnlineAsyncTaskState::Failed;
-		TriggerOnFindSessionsCompleteDelegates(false);
+		SearchSettings->SearchState = (result == ONLINE_SUCCESS) ? EOnlineAsyncTaskState::Done : EOnlineAsyncTaskState::Failed;
+		TriggerOnFindSessionsCompleteDelegates(result == ONLINE_SUCCESS);
 	}
 
 	return result == ONLINE_IO_PENDING || result == ONLINE_SUCCESS;
 }
 
+bool FOnlineSessionEpic::StartSessionSearch(EOS_ProductUserId LocalUserId, TSharedRef<FOnlineSessionSearch> const& SearchSettings, FString const& CacheKey, bool bBackground, FString& Error, uint32 MultiSearchId)
+{
+	// Results filtered locally don't count, ask the backend for more so enough are left
+	TSharedPtr<FOnlineSessionSearchFilterEpic> filter = MakeShared<FOnlineSessionSearchFilterEpic>(SearchSettings->QuerySettings);
+	int32 maxSearchResults = SearchSettings->MaxSearchResults;
+	if (filter->IsEmpty())
+	{
+		filter = nullptr;
+	}
+	else
+	{
+		maxSearchResults = FMath::Max(maxSearchResults, FMath::Min(maxSearchResults * this->SearchFilterOverfetch, MaxBackendSearchResults));
+	}
+
+	EOS_Sessions_CreateSessionSearchOptions sessionSearchOpts = {
+		EOS_SESSIONS_CREATESESSIONSEARCH_API_LATEST,
+		static_cast<uint32_t>(maxSearchResults)
+	};
+
+	// Handle where the session search is stored
+	EOS_HSessionSearch sessionSearchHandle = nullptr;
+	EOS_EResult eosResult = EOS_Sessions_CreateSessionSearch(this->sessionsHandle, &sessionSearchOpts, &sessionSearchHandle);
+	if (eosResult != EOS_EResult::EOS_Success)
+	{
+		Error = FString::Printf(TEXT("[EOS SDK] Couldn't create sessionsearch. Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(eosResult)));
+		return false;
+	}
+
+	UpdateSessionSearchParameters(SearchSettings, sessionSearchHandle, Error);
+	if (!Error.IsEmpty())
+	{
+		EOS_SessionSearch_Release(sessionSearchHandle);
+		return false;
+	}
+
+	// Mark the search as in progress
+	SearchSettings->SearchState = EOnlineAsyncTaskState::InProgress;
+
+	// Store the EOS session search handle and the session search object the results are written into
+	uint32 searchId = this->AddSessionSearch(sessionSearchHandle, SearchSettings, this->SessionSearchTimeout);
+	FSessionSearch& search = this->SessionSearches[searchId];
+	search.CacheKey = CacheKey;
+	search.bBackground = bBackground;
+	search.Filter = filter;
+	search.MultiSearchId = MultiSearchId;
+
+	FFindSessionsAdditionalData* additionalData = new FFindSessionsAdditionalData{
+		this,
+		searchId,
+		LocalUserId
+	};
+	this->IssueFindSessions(additionalData, sessionSearchHandle);
+	return true;
+}
+
+FString FOnlineSessionEpic::MakeSessionSearchCacheKey(FOnlineSessionSearch const& SearchSettings)
+{
+	// The parameters are sorted, so the order they were set in doesn't matter
+	TArray<FString> params;
+	params.Reserve(SearchSettings.QuerySettings.SearchParams.Num());
+	for (TPair<FName, FOnlineSessionSearchParam> const& param : SearchSettings.QuerySettings.SearchParams)
+	{
+		params.Add(FString::Printf(TEXT("%s:%d:%d:%s"),
+			*param.Key.ToString(),
+			static_cast<int32>(param.Value.ComparisonOp),
+			static_cast<int32>(param.Value.Data.GetType()),
+			*param.Value.Data.ToString()));
+	}
+	params.Sort();
+
+	return FString::Printf(TEXT("%d|%s"), SearchSettings.MaxSearchResults, *FString::Join(params, TEXT("|")));
+}
+
 bool FOnlineSessionEpic::FindSessionById(const FUniqueNetId& SearchingUserId, const FUniqueNetId& SessionId, const FUniqueNetId& FriendId, const FOnSingleSessionResultCompleteDelegate& CompletionDelegate)
 {
 	// Currently there is no way to get a named session (and therefore the joinability)
@@ -1999,18 +2526,269 @@ bool FOnlineSessionEpic::FindSessionById(const FUniqueNetId& SearchingUserId, co
 	//return result == ONLINE_IO_PENDING || result == ONLINE_SUCCESS;
 }
 
-bool FOnlineSessionEpic::CancelFindSessions()
+uint32 FOnlineSessionEpic::AddSessionSearch(EOS_HSessionSearch SearchHandle, TSharedRef<FOnlineSessionSearch> const& SearchSettings, float Timeout)
+{
+	// A finished search of the same settings object is replaced, the new results are written into the same object
+	for (auto it = this->SessionSearches.CreateIterator(); it; ++it)
+	{
+		if (it.Value().SearchSettings == SearchSettings && it.Value().FinishTime != 0 && !it.Value().SearchHandle)
+		{
+			it.RemoveCurrent();
+		}
+	}
+
+	double now = FPlatformTime::Seconds();
+	uint32 searchId = this->NextSessionSearchId++;
+	this->SessionSearches.Add(searchId, FSessionSearch{
+		SearchHandle,
+		SearchSettings,
+		Timeout > 0.f ? now + Timeout : 0,
+		0
+	});
+	return searchId;
+}
+
+void FOnlineSessionEpic::FinishSessionSearch(uint32 SearchId, bool bWasSuccessful)
+{
+	FSessionSearch* search = this->SessionSearches.Find(SearchId);
+	if (!search || search->FinishTime != 0)
+	{
+		return;
+	}
+
+	// The handle of a search the backend is still working on is released when its answer arrives,
+	// the handle of a search whose results are converted with the next slice
+	double now = FPlatformTime::Seconds();
+	search->FinishTime = now;
+	search->SearchSettings->SearchState = bWasSuccessful ? EOnlineAsyncTaskState::Done : EOnlineAsyncTaskState::Failed;
+
+	// Successful searches update the cache, a failed refresh leaves the stale results in place
+	if (!search->CacheKey.IsEmpty())
+	{
+		if (bWasSuccessful)
+		{
+			this->SessionSearchCache.Add(search->CacheKey, FCachedSessionSearch{ search->SearchSettings->SearchResults, now, false });
+		}
+		else if (FCachedSessionSearch* cached = this->SessionSearchCache.Find(search->CacheKey))
+		{
+			cached->bRefreshing = false;
+		}
+	}
+
+	// Refreshes of the cache run on behalf of no caller, searches of a multi search report to it
+	if (search->MultiSearchId != 0)
+	{
+		this->FinishMultiSessionSearchPart(search->MultiSearchId, SearchId, bWasSuccessful);
+	}
+	else if (!search->bBackground)
+	{
+		TriggerOnFindSessionsCompleteDelegates(bWasSuccessful);
+	}
+}
+
+bool FOnlineSessionEpic::FindSessionsMulti(const FUniqueNetId& SearchingPlayerId, TArray<TSharedRef<FOnlineSessionSearch>> const& Searches, TSharedRef<FOnlineSessionSearch> const& MergedSearch, int32 MaxResults)
 {
-	UE_LOG_ONLINE_SESSION(Warning, TEXT("CancelFindSession not supported."));
+	FString error;
+	MergedSearch->SearchState = EOnlineAsyncTaskState::NotStarted;
+	MergedSearch->SearchResults.Empty();
+
+	FUniqueNetIdEpic const epicNetId = static_cast<FUniqueNetIdEpic>(SearchingPlayerId);
+	if (!epicNetId.IsEpicAccountIdValid())
+	{
+		error = TEXT("SearchingPlayerId is not a valid EpicAccountId");
+	}
+	else if (Searches.Num() == 0)
+	{
+		error = TEXT("No searches passed");
+	}
+	else
+	{
+		uint32 multiSearchId = this->NextMultiSessionSearchId++;
+		this->MultiSessionSearches.Add(multiSearchId, FMultiSessionSearch{ MergedSearch, {}, 0, false, FMath::Max(MaxResults, 0) });
+		MergedSearch->SearchState = EOnlineAsyncTaskState::InProgress;
+
+		// All searches are sent before the first answer can arrive, answers only arrive from the next tick on
+		int32 started = 0;
+		for (TSharedRef<FOnlineSessionSearch> const& search : Searches)
+		{
+			search->SearchState = EOnlineAsyncTaskState::NotStarted;
+			search->SearchResults.Empty();
+
+			FString searchError;
+			if (search->bIsLanQuery)
+			{
+				searchError = TEXT("LAN searches are not supported.");
+			}
+			else if (this->StartSessionSearch(epicNetId.ToProductUserId(), search, FString(), false, searchError, multiSearchId))
+			{
+				started += 1;
+				continue;
+			}
+
+			UE_LOG_ONLINE_SESSION(Warning, TEXT("Couldn't start a search of multi search %u: %s"), multiSearchId, *searchError);
+			search->SearchState = EOnlineAsyncTaskState::Failed;
+		}
+
+		if (started > 0)
+		{
+			this->MultiSessionSearches[multiSearchId].Pending = started;
+			UE_LOG_ONLINE_SESSION(Display, TEXT("Started multi search %u with %d searches"), multiSearchId, started);
+			return true;
+		}
+
+		this->MultiSessionSearches.Remove(multiSearchId);
+		error = TEXT("None of the searches could be started");
+	}
+
+	UE_LOG_ONLINE_SESSION(Warning, TEXT("%s"), *error);
+	MergedSearch->SearchState = EOnlineAsyncTaskState::Failed;
+	TriggerOnFindSessionsCompleteDelegates(false);
 	return false;
 }
 
-bool FOnlineSessionEpic::PingSearchResults(const FOnlineSessionSearchResult& SearchResult)
+void FOnlineSessionEpic::FinishMultiSessionSearchPart(uint32 MultiSearchId, uint32 SearchId, bool bWasSuccessful)
+{
+	FMultiSessionSearch* multi = this->MultiSessionSearches.Find(MultiSearchId);
+	FSessionSearch const* search = this->SessionSearches.Find(SearchId);
+	if (!multi || !search)
+	{
+		return;
+	}
+
+	multi->Pending -= 1;
+	if (bWasSuccessful)
+	{
+		multi->bAnySucceeded = true;
+
+		// Sessions can be found by more than one search, e.g. with overlapping parameters
+		for (FOnlineSessionSearchResult const& searchResult : search->SearchSettings->SearchResults)
+		{
+			bool bAlreadyMerged = false;
+			multi->SessionIds.Add(searchResult.GetSessionIdStr(), &bAlreadyMerged);
+			if (!bAlreadyMerged)
+			{
+				multi->MergedSearch->SearchResults.Add(searchResult);
+			}
+		}
+	}
+
+	int32 maxSearchResults = multi->MaxResults;
+	bool bEnoughResults = maxSearchResults > 0 && multi->MergedSearch->SearchResults.Num() >= maxSearchResults;
+	if (multi->Pending > 0 && !bEnoughResults)
+	{
+		return;
+	}
+
+	// Taken out first, so the searches given up on below don't report to it anymore
+	FMultiSessionSearch finished = this->MultiSessionSearches.FindAndRemoveChecked(MultiSearchId);
+	if (finished.Pending > 0)
+	{
+		UE_LOG_ONLINE_SESSION(Display, TEXT("Multi search %u has enough results, giving up on %d searches"), MultiSearchId, finished.Pending);
+
+		TArray<uint32> running;
+		for (TPair<uint32, FSessionSearch> const& other : this->SessionSearches)
+		{
+			if (other.Value.MultiSearchId == MultiSearchId && other.Value.FinishTime == 0)
+			{
+				running.Add(other.Key);
+			}
+		}
+		for (uint32 searchId : running)
+		{
+			this->FinishSessionSearch(searchId, false);
+		}
+	}
+
+	// Each search sorted its own results, the merged results are sorted as a whole
+	TArray<FOnlineSessionSearchResult>& mergedResults = finished.MergedSearch->SearchResults;
+	FOnlineSessionPingerEpicPtr pinger = this->Subsystem->SessionPinger;
+	if (pinger && pinger->IsEnabled() && pinger->ShouldSortByPing() && !HasNearParameter(*finished.MergedSearch))
+	{
+		mergedResults.StableSort([](FOnlineSessionSearchResult const& A, FOnlineSessionSearchResult const& B)
+			{
+				return A.PingInMs < B.PingInMs;
+			});
+	}
+	if (maxSearchResults > 0 && mergedResults.Num() > maxSearchResults)
+	{
+		mergedResults.SetNum(maxSearchResults);
+	}
+
+	UE_LOG_ONLINE_SESSION(Display, TEXT("Finished multi search %u with %d results"), MultiSearchId, mergedResults.Num());
+	finished.MergedSearch->SearchState = finished.bAnySucceeded ? EOnlineAsyncTaskState::Done : EOnlineAsyncTaskState::Failed;
+	TriggerOnFindSessionsCompleteDelegates(finished.bAnySucceeded);
+}
+
+bool FOnlineSessionEpic::CancelSessionSearch(TSharedRef<FOnlineSessionSearch> const& SearchSettings)
 {
-	UE_LOG_ONLINE_SESSION(Warning, TEXT("PingSearchResults not implemented."));
+	for (TPair<uint32, FSessionSearch> const& search : this->SessionSearches)
+	{
+		if (search.Value.SearchSettings == SearchSettings && search.Value.FinishTime == 0)
+		{
+			UE_LOG_ONLINE_SESSION(Display, TEXT("Cancelling session search %u"), search.Key);
+			this->FinishSessionSearch(search.Key, false);
+			return true;
+		}
+	}
 	return false;
 }
 
+bool FOnlineSessionEpic::CancelFindSessions()
+{
+	// Finishing a search calls out, collect the running ones first
+	TArray<uint32> running;
+	for (TPair<uint32, FSessionSearch> const& search : this->SessionSearches)
+	{
+		if (search.Value.FinishTime == 0 && !search.Value.bBackground)
+		{
+			running.Add(search.Key);
+		}
+	}
+
+	for (uint32 searchId : running)
+	{
+		UE_LOG_ONLINE_SESSION(Display, TEXT("Cancelling session search %u"), searchId);
+		this->FinishSessionSearch(searchId, false);
+	}
+
+	UE_CLOG_ONLINE_SESSION(running.Num() == 0, Warning, TEXT("CancelFindSessions called, but no session search is running."));
+	TriggerOnCancelFindSessionsCompleteDelegates(running.Num() > 0);
+	return running.Num() > 0;
+}
+
+bool FOnlineSessionEpic::PingSearchResults(const FOnlineSessionSearchResult& SearchResult)
+{
+	FOnlineSessionPingerEpicPtr pinger = this->Subsystem->SessionPinger;
+	if (!pinger || !pinger->IsEnabled())
+	{
+		UE_LOG_ONLINE_SESSION(Warning, TEXT("Can't ping search results, SessionPingPort is not set"));
+		return false;
+	}
+
+	TSharedPtr<FOnlineSessionInfoEpic> sessionInfo = StaticCastSharedPtr<FOnlineSessionInfoEpic>(SearchResult.Session.SessionInfo);
+	if (!sessionInfo.IsValid())
+	{
+		UE_LOG_ONLINE_SESSION(Warning, TEXT("Can't ping a search result without session info"));
+		return false;
+	}
+
+	// The passed result is const, the ping is written into the matching results of the searches that found the session
+	FString sessionId = SearchResult.GetSessionIdStr();
+	return pinger->Ping({ sessionInfo->HostAddr }, [this, sessionId](TArray<int32> const& PingsInMs)
+		{
+			for (TPair<uint32, FSessionSearch> const& search : this->SessionSearches)
+			{
+				for (FOnlineSessionSearchResult& searchResult : search.Value.SearchSettings->SearchResults)
+				{
+					if (searchResult.GetSessionIdStr() == sessionId)
+					{
+						searchResult.PingInMs = PingsInMs[0];
+					}
+				}
+			}
+		});
+}
+
 bool FOnlineSessionEpic::JoinSession(int32 PlayerNum, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
 {
 	IOnlineIdentityPtr identityPtr = this->Subsystem->GetIdentityInterface();
@@ -2030,74 +2808,48 @@ bool FOnlineSessionEpic::JoinSession(const FUniqueNetId& PlayerId, FName Session
 	}
 	else
 	{
-		FNamedOnlineSession* namedSession = this->GetNamedSession(SessionName);
-		if (!namedSession) // This should be the norm
+		// The search result carries everything the join needs. It may come from a search, the search cache, or an invite
+		TSharedPtr<FOnlineSessionInfoEpic const> sessionInfo = StaticCastSharedPtr<FOnlineSessionInfoEpic const>(DesiredSession.Session.SessionInfo);
+		if (!sessionInfo.IsValid() || !sessionInfo->SessionId.IsValid())
 		{
-			namedSession = this->AddNamedSession(SessionName, DesiredSession.Session);
+			error = FString::Printf(TEXT("No sesssion to join found.\r\n Session: %s"), *SessionName.ToString());
 		}
-
-		// Get the session form the search results
-		FOnlineSessionSearchResult* searchResultPtr = nullptr;
-		for (auto sessionT : this->SessionSearches)
+		else
 		{
-			TSharedRef<FOnlineSessionSearch> session = sessionT.Value.Value;
-
-			// Only consider completed searches
-			if (session->SearchState == EOnlineAsyncTaskState::Done)
+			FNamedOnlineSession* namedSession = this->GetNamedSession(SessionName);
+			if (!namedSession) // This should be the norm
 			{
-				// Check if the desired session is in the search results
-				searchResultPtr = session->SearchResults.FindByPredicate([&DesiredSession](FOnlineSessionSearchResult sr)
-					{
-						return FUniqueNetIdString(sr.GetSessionIdStr()) == FUniqueNetIdString(DesiredSession.GetSessionIdStr());
-					});
-
-				if (searchResultPtr)
-				{
-					// Remove the search result, as it is no longer needed
-					this->SessionSearches.Remove(sessionT.Key);
-					break;
-				}
+				namedSession = this->AddNamedSession(SessionName, DesiredSession.Session);
 			}
 
-			if (searchResultPtr)
-			{
-				// Joining players are the local owner but never the host
-				namedSession->HostingPlayerNum = INDEX_NONE; // HostingPlayernNum is going to be deprecated. Don't use it here
-				namedSession->LocalOwnerId = PlayerId.AsShared();
-				namedSession->bHosting = false;
-
-				IOnlineIdentityPtr identityPtr = this->Subsystem->GetIdentityInterface();
-				if (identityPtr.IsValid())
-				{
-					namedSession->OwningUserName = identityPtr->GetPlayerNickname(PlayerId);
-				}
-				else
-				{
-					namedSession->OwningUserName = FString(TEXT("EPIC User"));
-				}
-
-				namedSession->SessionSettings.BuildUniqueId = GetBuildUniqueId();
+			// Joining players are the local owner but never the host
+			namedSession->HostingPlayerNum = INDEX_NONE; // HostingPlayernNum is going to be deprecated. Don't use it here
+			namedSession->LocalOwnerId = PlayerId.AsShared();
+			namedSession->bHosting = false;
 
-				// Register the current player as local player in the session. No need for a callback
-				this->RegisterLocalPlayer(PlayerId, SessionName, nullptr);
-
-				// Push the join to backend
-				EOS_Sessions_JoinSessionOptions joinSessionOpts = {
-							EOS_SESSIONS_JOINSESSION_API_LATEST,
-							TCHAR_TO_UTF8(*SessionName.ToString())
-				};
-				FJoinSessionAdditionalData* additionalData = new FJoinSessionAdditionalData{
-					this,
-					SessionName
-				};
-				EOS_Sessions_JoinSession(this->sessionsHandle, &joinSessionOpts, additionalData, &FOnlineSessionEpic::OnEOSJoinSessionComplete);
-
-				result = ONLINE_IO_PENDING;
+			IOnlineIdentityPtr identityPtr = this->Subsystem->GetIdentityInterface();
+			if (identityPtr.IsValid())
+			{
+				namedSession->OwningUserName = identityPtr->GetPlayerNickname(PlayerId);
 			}
 			else
 			{
-				error = FString::Printf(TEXT("No sesssion to join found.\r\n Session: %s"), *SessionName.ToString());
+				namedSession->OwningUserName = FString(TEXT("EPIC User"));
 			}
+
+			namedSession->SessionSettings.BuildUniqueId = GetBuildUniqueId();
+
+			// Register the current player as local player in the session. No need for a callback
+			this->RegisterLocalPlayer(PlayerId, SessionName, nullptr);
+
+			// Push the join to backend
+			FJoinSessionAdditionalData* additionalData = new FJoinSessionAdditionalData{
+				this,
+				SessionName
+			};
+			this->IssueJoinSession(additionalData);
+
+			result = ONLINE_IO_PENDING;
 		}
 	}
 
@@ -2138,8 +2890,15 @@ bool FOnlineSessionEpic::FindFriendSession(const FUniqueNetId& LocalUserId, cons
 			};
 			EOS_Sessions_CreateSessionSearch(this->sessionsHandle, &sessionSearchOptions, &sessionSearchHandle);
 
-			// To later access everything, the sessions creation time in UTC is used
-			double searchCreationTime = FDateTime::UtcNow().ToUnixTimestamp();
+			// Create pointer to a local, default session search object so the user can later access it
+			TSharedRef<FOnlineSessionSearch> sessionSearch = MakeShared<FOnlineSessionSearch>();
+
+			// Mark the session as in progress
+			sessionSearch->SearchState = EOnlineAsyncTaskState::InProgress;
+
+			// Store the EOS session search handle and the local session search object.
+			// Friend searches don't report through the find delegates, so they don't time out either.
+			uint32 searchId = this->AddSessionSearch(sessionSearchHandle, sessionSearch, 0.f);
 
 			// Set the session search to only search for a user
 			EOS_SessionSearch_SetTargetUserIdOptions targetUserIdOptions = {
@@ -2155,21 +2914,11 @@ bool FOnlineSessionEpic::FindFriendSession(const FUniqueNetId& LocalUserId, cons
 			};
 			FFindFriendSessionAdditionalData additionalData = {
 				this,
-				searchCreationTime,
+				searchId,
 				LocalUserId
 			};
 			EOS_SessionSearch_Find(sessionSearchHandle, &findOptions, &additionalData, &FOnlineSessionEpic::OnEOSFindFriendSessionComplete);
 
-			// Create pointer to a local, default session search object so the user can later access it
-			TSharedRef<FOnlineSessionSearch> sessionSearch = MakeShared<FOnlineSessionSearch>();
-
-			// Mark the session as in progress
-			sessionSearch->SearchState = EOnlineAsyncTaskState::InProgress;
-
-			// Store the EOS session search handle and the local session search object
-			TTuple<EOS_HSessionSearch, TSharedRef<FOnlineSessionSearch>> value(sessionSearchHandle, sessionSearch);
-			this->SessionSearches.Add(searchCreationTime, value);
-
 			// Mark the operation as pending
 			result = ONLINE_IO_PENDING;
 		}
@@ -2325,6 +3074,17 @@ bool FOnlineSessionEpic::GetResolvedConnectString(const FOnlineSessionSearchResu
 	return bSuccess;
 }
 
+bool FOnlineSessionEpic::CopySessionSettings(FName SessionName, FOnlineSessionSettings& OutSettings) const
+{
+	FScopeLock ScopeLock(&SessionLock);
+	if (int32 const* slot = this->SessionSlotByName.Find(SessionName))
+	{
+		OutSettings = this->SessionSlots[*slot]->SessionSettings;
+		return true;
+	}
+	return false;
+}
+
 FOnlineSessionSettings* FOnlineSessionEpic::GetSessionSettings(FName SessionName)
 {
 	if (FNamedOnlineSession* session = this->GetNamedSession(SessionName))
@@ -2350,7 +3110,6 @@ bool FOnlineSessionEpic::RegisterPlayers(FName SessionName, const TArray< TShare
 	if (Session)
 	{
 		TArray<TSharedRef<const FUniqueNetId>> successfullyRegisteredPlayers;
-		EOS_ProductUserId* userIdArr = static_cast<EOS_ProductUserId*>(malloc(Players.Num() * sizeof(EOS_ProductUserId)));
 		for (int32 i = 0; i < Players.Num(); ++i)
 		{
 			TSharedRef<FUniqueNetId const> playerId = Players[i];
@@ -2361,9 +3120,6 @@ bool FOnlineSessionEpic::RegisterPlayers(FName SessionName, const TArray< TShare
 				successfullyRegisteredPlayers.Add(playerId);
 				RegisterVoice(*playerId);
 
-				TSharedRef<FUniqueNetIdEpic const> epicNetId = StaticCastSharedRef<FUniqueNetIdEpic const>(playerId);
-				userIdArr[i] = epicNetId->ToProductUserId();
-
 				// update number of open connections
 				if (Session->NumOpenPublicConnections > 0)
 				{
@@ -2380,20 +3136,17 @@ bool FOnlineSessionEpic::RegisterPlayers(FName SessionName, const TArray< TShare
 			}
 		}
 
-		EOS_Sessions_RegisterPlayersOptions registerPlayerOpts = {
-			EOS_SESSIONS_REGISTERPLAYERS_API_LATEST,
-			TCHAR_TO_UTF8(*SessionName.ToString()),
-			userIdArr,
-			static_cast<uint32_t>(Players.Num())
-		};
-
-		FRegisterPlayersAdditionalData* additionalData = new FRegisterPlayersAdditionalData();
-		additionalData->OnlineSessionPtr = this;
-		additionalData->SessionName = SessionName;
-		additionalData->RegisteredPlayers = successfullyRegisteredPlayers;
+		this->PublishSessionSnapshot();
 
-		EOS_Sessions_RegisterPlayers(this->sessionsHandle, &registerPlayerOpts, additionalData, &FOnlineSessionEpic::OnEOSRegisterPlayersComplete);
+		if (this->ShouldDeferWrite(*Session))
+		{
+			// The players are registered locally right away, and with the backend once the owner is back online
+			this->DeferRegisterPlayers(SessionName, successfullyRegisteredPlayers);
+			TriggerOnRegisterPlayersCompleteDelegates(SessionName, successfullyRegisteredPlayers, true);
+			return true;
+		}
 
+		this->IssueRegisterPlayers(SessionName, successfullyRegisteredPlayers);
 		result = ONLINE_IO_PENDING;
 	}
 	else
@@ -2489,6 +3242,8 @@ bool FOnlineSessionEpic::UnregisterPlayers(FName SessionName, const TArray< TSha
 			}
 		}
 
+		this->PublishSessionSnapshot();
+
 		EOS_Sessions_RegisterPlayersOptions registerPlayerOpts = {
 			EOS_SESSIONS_REGISTERPLAYERS_API_LATEST,
 			TCHAR_TO_UTF8(*SessionName.ToString()),
@@ -2535,6 +3290,7 @@ void FOnlineSessionEpic::RegisterLocalPlayer(const FUniqueNetId& PlayerId, FName
 	}
 
 	session->RegisteredPlayers.Add(PlayerId.AsShared());
+	this->PublishSessionSnapshot();
 
 	// update number of open connections
 	if (session->NumOpenPublicConnections > 0)
@@ -2558,6 +3314,7 @@ void FOnlineSessionEpic::UnregisterLocalPlayer(const FUniqueNetId& PlayerId, FNa
 	}
 
 	session->RegisteredPlayers.RemoveSingle(PlayerId.AsShared());
+	this->PublishSessionSnapshot();
 
 	// update number of open connections
 	if (session->NumOpenPublicConnections < session->SessionSettings.NumPublicConnections)
@@ -2573,16 +3330,108 @@ void FOnlineSessionEpic::UnregisterLocalPlayer(const FUniqueNetId& PlayerId, FNa
 
 int32 FOnlineSessionEpic::GetNumSessions()
 {
-	FScopeLock ScopeLock(&SessionLock);
-	return this->Sessions.Num();
+	FSnapshotReadScope snapshot(*this);
+	return snapshot->Sessions.Num();
 }
 
 void FOnlineSessionEpic::DumpSessionState()
 {
 	FScopeLock ScopeLock(&SessionLock);
 
-	for (int32 SessionIdx = 0; SessionIdx < Sessions.Num(); SessionIdx++)
+	for (TPair<FName, int32> const& entry : this->SessionSlotByName)
 	{
-		DumpNamedSession(&Sessions[SessionIdx]);
+		DumpNamedSession(this->SessionSlots[entry.Value].Get());
 	}
 }
+
+
+// ---------------------------------------------
+// Future based API
+//
+// Each call registers a one shot handler on the interface delegate, which removes itself
+// once the completion for its own operation arrives. As the delegates are triggered from within
+// the EOS callbacks, the futures complete in the same tick and continuations can chain immediately.
+// ---------------------------------------------
+
+TFuture<FOnlineSessionResultEpic> FOnlineSessionEpic::CreateSessionAsync(const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+	TSharedRef<TOnlineTrackedPromiseEpic<FOnlineSessionResultEpic>> promise = this->PendingPromises.Make(FOnlineSessionResultEpic{ SessionName, false });
+	TFuture<FOnlineSessionResultEpic> future = promise->GetFuture();
+
+	TSharedRef<FDelegateHandle> handle = MakeShared<FDelegateHandle>();
+	*handle = this->AddOnCreateSessionCompleteDelegate_Handle(FOnCreateSessionCompleteDelegate::CreateLambda(
+		[this, promise, handle, SessionName](FName InSessionName, bool bWasSuccessful)
+		{
+			if (InSessionName == SessionName)
+			{
+				this->ClearOnCreateSessionCompleteDelegate_Handle(*handle);
+				promise->SetValue(FOnlineSessionResultEpic{ InSessionName, bWasSuccessful });
+			}
+		}));
+
+	this->CreateSession(HostingPlayerId, SessionName, NewSessionSettings);
+	return future;
+}
+
+TFuture<FOnlineSessionResultEpic> FOnlineSessionEpic::DestroySessionAsync(FName SessionName)
+{
+	TSharedRef<TOnlineTrackedPromiseEpic<FOnlineSessionResultEpic>> promise = this->PendingPromises.Make(FOnlineSessionResultEpic{ SessionName, false });
+	TFuture<FOnlineSessionResultEpic> future = promise->GetFuture();
+
+	TSharedRef<FDelegateHandle> handle = MakeShared<FDelegateHandle>();
+	*handle = this->AddOnDestroySessionCompleteDelegate_Handle(FOnDestroySessionCompleteDelegate::CreateLambda(
+		[this, promise, handle, SessionName](FName InSessionName, bool bWasSuccessful)
+		{
+			if (InSessionName == SessionName)
+			{
+				this->ClearOnDestroySessionCompleteDelegate_Handle(*handle);
+				promise->SetValue(FOnlineSessionResultEpic{ InSessionName, bWasSuccessful });
+			}
+		}));
+
+	this->DestroySession(SessionName);
+	return future;
+}
+
+TFuture<FOnlineFindSessionsResultEpic> FOnlineSessionEpic::FindSessionsAsync(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	TSharedRef<TOnlineTrackedPromiseEpic<FOnlineFindSessionsResultEpic>> promise = this->PendingPromises.Make(FOnlineFindSessionsResultEpic{ false, SearchSettings });
+	TFuture<FOnlineFindSessionsResultEpic> future = promise->GetFuture();
+
+	// The find delegate doesn't tell which search completed.
+	// The search state of the callers object is updated before the delegate fires,
+	// so every completion while it is still in progress belongs to another search.
+	TSharedRef<FDelegateHandle> handle = MakeShared<FDelegateHandle>();
+	*handle = this->AddOnFindSessionsCompleteDelegate_Handle(FOnFindSessionsCompleteDelegate::CreateLambda(
+		[this, promise, handle, SearchSettings](bool bWasSuccessful)
+		{
+			if (SearchSettings->SearchState != EOnlineAsyncTaskState::InProgress)
+			{
+				this->ClearOnFindSessionsCompleteDelegate_Handle(*handle);
+				promise->SetValue(FOnlineFindSessionsResultEpic{ SearchSettings->SearchState == EOnlineAsyncTaskState::Done, SearchSettings });
+			}
+		}));
+
+	this->FindSessions(SearchingPlayerId, SearchSettings);
+	return future;
+}
+
+TFuture<FOnlineJoinSessionResultEpic> FOnlineSessionEpic::JoinSessionAsync(const FUniqueNetId& PlayerId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+	TSharedRef<TOnlineTrackedPromiseEpic<FOnlineJoinSessionResultEpic>> promise = this->PendingPromises.Make(FOnlineJoinSessionResultEpic{ SessionName, EOnJoinSessionCompleteResult::UnknownError });
+	TFuture<FOnlineJoinSessionResultEpic> future = promise->GetFuture();
+
+	TSharedRef<FDelegateHandle> handle = MakeShared<FDelegateHandle>();
+	*handle = this->AddOnJoinSessionCompleteDelegate_Handle(FOnJoinSessionCompleteDelegate::CreateLambda(
+		[this, promise, handle, SessionName](FName InSessionName, EOnJoinSessionCompleteResult::Type Result)
+		{
+			if (InSessionName == SessionName)
+			{
+				this->ClearOnJoinSessionCompleteDelegate_Handle(*handle);
+				promise->SetValue(FOnlineJoinSessionResultEpic{ InSessionName, Result });
+			}
+		}));
+
+	this->JoinSession(PlayerId, SessionName, DesiredSession);
+	return future;
+}
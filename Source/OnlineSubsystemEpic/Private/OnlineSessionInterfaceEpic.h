@@ -3,14 +3,47 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 #include "OnlineSubsystemEpicPackage.h"
 #include "Interfaces/OnlineSessionInterface.h"
 #include "OnlineSessionSettings.h"
 #include "UObject/CoreOnline.h"
+#include "Templates/Atomic.h"
+#include "OnlineRequestCoalescerEpic.h"
+#include "OnlinePromiseTrackerEpic.h"
+#include "OnlineApiTypesEpic.h"
 #include "eos_sdk.h"
 
 class FOnlineSubsystemEpic;
 class FOnlineSessionInfoEpic;
+class FOnlineSessionSearchFilterEpic;
+struct FSessionStateChangeAdditionalData;
+struct FJoinSessionAdditionalData;
+struct FFindSessionsAdditionalData;
+
+/**
+ * An immutable copy of the session state game code polls every frame.
+ * Readers on any thread use the current snapshot without taking the session lock.
+ * Writers build a new snapshot under the lock and swap it in, the old one is freed once no reader can hold it anymore.
+ */
+struct FSessionStateSnapshot
+{
+	struct FEntry
+	{
+		EOnlineSessionState::Type State = EOnlineSessionState::NoSession;
+
+		/** The registered players, as made by MakePlayerKey */
+		TSet<FString> RegisteredPlayers;
+	};
+
+	TMap<FName, FEntry> Sessions;
+
+	/** Players are kept as strings, as net ids aren't safe to share between threads */
+	static FString MakePlayerKey(FUniqueNetId const& PlayerId)
+	{
+		return PlayerId.GetType().ToString() + TEXT(":") + PlayerId.ToString();
+	}
+};
 
 /**
  * Interface definition for the online services session services
@@ -25,6 +58,8 @@ private:
 	FOnlineSessionEpic()
 		: Subsystem(nullptr)
 		, sessionsHandle(nullptr)
+		, bHasPresenceSession(false)
+		, SessionSnapshot(nullptr)
 	{
 	}
 
@@ -62,6 +97,65 @@ private:
 	static void OnEOSSessionInviteAccepted(const EOS_Sessions_SessionInviteAcceptedCallbackInfo* Data);
 
 
+	// --------
+	// Rate limited SDK requests, used for first attempts and retries alike
+	// --------
+	void IssueUpdateSession(FName SessionName, EOS_HSessionModification ModificationHandle, void* ClientData, EOS_Sessions_OnUpdateSessionCallback Callback);
+	void IssueStartSession(FSessionStateChangeAdditionalData* Context);
+	void IssueEndSession(FSessionStateChangeAdditionalData* Context);
+	void IssueDestroySession(FSessionStateChangeAdditionalData* Context);
+	void IssueJoinSession(FJoinSessionAdditionalData* Context);
+	void IssueFindSessions(FFindSessionsAdditionalData* Context, EOS_HSessionSearch SearchHandle);
+	void IssueRegisterPlayers(FName SessionName, TArray<TSharedRef<const FUniqueNetId>> const& Players);
+
+	// --------
+	// Offline writes
+	// --------
+
+	/** Players registered while offline, registered with the backend once the connection is back */
+	TMap<FName, TArray<TSharedRef<const FUniqueNetId>>> DeferredRegistrations;
+
+	/** Whether writes to a session have to be journaled, because its owner is offline */
+	bool ShouldDeferWrite(FNamedOnlineSession const& Session) const;
+
+	/** Journals an update of a session's settings. The settings the session has at replay time are sent */
+	void DeferUpdateSession(FName SessionName);
+
+	/** Journals the registration of players, merged with the registrations journaled before */
+	void DeferRegisterPlayers(FName SessionName, TArray<TSharedRef<const FUniqueNetId>> const& Players);
+
+	// --------
+	// Update coalescing
+	// --------
+
+	/** An update of a session's settings, collecting UpdateSession calls until its flush window ends */
+	struct FPendingSessionUpdate
+	{
+		/** When the update is sent */
+		double FlushTime = 0;
+
+		/** The settings before the first call of the window, restored if the backend refuses the update */
+		FOnlineSessionSettings OldSessionSettings;
+
+		/** Identifies the callers waiting for this update */
+		uint32 Batch = 0;
+	};
+
+	/** The time in seconds UpdateSession calls are collected before they are sent as one update. Zero sends every call right away */
+	float SessionUpdateFlushWindow;
+
+	/** Updates waiting for their flush window to end, by session name */
+	TMap<FName, FPendingSessionUpdate> PendingSessionUpdates;
+
+	/** The callers of every update, by session name and batch. Completed with whether the update went through */
+	TOnlineRequestCoalescerEpic<TPair<FName, uint32>, bool> SessionUpdateCoalescer;
+
+	/** The batch of the next update */
+	uint32 NextSessionUpdateBatch;
+
+	/** Sends the settings a session has now as one update, completing every caller of the pending update */
+	void FlushSessionUpdate(FName SessionName);
+
 	// --------
 	// Private Utility methods
 	// --------
@@ -69,25 +163,28 @@ private:
 
 	bool GetConnectStringFromSessionInfo(TSharedPtr<FOnlineSessionInfoEpic>& SessionInfo, FString& ConnectInfo, int32 PortOverride = 0);
 
-	/**
-	 * Creates EOS Attribute data from UE4s variant data
-	 * @param attributeName - The name for the data.
-	 * @param variantData - The variable data itself
-	 * @outAttributeData - The EOS AttributeData populated with the variant data
-	 * @error - The error message if the creation was unsuccessful
-	 * @returns - True if the creation was successful, false otherwise
-	*/
-	EOS_Sessions_AttributeData CreateEOSAttributeData(FString const attributeName, FVariantData const variantData, FString& error);
-	
 	/** Sets the session details from the EOS session details struct*/
 	void SetSessionDetails(FOnlineSession* session, EOS_SessionDetails_Info const* SessionDetails);
 
-	/** Creates a pointer to an EOS session update struct from the passed session settings */
-	void CreateSessionModificationHandle(FOnlineSessionSettings const& NewSessionSettings, EOS_HSessionModification& ModificationHandle, FString& Error);
+	/**
+	 * Writes session settings into a session modification handle
+	 * @param NewSessionSettings - The settings to send
+	 * @param OldSessionSettings - The settings the backend has already. Only what differs from them is written. Null writes everything
+	 * @param ModificationHandle - The handle to write to. Released and defaulted on error
+	 * @param Error - The error message if writing a setting failed
+	 * @returns - The number of changes written to the handle
+	 */
+	int32 CreateSessionModificationHandle(FOnlineSessionSettings const& NewSessionSettings, FOnlineSessionSettings const* OldSessionSettings, EOS_HSessionModification& ModificationHandle, FString& Error);
+
+	/** The settings each hosted session had when the backend last accepted them, updates only send what changed since */
+	TMap<FName, FOnlineSessionSettings> SentSessionSettings;
 
 	/// Convert a String to an Internet address.
 	TPair<bool, TSharedPtr<class FInternetAddr>> StringToInternetAddress(FString addressStr);
 
+	/** The promises of the future based API that are still outstanding */
+	FOnlinePromiseTrackerEpic PendingPromises;
+
 
 
 PACKAGE_SCOPE:
@@ -95,16 +192,230 @@ PACKAGE_SCOPE:
 	/** Critical sections for thread safe operation of session lists */
 	mutable FCriticalSection SessionLock;
 
-	/** Array of sessions currently available on the local machine. Might not be in sync with remote */
-	TArray<FNamedOnlineSession> Sessions;
+	/**
+	 * Sessions currently available on the local machine. Might not be in sync with remote.
+	 * Every session lives in a slot of its own, so it keeps its address until it is removed, no matter how many sessions are added.
+	 * Slots of removed sessions are reused by the next session.
+	 */
+	TArray<TUniquePtr<FNamedOnlineSession>> SessionSlots;
+
+	/** Slots that don't hold a session */
+	TArray<int32> FreeSessionSlots;
+
+	/** The slot of every session, by session name */
+	TMap<FName, int32> SessionSlotByName;
+
+	/** Whether any session uses presence. Updated whenever sessions are added, removed or change their settings */
+	bool bHasPresenceSession;
+
+	/** Puts a new session into a free slot. The session lock must be held */
+	FNamedOnlineSession* AddSessionToSlot(TUniquePtr<FNamedOnlineSession>&& Session);
+
+	/** Recomputes whether any session uses presence. Takes the session lock */
+	void RefreshPresenceSessionFlag();
+
+	/** The snapshot read by GetSessionState, GetNumSessions and IsPlayerInSession. Never null */
+	TAtomic<FSessionStateSnapshot const*> SessionSnapshot;
+
+	/** Replaced snapshots and the value of SnapshotFlips when they were replaced, the oldest first */
+	TArray<TPair<FSessionStateSnapshot const*, uint64>> RetiredSnapshots;
 
 	/**
-	 * Array of session searches.
-	 * @Key - The time in UTC the session search was created.
-	 * @Value1 - A handle to the EOS session search. If the search isn't running, the handle will be invalid
-	 * @Value2 - The local session search settings
+	 * The number of readers per epoch. Readers count themselves in the current epoch before they load the snapshot.
+	 * Tick flips the epoch once the readers of the previous one are done. A snapshot replaced before the last flip
+	 * is freed once the readers of the epoch before that flip are done too, no matter how long they were preempted.
 	 */
-	TMap<double, TTuple<EOS_HSessionSearch, TSharedRef<FOnlineSessionSearch>>> SessionSearches;
+	mutable TAtomic<int32> SnapshotReaders[2];
+
+	/** The current reader epoch, 0 or 1 */
+	TAtomic<uint32> SnapshotEpoch;
+
+	/** The number of epoch flips so far */
+	uint64 SnapshotFlips;
+
+	/** Holds the current snapshot for the duration of a read, see SnapshotReaders */
+	class FSnapshotReadScope
+	{
+	public:
+		explicit FSnapshotReadScope(FOnlineSessionEpic const& Session)
+			: Readers(Session.SnapshotReaders[Session.SnapshotEpoch.Load()])
+		{
+			this->Readers.IncrementExchange();
+			this->Snapshot = Session.SessionSnapshot.Load();
+		}
+
+		~FSnapshotReadScope()
+		{
+			this->Readers.DecrementExchange();
+		}
+
+		FSessionStateSnapshot const* operator->() const
+		{
+			return this->Snapshot;
+		}
+
+	private:
+		TAtomic<int32>& Readers;
+		FSessionStateSnapshot const* Snapshot;
+	};
+
+	/** Publishes the current session state for lock free readers. Called after every change to a session's state or players */
+	void PublishSessionSnapshot();
+
+	/** A session search, from its start until its results are no longer needed */
+	struct FSessionSearch
+	{
+		/** The EOS session search. Null once the results are converted, even for searches given up on before that */
+		EOS_HSessionSearch SearchHandle;
+
+		/** The callers session search settings, the results are written into it */
+		TSharedRef<FOnlineSessionSearch> SearchSettings;
+
+		/** The time the search fails if the backend didn't answer by then. Zero for no limit */
+		double Deadline;
+
+		/** The time the search finished, was cancelled or timed out. Zero while it is running */
+		double FinishTime;
+
+		/** The key the results are cached under. Empty if the results aren't cached */
+		FString CacheKey;
+
+		/** Whether the search refreshes the cache, without a caller waiting for it */
+		bool bBackground = false;
+
+		/** Whether the backend answered and the results are being converted */
+		bool bConverting = false;
+
+		/** Whether a result couldn't be converted. The search fails, with the results that could be converted */
+		bool bConversionFailed = false;
+
+		/** The number of results the backend returned */
+		uint32 ResultCount = 0;
+
+		/** The index of the next result to convert */
+		uint32 NextResult = 0;
+
+		/** Evaluates the search parameters the backend can't. Null if it can evaluate all of them */
+		TSharedPtr<FOnlineSessionSearchFilterEpic> Filter;
+
+		/** The multi search the search is part of. Zero if it stands alone */
+		uint32 MultiSearchId = 0;
+	};
+
+	/** The session searches, by search id */
+	TMap<uint32, FSessionSearch> SessionSearches;
+
+	/** The id of the next session search */
+	uint32 NextSessionSearchId;
+
+	/** The time in seconds a session search may take, before it fails. Zero for no limit */
+	float SessionSearchTimeout;
+
+	/** The time in seconds the results of a finished search are kept, so the sessions found can be joined */
+	static constexpr double FinishedSearchRetention = 300.0;
+
+	/**
+	 * Starts tracking a session search
+	 * @param SearchHandle - The EOS session search, released once the backend answered
+	 * @param SearchSettings - The callers session search settings
+	 * @param Timeout - The time in seconds the search may take. Zero for no limit
+	 * @returns - The id of the search
+	 */
+	uint32 AddSessionSearch(EOS_HSessionSearch SearchHandle, TSharedRef<FOnlineSessionSearch> const& SearchSettings, float Timeout);
+
+	/** Ends a running session search and fires the find delegates. Does nothing if the search is over already */
+	void FinishSessionSearch(uint32 SearchId, bool bWasSuccessful);
+
+	/**
+	 * Creates an EOS session search and sends it
+	 * @param LocalUserId - The user searching
+	 * @param SearchSettings - The search parameters, the results are written into it
+	 * @param CacheKey - The key to cache the results under. Empty to not cache them
+	 * @param bBackground - Whether the search refreshes the cache, in which case it doesn't fire the find delegates
+	 * @param Error - The error message if the search couldn't be sent
+	 * @param MultiSearchId - The multi search the search is part of, it reports to it instead of firing the find delegates
+	 * @returns - True if the search was sent
+	 */
+	bool StartSessionSearch(EOS_ProductUserId LocalUserId, TSharedRef<FOnlineSessionSearch> const& SearchSettings, FString const& CacheKey, bool bBackground, FString& Error, uint32 MultiSearchId = 0);
+
+	/** Several searches run at the same time, with their results merged into one search */
+	struct FMultiSessionSearch
+	{
+		/** Receives the merged results */
+		TSharedRef<FOnlineSessionSearch> MergedSearch;
+
+		/** The ids of the sessions merged so far */
+		TSet<FString> SessionIds;
+
+		/** The number of searches that didn't finish yet */
+		int32 Pending;
+
+		/** Whether any search succeeded */
+		bool bAnySucceeded;
+
+		/** The number of results after which the search completes. Zero waits for all searches */
+		int32 MaxResults;
+	};
+
+	/** The running multi searches, by multi search id */
+	TMap<uint32, FMultiSessionSearch> MultiSessionSearches;
+
+	/** The id of the next multi search. Starts at one, zero means no multi search */
+	uint32 NextMultiSessionSearchId;
+
+	/**
+	 * Merges the results of a finished search into its multi search. Completes the multi search once every search
+	 * finished, or once enough results were merged, giving up on the searches still running.
+	 */
+	void FinishMultiSessionSearchPart(uint32 MultiSearchId, uint32 SearchId, bool bWasSuccessful);
+
+	/** Results of a search, cached for the searches with the same parameters */
+	struct FCachedSessionSearch
+	{
+		TArray<FOnlineSessionSearchResult> Results;
+
+		/** The time the results arrived */
+		double Time;
+
+		/** Whether a background search is refreshing the results */
+		bool bRefreshing;
+	};
+
+	/** The time in seconds search results are served from the cache. Zero disables the cache */
+	float SessionSearchCacheTTL;
+
+	/** Cached search results, by the canonical form of their search parameters */
+	TMap<FString, FCachedSessionSearch> SessionSearchCache;
+
+	FOnlineSessionSearchCacheMetricsEpic SessionSearchCacheMetrics;
+
+	/** Makes the cache key of a search. Searches with the same parameters and result limit get the same key */
+	static FString MakeSessionSearchCacheKey(FOnlineSessionSearch const& SearchSettings);
+
+	/** The time in milliseconds per frame spent converting search results. Zero converts all results as soon as they arrive */
+	float SearchResultFrameBudget;
+
+	/** The factor searches with parameters evaluated locally ask the backend for more results by */
+	int32 SearchFilterOverfetch;
+
+	/** The time a slice of search results has to be converted by. Zero if there is no budget */
+	double GetSearchResultSliceEnd(double Now) const;
+
+	/**
+	 * Converts a search result of the SDK
+	 * @param SearchHandle - The search that returned the result
+	 * @param Index - The index of the result
+	 * @param OutResult - The converted result
+	 * @param Error - The error message if the result couldn't be converted
+	 * @returns - True if the result was converted
+	 */
+	bool ConvertSearchResult(EOS_HSessionSearch SearchHandle, uint32 Index, FOnlineSessionSearchResult& OutResult, FString& Error);
+
+	/** Converts search results until the slice ends, and pings the hosts after the last one */
+	void ConvertSessionSearchResults(uint32 SearchId, double SliceEnd);
+
+	/** Pings the hosts of a search's results if pinging is enabled, and finishes the search once they answered */
+	void PingSessionSearchResults(uint32 SearchId, bool bWasSuccessful);
 
 	/**
 	 * Creates a new instance of the FOnlineSessionEpic class.
@@ -119,13 +430,13 @@ PACKAGE_SCOPE:
 	class FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSessionSettings& SessionSettings) override
 	{
 		FScopeLock ScopeLock(&SessionLock);
-		return new (Sessions) FNamedOnlineSession(SessionName, SessionSettings);
+		return this->AddSessionToSlot(MakeUnique<FNamedOnlineSession>(SessionName, SessionSettings));
 	}
 
 	class FNamedOnlineSession* AddNamedSession(FName SessionName, const FOnlineSession& Session) override
 	{
 		FScopeLock ScopeLock(&SessionLock);
-		return new (Sessions) FNamedOnlineSession(SessionName, Session);
+		return this->AddSessionToSlot(MakeUnique<FNamedOnlineSession>(SessionName, Session));
 	}
 
 public:
@@ -165,6 +476,7 @@ public:
 	virtual bool SendSessionInviteToFriends(const FUniqueNetId& LocalUserId, FName SessionName, const TArray< TSharedRef<const FUniqueNetId> >& Friends) override;
 	virtual bool GetResolvedConnectString(FName SessionName, FString& ConnectInfo, FName PortType) override;
 	virtual bool GetResolvedConnectString(const FOnlineSessionSearchResult& SearchResult, FName PortType, FString& ConnectInfo) override;
+	/** The returned settings belong to the live session. Only use them on the game thread, and not past a change of the session. See CopySessionSettings */
 	virtual FOnlineSessionSettings* GetSessionSettings(FName SessionName) override;
 	virtual bool RegisterPlayer(FName SessionName, const FUniqueNetId& PlayerId, bool bWasInvited) override;
 	virtual bool RegisterPlayers(FName SessionName, const TArray< TSharedRef<const FUniqueNetId> >& Players, bool bWasInvited = false) override;
@@ -176,5 +488,60 @@ public:
 	virtual void UnregisterLocalPlayer(const FUniqueNetId& PlayerId, FName SessionName, const FOnUnregisterLocalPlayerCompleteDelegate& Delegate) override;
 	virtual int32 GetNumSessions() override;
 	virtual void DumpSessionState() override;
+
+	// Future based API.
+	// The returned futures complete from within the EOS callback, so continuations attached with Then/Next
+	// run in the same tick as the completion and can immediately issue the next request.
+
+	/** Same as CreateSession, but returns a future that completes with the creation of this session */
+	TFuture<FOnlineSessionResultEpic> CreateSessionAsync(const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings);
+
+	/** Same as DestroySession, but returns a future that completes with the destruction of this session */
+	TFuture<FOnlineSessionResultEpic> DestroySessionAsync(FName SessionName);
+
+	/**
+	 * Cancels a single running search. The find delegates fire as failed, the results the backend sends later are dropped
+	 * @returns - True if the search was running
+	 */
+	bool CancelSessionSearch(TSharedRef<FOnlineSessionSearch> const& SearchSettings);
+
+	/** Reports the results of large searches, while they are converted over several frames. FindSessions completes after the last slice */
+	DEFINE_ONLINE_DELEGATE_THREE_PARAM(OnFindSessionsProgress, TSharedRef<FOnlineSessionSearch> const&, int32, int32);
+
+	/** How many searches were answered from the search cache */
+	FOnlineSessionSearchCacheMetricsEpic const& GetSessionSearchCacheMetrics() const
+	{
+		return this->SessionSearchCacheMetrics;
+	}
+
+	/**
+	 * Copies the settings of a session under the session lock. Safe on any thread, unlike GetSessionSettings
+	 * @returns - False if there is no such session
+	 */
+	bool CopySessionSettings(FName SessionName, FOnlineSessionSettings& OutSettings) const;
+
+	/**
+	 * Runs several searches at the same time, e.g. one per bucket, and merges their results.
+	 * Every search gets its own results as usual. The merged search receives the results of all of them,
+	 * without duplicate sessions, and the find delegates fire once, when it is done.
+	 * @param SearchingPlayerId - The user searching
+	 * @param Searches - The searches to run
+	 * @param MergedSearch - Receives the merged results. Its MaxSearchResults isn't used, as it defaults to a single result
+	 * @param MaxResults - Once the merged search has this many results, the searches still running are given up on. Zero waits for all of them
+	 * @returns - True if at least one search was started
+	 */
+	bool FindSessionsMulti(const FUniqueNetId& SearchingPlayerId, TArray<TSharedRef<FOnlineSessionSearch>> const& Searches, TSharedRef<FOnlineSessionSearch> const& MergedSearch, int32 MaxResults = 0);
+
+	/** Same as FindSessions, but returns a future that completes once the passed search is done */
+	TFuture<FOnlineFindSessionsResultEpic> FindSessionsAsync(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings);
+
+	/** Same as JoinSession, but returns a future that completes once this session is joined */
+	TFuture<FOnlineJoinSessionResultEpic> JoinSessionAsync(const FUniqueNetId& PlayerId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession);
+
+	/** Fails the futures of the operations still running. Called by the subsystem on shutdown */
+	void FailPendingFutures()
+	{
+		this->PendingPromises.FailAll();
+	}
 };
 using FOnlineSessionEpicPtr = TSharedPtr<FOnlineSessionEpic, ESPMode::ThreadSafe>;
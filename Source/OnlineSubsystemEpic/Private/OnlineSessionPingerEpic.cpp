@@ -0,0 +1,343 @@
+#include "OnlineSessionPingerEpic.h"
+#include "OnlineSubsystem.h"
+#include "OnlineSubsystemTypes.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ConfigCacheIni.h"
+#include "IPAddress.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+
+namespace
+{
+	/** Identifies ping datagrams. Followed by the nonce and the sequence number of the pinger */
+	uint8 const PingMagic[4] = { 'E', 'P', 'N', 'G' };
+	constexpr int32 PingPacketSize = sizeof(PingMagic) + 2 * sizeof(uint32);
+
+	/** The most datagrams read per socket and tick, so a flood of datagrams can't stall the frame */
+	constexpr int32 MaxReadsPerTick = 256;
+
+	bool IsPingPacket(uint8 const* Data, int32 Size)
+	{
+		return Size == PingPacketSize && FMemory::Memcmp(Data, PingMagic, sizeof(PingMagic)) == 0;
+	}
+}
+
+FOnlineSessionPingerEpic::FOnlineSessionPingerEpic()
+	: Port(0)
+	, PingsPerHost(3)
+	, Timeout(1.f)
+	, Rate(100.f)
+	, MaxInFlight(32)
+	, bSortByPing(true)
+	, Tokens(0)
+	, LastRefillTime(FPlatformTime::Seconds())
+	, ClientSocket(nullptr)
+	, ResponderSocket(nullptr)
+	, NextBatchId(0)
+	, NextSequence(0)
+	, Nonce(static_cast<uint32>(FMath::Rand()) ^ static_cast<uint32>(FPlatformTime::Cycles()))
+	, Answered(0)
+{
+}
+
+FOnlineSessionPingerEpic::~FOnlineSessionPingerEpic()
+{
+	this->Reset();
+}
+
+void FOnlineSessionPingerEpic::LoadConfig()
+{
+	GConfig->GetInt(TEXT("OnlineSubsystemEpic"), TEXT("SessionPingPort"), this->Port, GEngineIni);
+	GConfig->GetInt(TEXT("OnlineSubsystemEpic"), TEXT("SessionPingsPerHost"), this->PingsPerHost, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("SessionPingTimeout"), this->Timeout, GEngineIni);
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("SessionPingRate"), this->Rate, GEngineIni);
+	GConfig->GetInt(TEXT("OnlineSubsystemEpic"), TEXT("SessionPingMaxInFlight"), this->MaxInFlight, GEngineIni);
+	GConfig->GetBool(TEXT("OnlineSubsystemEpic"), TEXT("SortSearchResultsByPing"), this->bSortByPing, GEngineIni);
+
+	this->Port = FMath::Clamp(this->Port, 0, 65535);
+	this->PingsPerHost = FMath::Max(1, this->PingsPerHost);
+	this->Timeout = FMath::Max(0.01f, this->Timeout);
+	this->Rate = FMath::Max(1.f, this->Rate);
+	this->MaxInFlight = FMath::Max(1, this->MaxInFlight);
+	this->Tokens = this->MaxInFlight;
+
+	bool responder = false;
+	GConfig->GetBool(TEXT("OnlineSubsystemEpic"), TEXT("SessionPingResponder"), responder, GEngineIni);
+	if (responder)
+	{
+		this->StartResponder();
+	}
+}
+
+FSocket* FOnlineSessionPingerEpic::CreateSocket(TCHAR const* Description, int32 BindPort)
+{
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!socketSubsystem)
+	{
+		return nullptr;
+	}
+
+	FSocket* socket = socketSubsystem->CreateSocket(NAME_DGram, Description, true);
+	if (!socket)
+	{
+		return nullptr;
+	}
+
+	TSharedRef<FInternetAddr> address = socketSubsystem->CreateInternetAddr();
+	address->SetAnyAddress();
+	address->SetPort(BindPort);
+	if (!socket->SetNonBlocking(true) || !socket->Bind(*address))
+	{
+		socketSubsystem->DestroySocket(socket);
+		return nullptr;
+	}
+	return socket;
+}
+
+void FOnlineSessionPingerEpic::DestroySocket(FSocket*& Socket)
+{
+	if (Socket)
+	{
+		Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+		Socket = nullptr;
+	}
+}
+
+bool FOnlineSessionPingerEpic::StartResponder()
+{
+	if (this->ResponderSocket)
+	{
+		return true;
+	}
+	if (this->Port <= 0)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("Can't start the session ping responder, SessionPingPort is not set"));
+		return false;
+	}
+
+	this->ResponderSocket = CreateSocket(TEXT("EOS session ping responder"), this->Port);
+	UE_CLOG_ONLINE(!this->ResponderSocket, Warning, TEXT("Couldn't open the session ping responder on port %d"), this->Port);
+	UE_CLOG_ONLINE(this->ResponderSocket, Display, TEXT("Answering session pings on port %d"), this->Port);
+	return this->ResponderSocket != nullptr;
+}
+
+void FOnlineSessionPingerEpic::StopResponder()
+{
+	DestroySocket(this->ResponderSocket);
+}
+
+bool FOnlineSessionPingerEpic::Ping(TArray<TSharedPtr<FInternetAddr>> const& Hosts, FOnPingComplete&& OnComplete)
+{
+	if (!this->IsEnabled())
+	{
+		return false;
+	}
+
+	if (!this->ClientSocket)
+	{
+		this->ClientSocket = CreateSocket(TEXT("EOS session pinger"), 0);
+		if (!this->ClientSocket)
+		{
+			UE_LOG_ONLINE(Warning, TEXT("Couldn't open the session pinger socket"));
+			return false;
+		}
+	}
+
+	uint32 batchId = this->NextBatchId++;
+	FBatch& batch = this->Batches.Add(batchId, FBatch{ {}, {}, 0, MoveTemp(OnComplete) });
+	batch.Addresses.Reserve(Hosts.Num());
+	batch.PingsInMs.Init(MAX_QUERY_PING, Hosts.Num());
+
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	for (int32 i = 0; i < Hosts.Num(); ++i)
+	{
+		// Only the ip of the host is used, the ping goes to the ping port
+		TSharedPtr<FInternetAddr> address;
+		if (Hosts[i].IsValid() && Hosts[i]->IsValid())
+		{
+			bool bIsValid = false;
+			address = socketSubsystem->CreateInternetAddr();
+			address->SetIp(*Hosts[i]->ToString(false), bIsValid);
+			address->SetPort(this->Port);
+			if (!bIsValid)
+			{
+				address = nullptr;
+			}
+		}
+		batch.Addresses.Add(address);
+
+		if (address.IsValid())
+		{
+			for (int32 p = 0; p < this->PingsPerHost; ++p)
+			{
+				this->Queue.Add(FProbe{ batchId, i, 0 });
+			}
+			batch.Outstanding += this->PingsPerHost;
+		}
+	}
+
+	// Completed from Tick, even if there is nothing to ping, so the callback never runs inside this call
+	return true;
+}
+
+void FOnlineSessionPingerEpic::Tick(float DeltaTime)
+{
+	if (this->ResponderSocket)
+	{
+		this->Respond();
+	}
+
+	if (this->Batches.Num() == 0)
+	{
+		return;
+	}
+
+	double now = FPlatformTime::Seconds();
+	this->ReceiveAnswers(now);
+
+	// Pings that weren't answered in time count as lost
+	TArray<uint32> lost;
+	for (TPair<uint32, FProbe> const& probe : this->InFlight)
+	{
+		if (now - probe.Value.SendTime >= this->Timeout)
+		{
+			lost.Add(probe.Key);
+		}
+	}
+	for (uint32 sequence : lost)
+	{
+		FProbe probe;
+		if (this->InFlight.RemoveAndCopyValue(sequence, probe))
+		{
+			this->FinishProbe(probe.BatchId);
+		}
+	}
+
+	this->SendQueued(now);
+
+	// Complete the batches whose pings were all answered or lost
+	TArray<uint32> done;
+	for (TPair<uint32, FBatch> const& batch : this->Batches)
+	{
+		if (batch.Value.Outstanding == 0)
+		{
+			done.Add(batch.Key);
+		}
+	}
+	for (uint32 batchId : done)
+	{
+		// Taken out first, the callback may start new pings
+		FBatch batch = this->Batches.FindAndRemoveChecked(batchId);
+		batch.OnComplete(batch.PingsInMs);
+	}
+}
+
+void FOnlineSessionPingerEpic::Respond()
+{
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> source = socketSubsystem->CreateInternetAddr();
+
+	uint8 buffer[64];
+	int32 bytesRead = 0;
+	for (int32 i = 0; i < MaxReadsPerTick && this->ResponderSocket->RecvFrom(buffer, sizeof(buffer), bytesRead, *source); ++i)
+	{
+		// Anything that isn't a ping is ignored, so the responder can't be used to reflect other traffic
+		if (IsPingPacket(buffer, bytesRead))
+		{
+			int32 bytesSent = 0;
+			this->ResponderSocket->SendTo(buffer, bytesRead, bytesSent, *source);
+			this->Answered += 1;
+		}
+	}
+}
+
+void FOnlineSessionPingerEpic::ReceiveAnswers(double Now)
+{
+	ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	TSharedRef<FInternetAddr> source = socketSubsystem->CreateInternetAddr();
+
+	uint8 buffer[64];
+	int32 bytesRead = 0;
+	for (int32 i = 0; i < MaxReadsPerTick && this->ClientSocket->RecvFrom(buffer, sizeof(buffer), bytesRead, *source); ++i)
+	{
+		if (!IsPingPacket(buffer, bytesRead))
+		{
+			continue;
+		}
+
+		uint32 nonce;
+		uint32 sequence;
+		FMemory::Memcpy(&nonce, buffer + sizeof(PingMagic), sizeof(uint32));
+		FMemory::Memcpy(&sequence, buffer + sizeof(PingMagic) + sizeof(uint32), sizeof(uint32));
+
+		// Late answers of pings that timed out already are dropped here as well
+		FProbe probe;
+		if (nonce != this->Nonce || !this->InFlight.RemoveAndCopyValue(sequence, probe))
+		{
+			continue;
+		}
+
+		if (FBatch* batch = this->Batches.Find(probe.BatchId))
+		{
+			int32 pingInMs = FMath::Max(0, FMath::RoundToInt((Now - probe.SendTime) * 1000.0));
+			batch->PingsInMs[probe.HostIndex] = FMath::Min(batch->PingsInMs[probe.HostIndex], pingInMs);
+		}
+		this->FinishProbe(probe.BatchId);
+	}
+}
+
+void FOnlineSessionPingerEpic::SendQueued(double Now)
+{
+	this->Tokens = FMath::Min<float>(this->MaxInFlight, this->Tokens + (Now - this->LastRefillTime) * this->Rate);
+	this->LastRefillTime = Now;
+
+	int32 sent = 0;
+	while (sent < this->Queue.Num() && this->Tokens >= 1.f && this->InFlight.Num() < this->MaxInFlight)
+	{
+		FProbe probe = this->Queue[sent];
+		sent += 1;
+
+		FBatch* batch = this->Batches.Find(probe.BatchId);
+		if (!batch)
+		{
+			continue;
+		}
+
+		uint32 sequence = this->NextSequence++;
+		uint8 packet[PingPacketSize];
+		FMemory::Memcpy(packet, PingMagic, sizeof(PingMagic));
+		FMemory::Memcpy(packet + sizeof(PingMagic), &this->Nonce, sizeof(uint32));
+		FMemory::Memcpy(packet + sizeof(PingMagic) + sizeof(uint32), &sequence, sizeof(uint32));
+
+		// A ping that couldn't be sent counts as lost
+		int32 bytesSent = 0;
+		if (!this->ClientSocket->SendTo(packet, PingPacketSize, bytesSent, *batch->Addresses[probe.HostIndex]) || bytesSent != PingPacketSize)
+		{
+			this->FinishProbe(probe.BatchId);
+			continue;
+		}
+
+		probe.SendTime = FPlatformTime::Seconds();
+		this->InFlight.Add(sequence, probe);
+		this->Tokens -= 1.f;
+	}
+	this->Queue.RemoveAt(0, sent, false);
+}
+
+void FOnlineSessionPingerEpic::FinishProbe(uint32 BatchId)
+{
+	if (FBatch* batch = this->Batches.Find(BatchId))
+	{
+		batch->Outstanding -= 1;
+	}
+}
+
+void FOnlineSessionPingerEpic::Reset()
+{
+	this->Batches.Empty();
+	this->Queue.Empty();
+	this->InFlight.Empty();
+	DestroySocket(this->ClientSocket);
+	DestroySocket(this->ResponderSocket);
+}
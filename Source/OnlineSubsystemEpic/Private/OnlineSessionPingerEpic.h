@@ -0,0 +1,152 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FSocket;
+class FInternetAddr;
+
+/**
+ * Measures the round trip time to session hosts with UDP echo pings.
+ * Clients send small datagrams to the ping port of each host, the responder of the host sends them back unchanged.
+ * Every host gets a few pings, the fastest answer counts. Pings are paced and only a limited number is in flight,
+ * so pinging a large search doesn't flood the network.
+ * Servers enable the responder, clients ping. Both run on the same port, set in the engine config.
+ * The pinger is not thread safe, it is used from the game thread only.
+ */
+class FOnlineSessionPingerEpic
+{
+public:
+	/** Receives the round trip time of each host in milliseconds, in the order they were passed. MAX_QUERY_PING for hosts that didn't answer */
+	using FOnPingComplete = TUniqueFunction<void(TArray<int32> const& PingsInMs)>;
+
+	FOnlineSessionPingerEpic();
+	~FOnlineSessionPingerEpic();
+
+	/** Reads the ping settings from the OnlineSubsystemEpic section of the engine config, and starts the responder if it is enabled */
+	void LoadConfig();
+
+	/** Whether hosts can be pinged. Pinging is disabled if no ping port is set */
+	bool IsEnabled() const
+	{
+		return this->Port > 0;
+	}
+
+	/**
+	 * Pings hosts
+	 * @param Hosts - The hosts to ping. Only their ip is used, the pings go to the ping port. Invalid addresses count as not answering
+	 * @param OnComplete - Called from Tick once every host answered or timed out
+	 * @returns - True if the pings were queued. OnComplete is only called in that case
+	 */
+	bool Ping(TArray<TSharedPtr<FInternetAddr>> const& Hosts, FOnPingComplete&& OnComplete);
+
+	/** Starts answering the pings of clients on the ping port. Returns true if the responder is running */
+	bool StartResponder();
+
+	/** Stops answering pings */
+	void StopResponder();
+
+	/** Sends queued pings, and handles answers and timeouts */
+	void Tick(float DeltaTime);
+
+	/** Drops all pings without calling their callbacks, and closes the sockets */
+	void Reset();
+
+	/** Whether the responder answers pings */
+	bool IsResponding() const
+	{
+		return this->ResponderSocket != nullptr;
+	}
+
+	/** The number of pings answered by the responder */
+	uint64 GetAnsweredCount() const
+	{
+		return this->Answered;
+	}
+
+	/** Whether the round trip time of search results is used to sort them */
+	bool ShouldSortByPing() const
+	{
+		return this->bSortByPing;
+	}
+
+private:
+	/** A set of hosts pinged by a single call */
+	struct FBatch
+	{
+		/** The hosts, with the ping port set */
+		TArray<TSharedPtr<FInternetAddr>> Addresses;
+
+		/** The fastest answer of each host so far */
+		TArray<int32> PingsInMs;
+
+		/** The number of pings that weren't answered and didn't time out yet */
+		int32 Outstanding;
+
+		FOnPingComplete OnComplete;
+	};
+
+	/** A single ping */
+	struct FProbe
+	{
+		uint32 BatchId;
+		int32 HostIndex;
+
+		/** The time the ping was sent, zero while it is queued */
+		double SendTime;
+	};
+
+	/** Creates a non-blocking UDP socket bound to the port. Null on failure */
+	static FSocket* CreateSocket(TCHAR const* Description, int32 BindPort);
+	static void DestroySocket(FSocket*& Socket);
+
+	/** Sends the answers to the pings that arrived at the responder */
+	void Respond();
+
+	/** Reads the answers to our pings */
+	void ReceiveAnswers(double Now);
+
+	/** Sends queued pings as far as the rate and the in flight limit allow */
+	void SendQueued(double Now);
+
+	/** Counts a ping as done, and completes its batch after the last one */
+	void FinishProbe(uint32 BatchId);
+
+	/** The port the responder listens on and pings are sent to */
+	int32 Port;
+
+	/** The number of pings per host */
+	int32 PingsPerHost;
+
+	/** The time in seconds a ping may take */
+	float Timeout;
+
+	/** The number of pings sent per second */
+	float Rate;
+
+	/** The number of pings in flight at the same time */
+	int32 MaxInFlight;
+
+	bool bSortByPing;
+
+	/** Pings that may be sent right now, refilled with the rate */
+	float Tokens;
+	double LastRefillTime;
+
+	FSocket* ClientSocket;
+	FSocket* ResponderSocket;
+
+	TMap<uint32, FBatch> Batches;
+	uint32 NextBatchId;
+
+	/** Pings waiting to be sent, the oldest first */
+	TArray<FProbe> Queue;
+
+	/** Pings sent and not answered yet, by sequence number */
+	TMap<uint32, FProbe> InFlight;
+	uint32 NextSequence;
+
+	/** Random per pinger, so answers to the pings of an earlier run are not mistaken for ours */
+	uint32 Nonce;
+
+	uint64 Answered;
+};
@@ -0,0 +1,467 @@
+#include "OnlineSessionSearchFilterEpic.h"
+
+namespace
+{
+	/** The comparison result of a missing or incomparable value. Matches no comparison op */
+	constexpr int8 MissingValue = 2;
+
+	/** Reads a whole number. Bools count as 0 and 1 */
+	bool ToInteger(FVariantData const& Data, FOnlineSessionSearchFilterEpic::FInteger& OutValue)
+	{
+		int64 value = 0;
+		switch (Data.GetType())
+		{
+		case EOnlineKeyValuePairDataType::Bool:
+		{
+			bool boolValue;
+			Data.GetValue(boolValue);
+			value = boolValue ? 1 : 0;
+			break;
+		}
+		case EOnlineKeyValuePairDataType::Int32:
+		{
+			int32 intValue;
+			Data.GetValue(intValue);
+			value = intValue;
+			break;
+		}
+		case EOnlineKeyValuePairDataType::UInt32:
+		{
+			uint32 intValue;
+			Data.GetValue(intValue);
+			value = intValue;
+			break;
+		}
+		case EOnlineKeyValuePairDataType::Int64:
+			Data.GetValue(value);
+			break;
+		case EOnlineKeyValuePairDataType::UInt64:
+		{
+			// The only values that don't fit into an int64, they're never negative
+			uint64 unsignedValue;
+			Data.GetValue(unsignedValue);
+			OutValue = { 0, unsignedValue };
+			return true;
+		}
+		default:
+			return false;
+		}
+
+		OutValue = { value < 0 ? -1 : 0, static_cast<uint64>(value) };
+		return true;
+	}
+
+	/** The distance of two whole numbers, capped at the largest uint64 */
+	uint64 Distance(FOnlineSessionSearchFilterEpic::FInteger const& A, FOnlineSessionSearchFilterEpic::FInteger const& B)
+	{
+		bool bALess = A.High < B.High || (A.High == B.High && A.Low < B.Low);
+		FOnlineSessionSearchFilterEpic::FInteger const& low = bALess ? A : B;
+		FOnlineSessionSearchFilterEpic::FInteger const& high = bALess ? B : A;
+
+		// The high words differ by at most one, as both values fit into an int64 or a uint64
+		uint64 distance = high.Low - low.Low;
+		return high.High != low.High && high.Low >= low.Low ? MAX_uint64 : distance;
+	}
+
+	/** Reads a value that can be ordered as a number. Bools count as 0 and 1 */
+	bool ToNumber(FVariantData const& Data, double& OutValue)
+	{
+		switch (Data.GetType())
+		{
+		case EOnlineKeyValuePairDataType::Bool:
+		{
+			bool value;
+			Data.GetValue(value);
+			OutValue = value ? 1 : 0;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::Int32:
+		{
+			int32 value;
+			Data.GetValue(value);
+			OutValue = value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::UInt32:
+		{
+			uint32 value;
+			Data.GetValue(value);
+			OutValue = value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::Int64:
+		{
+			int64 value;
+			Data.GetValue(value);
+			OutValue = static_cast<double>(value);
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::UInt64:
+		{
+			uint64 value;
+			Data.GetValue(value);
+			OutValue = static_cast<double>(value);
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::Float:
+		{
+			float value;
+			Data.GetValue(value);
+			OutValue = value;
+			return true;
+		}
+		case EOnlineKeyValuePairDataType::Double:
+			Data.GetValue(OutValue);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	bool IsText(EOnlineKeyValuePairDataType::Type DataType)
+	{
+		return DataType == EOnlineKeyValuePairDataType::String || DataType == EOnlineKeyValuePairDataType::Json;
+	}
+
+	FVariantData const* FindSetting(FOnlineSessionSearchResult const& Result, FName Key)
+	{
+		FOnlineSessionSetting const* setting = Result.Session.SessionSettings.Settings.Find(Key);
+		return setting ? &setting->Data : nullptr;
+	}
+
+	/** Orders the results by their distance, keeping the order of results with the same distance */
+	template<typename DistanceType>
+	void SortByDistance(TArray<FOnlineSessionSearchResult>& Results, TArray<DistanceType> const& Distances)
+	{
+		int32 count = Results.Num();
+		TArray<int32> order;
+		order.SetNumUninitialized(count);
+		for (int32 i = 0; i < count; ++i)
+		{
+			order[i] = i;
+		}
+		order.StableSort([&Distances](int32 A, int32 B)
+			{
+				return Distances[A] < Distances[B];
+			});
+
+		TArray<FOnlineSessionSearchResult> sorted;
+		sorted.Reserve(count);
+		for (int32 index : order)
+		{
+			sorted.Add(MoveTemp(Results[index]));
+		}
+		Results = MoveTemp(sorted);
+	}
+}
+
+FOnlineSessionSearchFilterEpic::FOnlineSessionSearchFilterEpic(FOnlineSearchSettings const& QuerySettings)
+{
+	for (TPair<FName, FOnlineSessionSearchParam> const& param : QuerySettings.SearchParams)
+	{
+		if (IsSupportedByBackend(param.Value))
+		{
+			continue;
+		}
+
+		FPredicate predicate{ param.Key, param.Value.Data, param.Value.ComparisonOp };
+		if (predicate.ComparisonOp == EOnlineComparisonOp::Near)
+		{
+			this->Near = MoveTemp(predicate);
+		}
+		else
+		{
+			this->Predicates.Add(MoveTemp(predicate));
+		}
+	}
+}
+
+bool FOnlineSessionSearchFilterEpic::IsSupportedByBackend(FOnlineSessionSearchParam const& Param)
+{
+	switch (Param.ComparisonOp)
+	{
+	case EOnlineComparisonOp::Equals:
+	case EOnlineComparisonOp::NotEquals:
+		// Values the SDK has no type for are sent in an exact encoding, so they can still be matched
+		return true;
+	case EOnlineComparisonOp::GreaterThan:
+	case EOnlineComparisonOp::GreaterThanEquals:
+	case EOnlineComparisonOp::LessThan:
+	case EOnlineComparisonOp::LessThanEquals:
+	case EOnlineComparisonOp::Near:
+		// UInt64 values are sent as strings
+		return Param.Data.IsNumeric() && Param.Data.GetType() != EOnlineKeyValuePairDataType::UInt64;
+	case EOnlineComparisonOp::In:
+	case EOnlineComparisonOp::NotIn:
+		return Param.Data.GetType() == EOnlineKeyValuePairDataType::String;
+	default:
+		return false;
+	}
+}
+
+void FOnlineSessionSearchFilterEpic::ReadNumbers(TArray<FOnlineSessionSearchResult> const& Results, int32 FirstIndex, FName Key, TArray<double>& OutValues, TArray<int8>& OutPresent)
+{
+	int32 count = Results.Num() - FirstIndex;
+	OutValues.SetNumUninitialized(count);
+	OutPresent.SetNumUninitialized(count);
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		FVariantData const* data = FindSetting(Results[FirstIndex + i], Key);
+		OutValues[i] = 0;
+		OutPresent[i] = data && ToNumber(*data, OutValues[i]) ? 1 : 0;
+	}
+}
+
+void FOnlineSessionSearchFilterEpic::ReadIntegers(TArray<FOnlineSessionSearchResult> const& Results, int32 FirstIndex, FName Key, TArray<FInteger>& OutValues, TArray<int8>& OutPresent)
+{
+	int32 count = Results.Num() - FirstIndex;
+	OutValues.SetNumUninitialized(count);
+	OutPresent.SetNumUninitialized(count);
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		FVariantData const* data = FindSetting(Results[FirstIndex + i], Key);
+		OutValues[i] = { 0, 0 };
+		OutPresent[i] = data && ToInteger(*data, OutValues[i]) ? 1 : 0;
+	}
+}
+
+void FOnlineSessionSearchFilterEpic::CompareColumn(TArray<FOnlineSessionSearchResult> const& Results, int32 FirstIndex, FPredicate const& Predicate, TArray<int8>& OutCompared)
+{
+	int32 count = Results.Num() - FirstIndex;
+	OutCompared.SetNumUninitialized(count);
+
+	// Whole numbers are compared as such, 64 bit values don't fit into a double
+	FInteger targetInteger;
+	if (ToInteger(Predicate.Value, targetInteger))
+	{
+		TArray<FInteger> values;
+		TArray<int8> present;
+		ReadIntegers(Results, FirstIndex, Predicate.Key, values, present);
+
+		FInteger const* value = values.GetData();
+		int8 const* isPresent = present.GetData();
+		int8* compared = OutCompared.GetData();
+		for (int32 i = 0; i < count; ++i)
+		{
+			int8 highOrder = static_cast<int8>((value[i].High > targetInteger.High) - (value[i].High < targetInteger.High));
+			int8 lowOrder = static_cast<int8>((value[i].Low > targetInteger.Low) - (value[i].Low < targetInteger.Low));
+			int8 order = highOrder != 0 ? highOrder : lowOrder;
+			compared[i] = isPresent[i] * order + (1 - isPresent[i]) * MissingValue;
+		}
+
+		// Floating point values of the attribute are compared with the closest double
+		double target;
+		ToNumber(Predicate.Value, target);
+		for (int32 i = 0; i < count; ++i)
+		{
+			double number;
+			FVariantData const* data = isPresent[i] ? nullptr : FindSetting(Results[FirstIndex + i], Predicate.Key);
+			if (data && ToNumber(*data, number))
+			{
+				compared[i] = static_cast<int8>((number > target) - (number < target));
+			}
+		}
+		return;
+	}
+
+	double target;
+	if (ToNumber(Predicate.Value, target))
+	{
+		TArray<double> values;
+		TArray<int8> present;
+		ReadNumbers(Results, FirstIndex, Predicate.Key, values, present);
+
+		double const* value = values.GetData();
+		int8 const* isPresent = present.GetData();
+		int8* compared = OutCompared.GetData();
+		for (int32 i = 0; i < count; ++i)
+		{
+			int8 order = static_cast<int8>((value[i] > target) - (value[i] < target));
+			compared[i] = isPresent[i] * order + (1 - isPresent[i]) * MissingValue;
+		}
+		return;
+	}
+
+	// Text and blobs are compared one by one, the rest of the evaluation still runs over the column
+	EOnlineKeyValuePairDataType::Type targetType = Predicate.Value.GetType();
+	FString targetText = IsText(targetType) ? Predicate.Value.ToString() : FString();
+	TArray<uint8> targetBlob;
+	if (targetType == EOnlineKeyValuePairDataType::Blob)
+	{
+		Predicate.Value.GetValue(targetBlob);
+	}
+
+	for (int32 i = 0; i < count; ++i)
+	{
+		FVariantData const* data = FindSetting(Results[FirstIndex + i], Predicate.Key);
+		OutCompared[i] = MissingValue;
+		if (data && IsText(targetType) && IsText(data->GetType()))
+		{
+			int32 order = data->ToString().Compare(targetText, ESearchCase::CaseSensitive);
+			OutCompared[i] = static_cast<int8>((order > 0) - (order < 0));
+		}
+		else if (data && targetType == EOnlineKeyValuePairDataType::Blob && data->GetType() == EOnlineKeyValuePairDataType::Blob)
+		{
+			TArray<uint8> blob;
+			data->GetValue(blob);
+			int32 order = FMemory::Memcmp(blob.GetData(), targetBlob.GetData(), FMath::Min(blob.Num(), targetBlob.Num()));
+			if (order == 0)
+			{
+				order = blob.Num() - targetBlob.Num();
+			}
+			OutCompared[i] = static_cast<int8>((order > 0) - (order < 0));
+		}
+	}
+}
+
+void FOnlineSessionSearchFilterEpic::Filter(TArray<FOnlineSessionSearchResult>& Results, int32 FirstIndex) const
+{
+	int32 count = Results.Num() - FirstIndex;
+	if (this->Predicates.Num() == 0 || count <= 0)
+	{
+		return;
+	}
+
+	TArray<uint8> keepRows;
+	keepRows.Init(1, count);
+
+	TArray<int8> comparedRows;
+	for (FPredicate const& predicate : this->Predicates)
+	{
+		CompareColumn(Results, FirstIndex, predicate, comparedRows);
+
+		int8 const* compared = comparedRows.GetData();
+		uint8* keep = keepRows.GetData();
+		switch (predicate.ComparisonOp)
+		{
+		case EOnlineComparisonOp::Equals:
+		case EOnlineComparisonOp::In:
+			for (int32 i = 0; i < count; ++i)
+			{
+				keep[i] &= compared[i] == 0;
+			}
+			break;
+		case EOnlineComparisonOp::NotEquals:
+		case EOnlineComparisonOp::NotIn:
+			for (int32 i = 0; i < count; ++i)
+			{
+				keep[i] &= (compared[i] == -1) | (compared[i] == 1);
+			}
+			break;
+		case EOnlineComparisonOp::GreaterThan:
+			for (int32 i = 0; i < count; ++i)
+			{
+				keep[i] &= compared[i] == 1;
+			}
+			break;
+		case EOnlineComparisonOp::GreaterThanEquals:
+			for (int32 i = 0; i < count; ++i)
+			{
+				keep[i] &= (compared[i] == 0) | (compared[i] == 1);
+			}
+			break;
+		case EOnlineComparisonOp::LessThan:
+			for (int32 i = 0; i < count; ++i)
+			{
+				keep[i] &= compared[i] == -1;
+			}
+			break;
+		case EOnlineComparisonOp::LessThanEquals:
+			for (int32 i = 0; i < count; ++i)
+			{
+				keep[i] &= (compared[i] == -1) | (compared[i] == 0);
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	// Move the matching results together, in their order
+	int32 kept = FirstIndex;
+	for (int32 i = 0; i < count; ++i)
+	{
+		if (keepRows[i])
+		{
+			if (kept != FirstIndex + i)
+			{
+				Results[kept] = MoveTemp(Results[FirstIndex + i]);
+			}
+			kept += 1;
+		}
+	}
+	Results.SetNum(kept, false);
+}
+
+void FOnlineSessionSearchFilterEpic::Finish(TArray<FOnlineSessionSearchResult>& Results, int32 MaxResults) const
+{
+	if (this->Near.IsSet() && Results.Num() > 1)
+	{
+		FPredicate const& near = this->Near.GetValue();
+		int32 count = Results.Num();
+
+		// Numbers are ordered by their distance to the value, anything else puts equal values first
+		double target;
+		FInteger targetInteger;
+		if (ToInteger(near.Value, targetInteger))
+		{
+			// Whole numbers get their exact distance, the ones of floating point values are rounded
+			TArray<FInteger> values;
+			TArray<int8> present;
+			ReadIntegers(Results, 0, near.Key, values, present);
+			ToNumber(near.Value, target);
+
+			TArray<uint64> integerDistances;
+			integerDistances.SetNumUninitialized(count);
+			for (int32 i = 0; i < count; ++i)
+			{
+				double number;
+				FVariantData const* data = present[i] ? nullptr : FindSetting(Results[i], near.Key);
+				if (present[i])
+				{
+					integerDistances[i] = Distance(values[i], targetInteger);
+				}
+				else if (data && ToNumber(*data, number))
+				{
+					double distance = FMath::Abs(number - target);
+					integerDistances[i] = distance < 18446744073709551616.0 ? static_cast<uint64>(distance) : MAX_uint64;
+				}
+				else
+				{
+					integerDistances[i] = MAX_uint64;
+				}
+			}
+			SortByDistance(Results, integerDistances);
+		}
+		else if (ToNumber(near.Value, target))
+		{
+			TArray<double> distances;
+			TArray<int8> present;
+			ReadNumbers(Results, 0, near.Key, distances, present);
+			for (int32 i = 0; i < count; ++i)
+			{
+				distances[i] = present[i] ? FMath::Abs(distances[i] - target) : MAX_dbl;
+			}
+			SortByDistance(Results, distances);
+		}
+		else
+		{
+			TArray<int8> compared;
+			CompareColumn(Results, 0, near, compared);
+			TArray<double> distances;
+			distances.SetNumUninitialized(count);
+			for (int32 i = 0; i < count; ++i)
+			{
+				distances[i] = compared[i] == MissingValue ? MAX_dbl : (compared[i] == 0 ? 0 : 1);
+			}
+			SortByDistance(Results, distances);
+		}
+	}
+
+	if (MaxResults > 0 && Results.Num() > MaxResults)
+	{
+		Results.SetNum(MaxResults);
+	}
+}
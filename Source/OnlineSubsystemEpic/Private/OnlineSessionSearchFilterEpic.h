@@ -0,0 +1,67 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineSessionSettings.h"
+
+/**
+ * Evaluates the search parameters the backend can't, on the results of a search.
+ * The backend only orders numbers, and only matches strings against lists. Everything else, e.g. ordering strings,
+ * Near on non-numeric values, In on numbers, or any ordering of UInt64, Json and Blob values, is left to this filter.
+ * A predicate is evaluated over all results at once: the attribute is read into a column, then compared in a loop
+ * without branches, which the compiler can vectorize.
+ * Results missing an attribute don't match any predicate on it.
+ */
+class FOnlineSessionSearchFilterEpic
+{
+public:
+	/** Collects the parameters of a search the backend can't evaluate */
+	explicit FOnlineSessionSearchFilterEpic(FOnlineSearchSettings const& QuerySettings);
+
+	/** Whether the backend can evaluate a search parameter, given how the attribute schema sends its value */
+	static bool IsSupportedByBackend(FOnlineSessionSearchParam const& Param);
+
+	/** Whether all parameters are evaluated by the backend */
+	bool IsEmpty() const
+	{
+		return this->Predicates.Num() == 0 && !this->Near.IsSet();
+	}
+
+	/**
+	 * Removes the results that don't match every predicate, keeping the order of the others
+	 * @param Results - The results of the search
+	 * @param FirstIndex - The first result to filter, the ones before it were filtered already
+	 */
+	void Filter(TArray<FOnlineSessionSearchResult>& Results, int32 FirstIndex) const;
+
+	/** Orders the results by the Near parameter, if the backend couldn't, and drops the results past the limit */
+	void Finish(TArray<FOnlineSessionSearchResult>& Results, int32 MaxResults) const;
+
+	/** A whole number as a 128 bit two's complement value, so int64 and uint64 values compare exactly */
+	struct FInteger
+	{
+		int64 High;
+		uint64 Low;
+	};
+
+private:
+	struct FPredicate
+	{
+		FName Key;
+		FVariantData Value;
+		EOnlineComparisonOp::Type ComparisonOp;
+	};
+
+	/** Reads the attribute of each result as a number. OutPresent is 0 for results without a numeric value */
+	static void ReadNumbers(TArray<FOnlineSessionSearchResult> const& Results, int32 FirstIndex, FName Key, TArray<double>& OutValues, TArray<int8>& OutPresent);
+
+	/** Reads the attribute of each result as a whole number. OutPresent is 0 for results without a whole number */
+	static void ReadIntegers(TArray<FOnlineSessionSearchResult> const& Results, int32 FirstIndex, FName Key, TArray<FInteger>& OutValues, TArray<int8>& OutPresent);
+
+	/** Compares the attribute of each result with the value of the predicate, into -1, 0 or 1. Missing or incomparable values get 2 */
+	static void CompareColumn(TArray<FOnlineSessionSearchResult> const& Results, int32 FirstIndex, FPredicate const& Predicate, TArray<int8>& OutCompared);
+
+	TArray<FPredicate> Predicates;
+
+	/** The Near parameter, if the backend can't evaluate it */
+	TOptional<FPredicate> Near;
+};
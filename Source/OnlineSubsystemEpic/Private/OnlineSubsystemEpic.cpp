@@ -2,7 +2,17 @@
 #include "OnlineIdentityInterfaceEpic.h"
 #include "OnlineSessionInterfaceEpic.h"
 #include "OnlineUserInterfaceEpic.h"
+#include "OnlinePresenceEpic.h"
+#include "OnlineRetryPolicyEpic.h"
+#include "OnlineRateLimiterEpic.h"
+#include "OnlineReconnectSchedulerEpic.h"
+#include "OnlineBotFarmEpic.h"
+#include "OnlineWriteJournalEpic.h"
+#include "OnlineSessionAttributeSchemaEpic.h"
+#include "OnlineSessionPingerEpic.h"
 #include "Utilities.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
 #include <string>
 
 #include "Interfaces/VoiceInterface.h"
@@ -368,11 +378,39 @@ bool FOnlineSubsystemEpic::Init()
 		return false;
 	}
 
+	this->RetryPolicy = MakeShared<FOnlineRetryPolicyEpic>();
+	this->RetryPolicy->LoadConfig();
+
+	this->RateLimiter = MakeShared<FOnlineRateLimiterEpic>();
+	this->RateLimiter->LoadConfig();
+
+	this->ReconnectScheduler = MakeShared<FOnlineReconnectSchedulerEpic>();
+	this->ReconnectScheduler->LoadConfig();
+
+	this->BotFarm = MakeShared<FOnlineBotFarmEpic>(this);
+	this->BotFarm->LoadConfig();
+
+	this->WriteJournal = MakeShared<FOnlineWriteJournalEpic>(this);
+	this->WriteJournal->LoadConfig();
+
+	this->SessionAttributeSchema = MakeShared<FOnlineSessionAttributeSchemaEpic>();
+
+	this->SessionPinger = MakeShared<FOnlineSessionPingerEpic>();
+	this->SessionPinger->LoadConfig();
+
 	this->IdentityInterface = MakeShareable(new FOnlineIdentityInterfaceEpic(this));
 	this->SessionInterface = MakeShareable(new FOnlineSessionEpic(this));
 	this->UserInterface = MakeShareable(new FOnlineUserEpic(this));
 	this->PresenceInterface = MakeShared<FOnlinePresenceEpic, ESPMode::ThreadSafe>(this);
 
+	// Log in the first user while the engine is still starting up, instead of waiting for the game to ask for it
+	bool earlyAutoLogin = false;
+	GConfig->GetBool(TEXT("OnlineSubsystemEpic"), TEXT("EarlyAutoLogin"), earlyAutoLogin, GEngineIni);
+	if (earlyAutoLogin)
+	{
+		this->IdentityInterface->StartEarlyAutoLogin();
+	}
+
 	this->IsInit = true;
 	return true;
 }
@@ -381,6 +419,24 @@ bool FOnlineSubsystemEpic::Shutdown()
 {
 	UE_LOG_ONLINE(VeryVerbose, TEXT("FOnlineSubsystemEpic::Shutdown()"));
 	
+	// Complete the futures of operations that are still running, while everything they might call is still there
+	if (this->IdentityInterface)
+	{
+		this->IdentityInterface->FailPendingFutures();
+	}
+	if (this->SessionInterface)
+	{
+		this->SessionInterface->FailPendingFutures();
+	}
+	if (this->UserInterface)
+	{
+		this->UserInterface->FailPendingFutures();
+	}
+	if (this->PresenceInterface)
+	{
+		this->PresenceInterface->FailPendingFutures();
+	}
+
 	FOnlineSubsystemImpl::Shutdown();
 	
 	this->IsInit = false;
@@ -391,6 +447,40 @@ bool FOnlineSubsystemEpic::Shutdown()
 		VoiceInterface->Shutdown();
 	}
 	
+	// Pending retries and queued requests reference the interfaces, fail them first.
+	// They complete through the SDK callbacks, which ask the retry policy again, so both are destroyed only afterwards.
+	// The bots are reset before, so mints failed here don't start new ones.
+	if (this->BotFarm)
+	{
+		this->BotFarm->Reset();
+	}
+	if (this->RetryPolicy)
+	{
+		this->RetryPolicy->Reset();
+	}
+	if (this->RateLimiter)
+	{
+		this->RateLimiter->Reset();
+	}
+	this->RetryPolicy = nullptr;
+	this->RateLimiter = nullptr;
+	this->BotFarm = nullptr;
+	if (this->ReconnectScheduler)
+	{
+		this->ReconnectScheduler->Reset();
+		this->ReconnectScheduler = nullptr;
+	}
+	if (this->WriteJournal)
+	{
+		this->WriteJournal->Reset();
+		this->WriteJournal = nullptr;
+	}
+	if (this->SessionPinger)
+	{
+		this->SessionPinger->Reset();
+		this->SessionPinger = nullptr;
+	}
+
 #define DESTRUCT_INTERFACE(Interface) \
 	if (Interface.IsValid()) \
 	{ \
@@ -407,9 +497,86 @@ bool FOnlineSubsystemEpic::Shutdown()
 
 #undef DESTRUCT_INTERFACE
 
+	this->SessionAttributeSchema = nullptr;
+
 	return true;
 }
 
+bool FOnlineSubsystemEpic::Exec(UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar)
+{
+	if (FOnlineSubsystemImpl::Exec(InWorld, Cmd, Ar))
+	{
+		return true;
+	}
+
+#if !UE_BUILD_SHIPPING
+	// PING RESPOND answers pings, PING <Ip> pings a host. Both on the same machine test the pinger over loopback.
+	if (FParse::Command(&Cmd, TEXT("PING")))
+	{
+		if (!this->SessionPinger)
+		{
+			return false;
+		}
+
+		if (FParse::Command(&Cmd, TEXT("RESPOND")))
+		{
+			Ar.Logf(TEXT("%s"), this->SessionPinger->StartResponder() ? TEXT("Answering session pings") : TEXT("Couldn't start the session ping responder"));
+			return true;
+		}
+
+		FString host = FParse::Token(Cmd, false);
+		bool bIsValid = false;
+		TSharedPtr<FInternetAddr> address = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
+		address->SetIp(*host, bIsValid);
+		if (!bIsValid)
+		{
+			Ar.Logf(TEXT("Usage: PING RESPOND | PING <Ip>"));
+			return true;
+		}
+
+		bool started = this->SessionPinger->Ping({ address }, [host](TArray<int32> const& PingsInMs)
+			{
+				UE_LOG_ONLINE(Display, TEXT("Ping to %s: %d ms"), *host, PingsInMs[0]);
+			});
+		Ar.Logf(TEXT("%s"), started ? TEXT("Pinging") : TEXT("Can't ping, SessionPingPort is not set"));
+		return true;
+	}
+
+	if (!FParse::Command(&Cmd, TEXT("BOTS")) || !this->BotFarm)
+	{
+		return false;
+	}
+
+	// Minting replaces device ids, the commands stay off unless the config asks for them
+	if (!this->BotFarm->AreCommandsEnabled())
+	{
+		Ar.Logf(TEXT("The bot farm commands are disabled, set BotFarmCommands=true to use them"));
+		return true;
+	}
+
+	if (FParse::Command(&Cmd, TEXT("ADD")))
+	{
+		int32 count = FCString::Atoi(*FParse::Token(Cmd, false));
+		this->BotFarm->AddBots(count);
+		Ar.Logf(TEXT("Adding %d bots. Only a device id the bot farm created is replaced, nothing is minted once a player logged in with a device id on this device"), count);
+		return true;
+	}
+	if (FParse::Command(&Cmd, TEXT("STATUS")))
+	{
+		Ar.Logf(TEXT("%d of %d bots are logged in"), this->BotFarm->NumLoggedIn(), this->BotFarm->Num());
+		return true;
+	}
+	if (FParse::Command(&Cmd, TEXT("RESET")))
+	{
+		this->BotFarm->Reset();
+		Ar.Logf(TEXT("Dropped all bots"));
+		return true;
+	}
+#endif
+
+	return false;
+}
+
 FString FOnlineSubsystemEpic::GetAppId() const
 {
 	// The AppId is a combination of the Projects id and a version in the form of:
@@ -441,6 +608,180 @@ FText FOnlineSubsystemEpic::GetOnlineServiceName() const
 	return NSLOCTEXT("OnlineSubsystemEpic", "OnlineServiceName", "Epic");
 }
 
+// ---------------------------------------------
+// Future based API
+//
+// Forwards to the interfaces, so game modules can use the API through the exported subsystem class.
+// ---------------------------------------------
+
+namespace
+{
+	/** A future that is completed already, for calls made while the interface doesn't exist */
+	template<typename ResultType>
+	TFuture<ResultType> MakeCompletedFuture(ResultType Result)
+	{
+		TPromise<ResultType> promise;
+		TFuture<ResultType> future = promise.GetFuture();
+		promise.SetValue(MoveTemp(Result));
+		return future;
+	}
+
+	FString const NotInitializedError = TEXT("The online subsystem is not initialized");
+}
+
+TFuture<FOnlineLoginResultEpic> FOnlineSubsystemEpic::LoginAsync(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials)
+{
+	if (!this->IdentityInterface)
+	{
+		FOnlineLoginResultEpic result;
+		result.LocalUserNum = LocalUserNum;
+		result.Error = NotInitializedError;
+		return MakeCompletedFuture(MoveTemp(result));
+	}
+	return this->IdentityInterface->LoginAsync(LocalUserNum, AccountCredentials);
+}
+
+TFuture<FOnlineLoginResultEpic> FOnlineSubsystemEpic::AutoLoginAsync(int32 LocalUserNum)
+{
+	if (!this->IdentityInterface)
+	{
+		FOnlineLoginResultEpic result;
+		result.LocalUserNum = LocalUserNum;
+		result.Error = NotInitializedError;
+		return MakeCompletedFuture(MoveTemp(result));
+	}
+	return this->IdentityInterface->AutoLoginAsync(LocalUserNum);
+}
+
+TFuture<TArray<FOnlineLoginResultEpic>> FOnlineSubsystemEpic::LoginManyAsync(TArray<FOnlineLoginRequestEpic> const& Requests, int32 MaxConcurrentLogins)
+{
+	if (!this->IdentityInterface)
+	{
+		TArray<FOnlineLoginResultEpic> results;
+		for (FOnlineLoginRequestEpic const& request : Requests)
+		{
+			FOnlineLoginResultEpic& result = results.AddDefaulted_GetRef();
+			result.LocalUserNum = request.LocalUserNum;
+			result.Error = NotInitializedError;
+		}
+		return MakeCompletedFuture(MoveTemp(results));
+	}
+	return this->IdentityInterface->LoginManyAsync(Requests, MaxConcurrentLogins);
+}
+
+FDelegateHandle FOnlineSubsystemEpic::AddOnLoginCredentialsNeededDelegate_Handle(FOnLoginCredentialsNeededDelegate const& Delegate)
+{
+	return this->IdentityInterface ? this->IdentityInterface->AddOnLoginCredentialsNeededDelegate_Handle(Delegate) : FDelegateHandle();
+}
+
+void FOnlineSubsystemEpic::ClearOnLoginCredentialsNeededDelegate_Handle(FDelegateHandle& Handle)
+{
+	if (this->IdentityInterface)
+	{
+		this->IdentityInterface->ClearOnLoginCredentialsNeededDelegate_Handle(Handle);
+	}
+}
+
+TFuture<FOnlineSessionResultEpic> FOnlineSubsystemEpic::CreateSessionAsync(const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings)
+{
+	if (!this->SessionInterface)
+	{
+		return MakeCompletedFuture(FOnlineSessionResultEpic{ SessionName, false });
+	}
+	return this->SessionInterface->CreateSessionAsync(HostingPlayerId, SessionName, NewSessionSettings);
+}
+
+TFuture<FOnlineSessionResultEpic> FOnlineSubsystemEpic::DestroySessionAsync(FName SessionName)
+{
+	if (!this->SessionInterface)
+	{
+		return MakeCompletedFuture(FOnlineSessionResultEpic{ SessionName, false });
+	}
+	return this->SessionInterface->DestroySessionAsync(SessionName);
+}
+
+TFuture<FOnlineFindSessionsResultEpic> FOnlineSubsystemEpic::FindSessionsAsync(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings)
+{
+	if (!this->SessionInterface)
+	{
+		return MakeCompletedFuture(FOnlineFindSessionsResultEpic{ false, SearchSettings });
+	}
+	return this->SessionInterface->FindSessionsAsync(SearchingPlayerId, SearchSettings);
+}
+
+TFuture<FOnlineJoinSessionResultEpic> FOnlineSubsystemEpic::JoinSessionAsync(const FUniqueNetId& PlayerId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession)
+{
+	if (!this->SessionInterface)
+	{
+		return MakeCompletedFuture(FOnlineJoinSessionResultEpic{ SessionName, EOnJoinSessionCompleteResult::UnknownError });
+	}
+	return this->SessionInterface->JoinSessionAsync(PlayerId, SessionName, DesiredSession);
+}
+
+TFuture<FOnlinePresenceResultEpic> FOnlineSubsystemEpic::SetPresenceAsync(const FUniqueNetId& User, const FOnlineUserPresenceStatus& Status)
+{
+	if (!this->PresenceInterface)
+	{
+		return MakeCompletedFuture(FOnlinePresenceResultEpic{ MakeShared<FUniqueNetIdEpic>(static_cast<FUniqueNetIdEpic const&>(User)), false });
+	}
+	return this->PresenceInterface->SetPresenceAsync(User, Status);
+}
+
+TFuture<FOnlinePresenceResultEpic> FOnlineSubsystemEpic::QueryPresenceAsync(const FUniqueNetId& User)
+{
+	if (!this->PresenceInterface)
+	{
+		return MakeCompletedFuture(FOnlinePresenceResultEpic{ MakeShared<FUniqueNetIdEpic>(static_cast<FUniqueNetIdEpic const&>(User)), false });
+	}
+	return this->PresenceInterface->QueryPresenceAsync(User);
+}
+
+TFuture<FOnlineQueryUserInfoResultEpic> FOnlineSubsystemEpic::QueryUserInfoAsync(int32 LocalUserNum, const TArray<TSharedRef<const FUniqueNetId>>& UserIds)
+{
+	if (!this->UserInterface)
+	{
+		FOnlineQueryUserInfoResultEpic result;
+		result.LocalUserNum = LocalUserNum;
+		result.UserIds = UserIds;
+		result.Error = NotInitializedError;
+		return MakeCompletedFuture(MoveTemp(result));
+	}
+	return this->UserInterface->QueryUserInfoAsync(LocalUserNum, UserIds);
+}
+
+bool FOnlineSubsystemEpic::CopySessionSettings(FName SessionName, FOnlineSessionSettings& OutSettings) const
+{
+	return this->SessionInterface && this->SessionInterface->CopySessionSettings(SessionName, OutSettings);
+}
+
+bool FOnlineSubsystemEpic::FindSessionsMulti(const FUniqueNetId& SearchingPlayerId, TArray<TSharedRef<FOnlineSessionSearch>> const& Searches, TSharedRef<FOnlineSessionSearch> const& MergedSearch, int32 MaxResults)
+{
+	return this->SessionInterface && this->SessionInterface->FindSessionsMulti(SearchingPlayerId, Searches, MergedSearch, MaxResults);
+}
+
+bool FOnlineSubsystemEpic::CancelSessionSearch(TSharedRef<FOnlineSessionSearch> const& SearchSettings)
+{
+	return this->SessionInterface && this->SessionInterface->CancelSessionSearch(SearchSettings);
+}
+
+FOnlineSessionSearchCacheMetricsEpic FOnlineSubsystemEpic::GetSessionSearchCacheMetrics() const
+{
+	return this->SessionInterface ? this->SessionInterface->GetSessionSearchCacheMetrics() : FOnlineSessionSearchCacheMetricsEpic();
+}
+
+FDelegateHandle FOnlineSubsystemEpic::AddOnFindSessionsProgressDelegate_Handle(FOnFindSessionsProgressDelegate const& Delegate)
+{
+	return this->SessionInterface ? this->SessionInterface->AddOnFindSessionsProgressDelegate_Handle(Delegate) : FDelegateHandle();
+}
+
+void FOnlineSubsystemEpic::ClearOnFindSessionsProgressDelegate_Handle(FDelegateHandle& Handle)
+{
+	if (this->SessionInterface)
+	{
+		this->SessionInterface->ClearOnFindSessionsProgressDelegate_Handle(Handle);
+	}
+}
+
 bool FOnlineSubsystemEpic::Tick(float DeltaTime)
 {
 	FOnlineSubsystemImpl::Tick(DeltaTime);
@@ -450,6 +791,32 @@ bool FOnlineSubsystemEpic::Tick(float DeltaTime)
 		EOS_Platform_Tick(this->PlatformHandle);
 	}
 
+	if (this->RetryPolicy)
+	{
+		this->RetryPolicy->Tick(DeltaTime);
+	}
+
+	if (this->ReconnectScheduler)
+	{
+		this->ReconnectScheduler->Tick(DeltaTime);
+	}
+
+	if (this->WriteJournal)
+	{
+		this->WriteJournal->Tick(DeltaTime);
+	}
+
+	// Runs after the retries, reconnects and replays, so their requests are sent in the same frame when the limits allow it
+	if (this->RateLimiter)
+	{
+		this->RateLimiter->Tick(DeltaTime);
+	}
+
+	if (this->SessionPinger)
+	{
+		this->SessionPinger->Tick(DeltaTime);
+	}
+
 	if (this->SessionInterface)
 	{
 		this->SessionInterface->Tick(DeltaTime);
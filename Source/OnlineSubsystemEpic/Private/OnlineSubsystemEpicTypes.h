@@ -461,6 +461,19 @@ enum class EExternalLoginType : uint8
 	Steam		UMETA(DisplayName = "Steam"),
 };
 
+/**
+ * The families the EOS operations are grouped into.
+ * Retry budgets and rate limits are tracked per family.
+ */
+enum class EEpicOperation : uint8
+{
+	Login,
+	Session,
+	UserInfo,
+	Presence,
+	Num
+};
+
 
 /**
  * User attribution constants for GetUserAttribute()
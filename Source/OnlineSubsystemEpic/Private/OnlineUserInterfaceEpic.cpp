@@ -1,6 +1,8 @@
 #include "OnlineUserInterfaceEpic.h"
 #include "OnlineSubsystemEpicTypes.h"
 #include "OnlineSubsystemEpic.h"
+#include "OnlineRetryPolicyEpic.h"
+#include "OnlineRateLimiterEpic.h"
 #include "Utilities.h"
 #include "eos_userinfo.h"
 #include "eos_auth.h"
@@ -13,15 +15,12 @@
 // ---------------------------------------------
 
 /**
- * This structure is needed, since the callback to start as session doesn't include the session's name,
- * which is needed to call the completion delegates
+ * Carried by a single user info request to the SDK.
+ * The queries waiting for the request are tracked by the user info coalescer.
  */
 typedef struct FQueryUserInfoAdditionalData {
 	FOnlineUserEpic* OnlineUserPtr;
-	int32 LocalUserId;
-	double StartTime;
-	//Count the query id index we are currently on
-	int32 CurrentQueryUserIndex;
+	int32 Attempt = 1;
 } FQueryUserInfoAdditionalData;
 
 typedef struct FQueryUserIdMappingAdditionalInfo
@@ -88,113 +87,111 @@ void FOnlineUserEpic::OnEOSQueryUserInfoComplete(EOS_UserInfo_QueryUserInfoCallb
 	FOnlineUserEpic* thisPtr = additionalData->OnlineUserPtr;
 	checkf(thisPtr, TEXT("%s called, but \"this\" is missing."), *FString(__FUNCTION__));
 
+	// Transient failures reissue the sub query with the same additional data
+	EOS_EpicAccountId localUserId = Data->LocalUserId;
+	EOS_EpicAccountId targetUserId = Data->TargetUserId;
+	if (thisPtr->Subsystem->RetryPolicy->ScheduleRetry(EEpicOperation::UserInfo, Data->ResultCode, additionalData->Attempt, [additionalData, localUserId, targetUserId]()
+		{
+			additionalData->Attempt += 1;
+			additionalData->OnlineUserPtr->IssueQueryUserInfo(additionalData, localUserId, targetUserId);
+		}, [additionalData, localUserId, targetUserId]()
+		{
+			// Dropped on shutdown, the query completes as failed
+			EOS_UserInfo_QueryUserInfoCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = additionalData;
+			info.LocalUserId = localUserId;
+			info.TargetUserId = targetUserId;
+			OnEOSQueryUserInfoComplete(&info);
+		}))
+	{
+		return;
+	}
 
+	// Every query that asked for this user while the request was running gets the same result
+	thisPtr->QueryUserInfoCoalescer.Complete(MakeTuple(localUserId, targetUserId), Data->ResultCode);
+
+	// Release the memory from additionalUserData
+	delete(additionalData);
+}
+
+void FOnlineUserEpic::CompleteUserInfoSubQuery(int32 LocalUserNum, uint32 QueryId, int32 SubQueryIndex, EOS_EpicAccountId LocalUserId, EOS_EpicAccountId TargetUserId, EOS_EResult Result)
+{
 	FString error;
-	EOS_EResult result = Data->ResultCode;
-	if (result != EOS_EResult::EOS_Success)
+	if (Result != EOS_EResult::EOS_Success)
 	{
-		error = FString::Printf(TEXT("[EOS SDK] Server returned an error. Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(result)));
+		error = FString::Printf(TEXT("[EOS SDK] Server returned an error. Error: %s"), UTF8_TO_TCHAR(EOS_EResult_ToString(Result)));
 	}
 	else
 	{
-		TSharedPtr<FUniqueNetId const> netId = thisPtr->Subsystem->IdentityInterface->GetUniquePlayerId(additionalData->LocalUserId);
+		TSharedPtr<FUniqueNetId const> netId = this->Subsystem->IdentityInterface->GetUniquePlayerId(LocalUserNum);
 		TSharedPtr<FUniqueNetIdEpic const> epicNetId = StaticCastSharedPtr<FUniqueNetIdEpic const>(netId);
 		if (!epicNetId)
 		{
-			error = FString::Printf(TEXT("Could not find user for index %d"), additionalData->LocalUserId);
+			error = FString::Printf(TEXT("Could not find user for index %d"), LocalUserNum);
 		}
 		else
 		{
-			if (epicNetId->ToEpicAccountId() != Data->LocalUserId)
+			if (epicNetId->ToEpicAccountId() != LocalUserId)
 			{
 				error = TEXT("User id for local user index and callback local user id mismatch");
 			}
 			else
 			{
 				// Add the target user id to the list of queried users
-				thisPtr->queriedUserIdsCache.Add(Data->TargetUserId);
+				this->queriedUserIdsCache.AddUnique(TargetUserId);
 			}
 		}
 	}
 
 	// Since the EOS SDK only allows a single user query, we have to make sure the delegate only fires when all user queries are done
-	// For this, we retrieve the query by its start time, and check how many queries are complete. If the amount of completed queries
+	// For this, we retrieve the query by its id, and check how many queries are complete. If the amount of completed queries
 	// is equal to the number of total queries the error message will be created and the completion delegate triggered
+	TArray<TSharedRef<FUniqueNetId const>> userIds;
+	TArray<FString> errors;
+	{
+		// Lock the following section to make sure the amount of completed queries doesn't change mid way.
+		FScopeLock lock(&this->UserQueryLock);
 
-	// Lock the following section to make sure the amount of completed queries doesn't change mid way.
-	thisPtr->UserQueryLock.Lock();
-
-	// Check in case we went too fast and info is not available immediately
-	if (thisPtr->userQueries.Num() > 0) {
-		// Auto used below to increase readability
-		auto query = thisPtr->userQueries.Find(additionalData->StartTime);
-
-		TArray<TSharedRef<FUniqueNetId const>> userIds = query->Get<0>();
-		TArray<bool> completedQueries = query->Get<1>();
-		TArray<FString> errors = query->Get<2>();
+		// Gone if the query was completed already
+		auto query = this->userQueries.Find(QueryId);
+		if (!query)
+		{
+			return;
+		}
 
-		int32 CurrentIndex = additionalData->CurrentQueryUserIndex;
-		//We need to update the tuple here - otherwise we never complete the query! - Mike
-		if (result != EOS_EResult::EOS_Success)
+		TArray<bool>& completedQueries = query->Get<1>();
+		if (Result != EOS_EResult::EOS_Success || !error.IsEmpty())
 		{
 			// Change the error message so that the end user knows at which sub-query index the error occurred.
-			errors[CurrentIndex] = FString::Printf(TEXT("SubQueryId: %d, Message: %s"), CurrentIndex, *error);
+			query->Get<2>()[SubQueryIndex] = FString::Printf(TEXT("SubQueryId: %d, Message: %s"), SubQueryIndex, *error);
 		}
 
 		//Regardless if there is an error or not for this index, we have completed a query
-		//we will simply move on to the next index
-		completedQueries[CurrentIndex] = true;
-		checkf(userIds.Num() == errors.Num() && errors.Num() == completedQueries.Num(), TEXT("Amount(UserIds, completedQueries, errors) mismatch."));
-		thisPtr->userQueries[additionalData->StartTime] = MakeTuple(userIds, completedQueries, errors);
+		completedQueries[SubQueryIndex] = true;
+		checkf(query->Get<0>().Num() == query->Get<2>().Num() && query->Get<2>().Num() == completedQueries.Num(), TEXT("Amount(UserIds, completedQueries, errors) mismatch."));
 
-		// Count the number of completed queries
-		int32 doneQueries = 0;
-		for (int32 i = 0; i < completedQueries.Num(); ++i)
+		if (completedQueries.Contains(false))
 		{
-			//We are done if all queries have been completed in some form
-			if (completedQueries[i])
-			{
-				doneQueries += 1;
-			}
+			return;
 		}
 
-		thisPtr->UserQueryLock.Unlock();
-
-		// If all queries are done, log the result of the function
-		if (doneQueries == userIds.Num())
-		{
-			UE_LOG_ONLINE_USER(Log, TEXT("Query user info successful. Number of queries is: %d"), thisPtr->queriedUserIdsCache.Num());
-			//queries don't necessarily respect order, so remove the index on what the current query is set at
-			int32 IndexToRemove = thisPtr->TimeToIndexMap[additionalData->StartTime];
-			thisPtr->TimeToIndexMap.Remove(IndexToRemove);
-
-			//Remove the user query that we have from this timestamp, we are done with it
-			thisPtr->userQueries.Remove(additionalData->StartTime);
+		// All sub queries are done, we are done with the query
+		userIds = MoveTemp(query->Get<0>());
+		errors = MoveTemp(query->Get<2>());
+		this->userQueries.Remove(QueryId);
+	}
 
-			thisPtr->TriggerOnQueryUserInfoCompleteDelegates(additionalData->LocalUserId, error.IsEmpty(), userIds, "");
-		}
-		//we have finished all queries but there are errors as well
-		else if (doneQueries == completedQueries.Num() + errors.Num())
+	errors.RemoveAll([](FString const& Error)
 		{
-			UE_LOG_ONLINE_USER(Log, TEXT("Query user info successful. Number of queries is: %d"), thisPtr->queriedUserIdsCache.Num());
-
-			FString completeErrorString = thisPtr->ConcatErrorString(errors);
+			return Error.IsEmpty();
+		});
+	FString completeErrorString = this->ConcatErrorString(errors);
 
-			UE_CLOG_ONLINE_USER(!completeErrorString.IsEmpty(), Warning, TEXT("Query user info failed:\r\n%s"), *error);
+	UE_LOG_ONLINE_USER(Log, TEXT("Query user info done. Number of queried users is: %d"), this->queriedUserIdsCache.Num());
+	UE_CLOG_ONLINE_USER(!completeErrorString.IsEmpty(), Warning, TEXT("Query user info failed:\r\n%s"), *completeErrorString);
 
-			//queries don't necessarily respect order, so remove the index on what the current query is set at
-			int32 IndexToRemove = thisPtr->TimeToIndexMap[additionalData->StartTime];
-			thisPtr->TimeToIndexMap.Remove(IndexToRemove);
-
-			//Remove the user query that we have from this timestamp, we are done with it
-			thisPtr->userQueries.Remove(additionalData->StartTime);
-
-			thisPtr->TriggerOnQueryUserInfoCompleteDelegates(additionalData->LocalUserId, error.IsEmpty(), userIds, completeErrorString);
-		}
-	}
-
-	// Release the memory from additionalUserData
-	delete(additionalData);
+	this->TriggerOnQueryUserInfoCompleteDelegates(LocalUserNum, completeErrorString.IsEmpty(), userIds, completeErrorString);
 }
 
 void FOnlineUserEpic::OnEOSQueryUserInfoByDisplayNameComplete(EOS_UserInfo_QueryUserInfoByDisplayNameCallbackInfo const* Data)
@@ -542,10 +539,33 @@ void FOnlineUserEpic::OnEOSQueryExternalIdMappingsByIdComplete(EOS_UserInfo_Quer
 
 FOnlineUserEpic::FOnlineUserEpic(FOnlineSubsystemEpic* InSubsystem)
 	: Subsystem(InSubsystem)
+	, NextUserQueryId(0)
 {
 	this->userInfoHandle = EOS_Platform_GetUserInfoInterface(InSubsystem->PlatformHandle);
 }
 
+void FOnlineUserEpic::IssueQueryUserInfo(FQueryUserInfoAdditionalData* AdditionalData, EOS_EpicAccountId LocalUserId, EOS_EpicAccountId TargetUserId)
+{
+	this->Subsystem->RateLimiter->Submit(EEpicOperation::UserInfo, [this, AdditionalData, LocalUserId, TargetUserId]()
+		{
+			EOS_UserInfo_QueryUserInfoOptions queryUserInfoOptions = {
+				EOS_USERINFO_QUERYUSERINFO_API_LATEST,
+				LocalUserId,
+				TargetUserId
+			};
+			EOS_UserInfo_QueryUserInfo(this->userInfoHandle, &queryUserInfoOptions, AdditionalData, &FOnlineUserEpic::OnEOSQueryUserInfoComplete);
+		}, [AdditionalData, LocalUserId, TargetUserId]()
+		{
+			// Dropped on shutdown, the query completes as failed
+			EOS_UserInfo_QueryUserInfoCallbackInfo info = {};
+			info.ResultCode = EOS_EResult::EOS_Canceled;
+			info.ClientData = AdditionalData;
+			info.LocalUserId = LocalUserId;
+			info.TargetUserId = TargetUserId;
+			OnEOSQueryUserInfoComplete(&info);
+		});
+}
+
 void FOnlineUserEpic::Tick(float DeltaTime)
 {
 }
@@ -565,7 +585,8 @@ bool FOnlineUserEpic::QueryUserInfo(int32 LocalUserNum, const TArray<TSharedRef<
 
 			if (localUserId.IsValid() && localUserId->IsEpicAccountIdValid())
 			{
-				double startTime = FDateTime::UtcNow().ToUnixTimestamp();
+				// Every call gets an id of its own, several queries can be started in the same frame
+				uint32 queryId = this->NextUserQueryId++;
 
 				// Store the query inside the queries map beforehand
 				// Without this it might be possible that the callback gets an inconsistent array
@@ -575,12 +596,11 @@ bool FOnlineUserEpic::QueryUserInfo(int32 LocalUserNum, const TArray<TSharedRef<
 				TArray<FString> errors;
 				errors.Init(FString(), UserIds.Num());
 
-				TTuple<TArray<TSharedRef<FUniqueNetId const>>, TArray<bool>, TArray<FString>> queries = MakeTuple(UserIds, states, errors);
-				int64 CurrentTimeStamp = FDateTime::UtcNow().ToUnixTimestamp();
-				this->userQueries.Add(CurrentTimeStamp, queries);
-				//Add the current index on the time that this request is being made on
-				this->TimeToIndexMap.Add(CurrentTimeStamp, this->userQueries.Num() - 1);
-				
+				{
+					FScopeLock lock(&this->UserQueryLock);
+					this->userQueries.Add(queryId, MakeTuple(UserIds, states, errors));
+				}
+
 				// Start the actual queries
 				for (int32 i = 0; i < UserIds.Num(); i++)
 				{
@@ -588,19 +608,18 @@ bool FOnlineUserEpic::QueryUserInfo(int32 LocalUserNum, const TArray<TSharedRef<
 					TSharedRef<FUniqueNetIdEpic const> targetUserId = StaticCastSharedRef<FUniqueNetIdEpic const>(UserIds[i]);
 					if (targetUserId->IsEpicAccountIdValid())
 					{
-						EOS_UserInfo_QueryUserInfoOptions queryUserInfoOptions = {
-						   EOS_USERINFO_QUERYUSERINFO_API_LATEST,
-						   localUserId->ToEpicAccountId(),
-						   targetUserId->ToEpicAccountId()
-						};
-						FQueryUserInfoAdditionalData* additionalData = new FQueryUserInfoAdditionalData{
-							this,
-							LocalUserNum,
-							startTime,
-							i
-						};
-
-						EOS_UserInfo_QueryUserInfo(this->userInfoHandle, &queryUserInfoOptions, additionalData, &FOnlineUserEpic::OnEOSQueryUserInfoComplete);
+						// Only the first of several overlapping queries for the same user is sent, the others join it
+						TPair<EOS_EpicAccountId, EOS_EpicAccountId> key = MakeTuple(localUserId->ToEpicAccountId(), targetUserId->ToEpicAccountId());
+						if (this->QueryUserInfoCoalescer.Join(key, [this, LocalUserNum, queryId, i, key](EOS_EResult const& Result)
+							{
+								this->CompleteUserInfoSubQuery(LocalUserNum, queryId, i, key.Key, key.Value, Result);
+							}))
+						{
+							FQueryUserInfoAdditionalData* additionalData = new FQueryUserInfoAdditionalData{
+								this
+							};
+							this->IssueQueryUserInfo(additionalData, key.Key, key.Value);
+						}
 
 						result = ONLINE_IO_PENDING;
 					}
@@ -631,6 +650,60 @@ bool FOnlineUserEpic::QueryUserInfo(int32 LocalUserNum, const TArray<TSharedRef<
 	return result == ONLINE_SUCCESS || result == ONLINE_IO_PENDING;
 }
 
+TFuture<FOnlineQueryUserInfoResultEpic> FOnlineUserEpic::QueryUserInfoAsync(int32 LocalUserNum, const TArray<TSharedRef<const FUniqueNetId>>& UserIds)
+{
+	FOnlineQueryUserInfoResultEpic failedResult;
+	failedResult.LocalUserNum = LocalUserNum;
+	failedResult.UserIds = UserIds;
+	failedResult.Error = TEXT("The query didn't complete before the interface was shut down");
+	TSharedRef<TOnlineTrackedPromiseEpic<FOnlineQueryUserInfoResultEpic>> promise = this->PendingPromises.Make(MoveTemp(failedResult));
+	TFuture<FOnlineQueryUserInfoResultEpic> future = promise->GetFuture();
+
+	// Per user delegates only exist for valid indices, without one the query could never complete
+	if (LocalUserNum < 0 || LocalUserNum >= MAX_LOCAL_PLAYERS)
+	{
+		FOnlineQueryUserInfoResultEpic result;
+		result.LocalUserNum = LocalUserNum;
+		result.UserIds = UserIds;
+		result.Error = FString::Printf(TEXT("Invalid local user index.\r\n    User index: %d"), LocalUserNum);
+		promise->SetValue(MoveTemp(result));
+		return future;
+	}
+
+	// The completion delegate is shared between all queries of a local user.
+	// The queries pass the callers id array through untouched, so comparing the id references
+	// is enough to find the completion that belongs to this call.
+	TArray<TSharedRef<const FUniqueNetId>> expectedIds = UserIds;
+	TSharedRef<FDelegateHandle> handle = MakeShared<FDelegateHandle>();
+	*handle = this->AddOnQueryUserInfoCompleteDelegate_Handle(LocalUserNum, FOnQueryUserInfoCompleteDelegate::CreateLambda(
+		[this, promise, handle, expectedIds](int32 InLocalUserNum, bool bWasSuccessful, const TArray<TSharedRef<const FUniqueNetId>>& InUserIds, const FString& Error)
+		{
+			if (InUserIds.Num() != expectedIds.Num())
+			{
+				return;
+			}
+			for (int32 i = 0; i < expectedIds.Num(); ++i)
+			{
+				if (&InUserIds[i].Get() != &expectedIds[i].Get())
+				{
+					return;
+				}
+			}
+
+			this->ClearOnQueryUserInfoCompleteDelegate_Handle(InLocalUserNum, *handle);
+
+			FOnlineQueryUserInfoResultEpic result;
+			result.LocalUserNum = InLocalUserNum;
+			result.bWasSuccessful = bWasSuccessful;
+			result.UserIds = expectedIds;
+			result.Error = Error;
+			promise->SetValue(MoveTemp(result));
+		}));
+
+	this->QueryUserInfo(LocalUserNum, UserIds);
+	return future;
+}
+
 bool FOnlineUserEpic::GetAllUserInfo(int32 LocalUserNum, TArray< TSharedRef<class FOnlineUser> >& OutUsers)
 {
 	FString error;
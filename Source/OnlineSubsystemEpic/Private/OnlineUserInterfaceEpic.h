@@ -1,11 +1,15 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
 #include "Interfaces/OnlineUserInterface.h"
 #include "eos_sdk.h"
 #include "Misc/ScopeLock.h"
 #include "OnlineSubsystemEpicPackage.h" // Needs to be the last include
 #include "OnlineSubsystemEpicTypes.h"
+#include "OnlineRequestCoalescerEpic.h"
+#include "OnlinePromiseTrackerEpic.h"
+#include "OnlineApiTypesEpic.h"
 
 
 /** Stores information about an external id mapping */
@@ -25,6 +29,7 @@ struct FExternalIdMapping
 };
 
 class FOnlineSubsystemEpic;
+struct FQueryUserInfoAdditionalData;
 
 class FOnlineUserEpic
 	: public IOnlineUser
@@ -32,7 +37,7 @@ class FOnlineUserEpic
 private:
 	/** Hidden on purpose */
 	FOnlineUserEpic()
-		: Subsystem(nullptr), userInfoHandle(nullptr)
+		: Subsystem(nullptr), userInfoHandle(nullptr), NextUserQueryId(0)
 	{
 	}
 
@@ -41,6 +46,9 @@ private:
 
 	EOS_HUserInfo userInfoHandle;
 
+	/** The promises of the future based API that are still outstanding */
+	FOnlinePromiseTrackerEpic PendingPromises;
+
 	/** A list of all user ids for which the SDK has cached user information. */
 	TArray<EOS_EpicAccountId> queriedUserIdsCache;
 
@@ -57,17 +65,13 @@ private:
 
 	/**
 	 * A list of all running user queries
-	 * @key - The start time of the query
+	 * @key - The id of the query, see NextUserQueryId
 	 * @value - A tuple containing data with the queried id, the query state, and the optional error message
 	 */
-	TMap<double, TTuple<TArray<TSharedRef<FUniqueNetId const>>, TArray<bool>, TArray<FString>>> userQueries;
+	TMap<uint32, TTuple<TArray<TSharedRef<FUniqueNetId const>>, TArray<bool>, TArray<FString>>> userQueries;
 
-	/**
-	 * A map of current timestamp to index map
-	 * @key - The start time of the query
-	 * @value - the index of what time step we are at
-	 */
-	TMap<double, int32> TimeToIndexMap;
+	/** The id of the next user query. Queries started at the same time need ids of their own */
+	uint32 NextUserQueryId;
 
 	/**
 	 * A list of all currently running external id mappings queries
@@ -86,6 +90,15 @@ private:
 	 */
 	TArray<FExternalIdMapping> externalIdMappings;
 
+	/** Passes a single user info query through the rate limiter. Used for first attempts and retries alike */
+	void IssueQueryUserInfo(FQueryUserInfoAdditionalData* AdditionalData, EOS_EpicAccountId LocalUserId, EOS_EpicAccountId TargetUserId);
+
+	/** Joins overlapping user info requests for the same local and target user */
+	TOnlineRequestCoalescerEpic<TPair<EOS_EpicAccountId, EOS_EpicAccountId>, EOS_EResult> QueryUserInfoCoalescer;
+
+	/** Records the result of one user of a QueryUserInfo call, and triggers the delegates once all users are done */
+	void CompleteUserInfoSubQuery(int32 LocalUserNum, uint32 QueryId, int32 SubQueryIndex, EOS_EpicAccountId LocalUserId, EOS_EpicAccountId TargetUserId, EOS_EResult Result);
+
 	static void OnEOSQueryUserInfoComplete(EOS_UserInfo_QueryUserInfoCallbackInfo const* Data);
 	static void OnEOSQueryUserInfoByDisplayNameComplete(EOS_UserInfo_QueryUserInfoByDisplayNameCallbackInfo const* Data);
 	static void OnEOSQueryExternalIdMappingsByDisplayNameComplete(EOS_UserInfo_QueryUserInfoByDisplayNameCallbackInfo const* Data);
@@ -117,5 +130,24 @@ public:
 	virtual bool QueryExternalIdMappings(const FUniqueNetId& UserId, const FExternalIdQueryOptions& QueryOptions, const TArray<FString>& ExternalIds, const FOnQueryExternalIdMappingsComplete& Delegate = FOnQueryExternalIdMappingsComplete()) override;
 	virtual void GetExternalIdMappings(const FExternalIdQueryOptions& QueryOptions, const TArray<FString>& ExternalIds, TArray<TSharedPtr<const FUniqueNetId>>& OutIds) override;
 	virtual TSharedPtr<const FUniqueNetId> GetExternalIdMapping(const FExternalIdQueryOptions& QueryOptions, const FString& ExternalId) override;
+
+	// Future based API.
+	// The returned futures complete from within the EOS callback, so continuations attached with Then/Next
+	// run in the same tick as the completion and can immediately issue the next request.
+
+	/** Same as QueryUserInfo, but returns a future that completes once this exact query is done */
+	TFuture<FOnlineQueryUserInfoResultEpic> QueryUserInfoAsync(int32 LocalUserNum, const TArray<TSharedRef<const FUniqueNetId>>& UserIds);
+
+	/** Fails the futures of the operations still running. Called by the subsystem on shutdown */
+	void FailPendingFutures()
+	{
+		this->PendingPromises.FailAll();
+	}
+
+	/** How many user info requests joined an in-flight request instead of calling the SDK */
+	FEpicCoalescerMetrics const& GetQueryUserInfoCoalescerMetrics() const
+	{
+		return this->QueryUserInfoCoalescer.GetMetrics();
+	}
 };
 using FOnlineUserEpicPtr = TSharedPtr<FOnlineUserEpic, ESPMode::ThreadSafe>;
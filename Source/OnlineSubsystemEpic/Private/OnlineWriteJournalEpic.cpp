@@ -0,0 +1,108 @@
+#include "OnlineWriteJournalEpic.h"
+#include "OnlineSubsystemEpic.h"
+#include "OnlineSubsystem.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ConfigCacheIni.h"
+
+#include "eos_connect.h"
+
+FOnlineWriteJournalEpic::FOnlineWriteJournalEpic(FOnlineSubsystemEpic* InSubsystem)
+	: Subsystem(InSubsystem)
+	, bConnectionLost(false)
+	, RetryInterval(10.f)
+	, NextRetryTime(0)
+	, Superseded(0)
+{
+}
+
+void FOnlineWriteJournalEpic::LoadConfig()
+{
+	GConfig->GetFloat(TEXT("OnlineSubsystemEpic"), TEXT("WriteJournalRetryInterval"), this->RetryInterval, GEngineIni);
+	this->RetryInterval = FMath::Max(1.f, this->RetryInterval);
+}
+
+bool FOnlineWriteJournalEpic::ShouldDefer(EOS_ProductUserId LocalUserId) const
+{
+	if (this->bConnectionLost)
+	{
+		return true;
+	}
+
+	if (!EOS_ProductUserId_IsValid(LocalUserId))
+	{
+		return false;
+	}
+
+	EOS_HConnect connectHandle = EOS_Platform_GetConnectInterface(this->Subsystem->PlatformHandle);
+	return EOS_Connect_GetLoginStatus(connectHandle, LocalUserId) == EOS_ELoginStatus::EOS_LS_UsingLocalProfile;
+}
+
+bool FOnlineWriteJournalEpic::NoteResult(EOS_EResult Result)
+{
+	if (Result != EOS_EResult::EOS_NoConnection)
+	{
+		return false;
+	}
+
+	if (!this->bConnectionLost)
+	{
+		UE_LOG_ONLINE(Warning, TEXT("Lost the connection to the backend, journaling writes until it is back"));
+		this->bConnectionLost = true;
+		this->NextRetryTime = FPlatformTime::Seconds() + this->RetryInterval;
+	}
+	return true;
+}
+
+void FOnlineWriteJournalEpic::Record(FString const& Key, TUniqueFunction<void()>&& Replay)
+{
+	// The new write goes to the end, it has to be sent after everything recorded before it
+	int32 removed = this->Entries.RemoveAll([&Key](FEntry const& Entry) { return Entry.Key == Key; });
+	this->Superseded += removed;
+
+	UE_LOG_ONLINE(Verbose, TEXT("Journaled write \"%s\""), *Key);
+	this->Entries.Add(FEntry{ Key, MoveTemp(Replay) });
+}
+
+void FOnlineWriteJournalEpic::Discard(FString const& Key)
+{
+	this->Entries.RemoveAll([&Key](FEntry const& Entry) { return Entry.Key == Key; });
+}
+
+void FOnlineWriteJournalEpic::Flush()
+{
+	this->bConnectionLost = false;
+	if (this->Entries.Num() == 0)
+	{
+		return;
+	}
+
+	UE_LOG_ONLINE(Display, TEXT("Replaying %d journaled writes"), this->Entries.Num());
+
+	// A replay that fails again is recorded again, so take the entries out first
+	TArray<FEntry> entries = MoveTemp(this->Entries);
+	for (FEntry& entry : entries)
+	{
+		entry.Replay();
+	}
+}
+
+void FOnlineWriteJournalEpic::Tick(float DeltaTime)
+{
+	if (!this->bConnectionLost || this->Entries.Num() == 0)
+	{
+		return;
+	}
+
+	double now = FPlatformTime::Seconds();
+	if (now >= this->NextRetryTime)
+	{
+		this->NextRetryTime = now + this->RetryInterval;
+		this->Flush();
+	}
+}
+
+void FOnlineWriteJournalEpic::Reset()
+{
+	this->Entries.Empty();
+	this->bConnectionLost = false;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "eos_sdk.h"
+
+class FOnlineSubsystemEpic;
+
+/**
+ * Write-behind journal for mutations made while the backend can't be reached.
+ * Presence and session writes made while a user is on a local profile, or after the backend reported a lost connection,
+ * are recorded here instead of failing. Once the connection is back they are replayed in the order they were recorded.
+ * Every write has a key, a write replaces the journaled write with the same key, so only the latest one is sent.
+ * The journal lives as long as the subsystem, it is not written to disk.
+ * The journal is not thread safe, it is used from the game thread only.
+ */
+class FOnlineWriteJournalEpic
+{
+public:
+	explicit FOnlineWriteJournalEpic(FOnlineSubsystemEpic* InSubsystem);
+
+	/** Reads the journal settings from the OnlineSubsystemEpic section of the engine config */
+	void LoadConfig();
+
+	/** Whether writes of a user have to be journaled, because the backend can't be reached or the user is on a local profile */
+	bool ShouldDefer(EOS_ProductUserId LocalUserId) const;
+
+	/**
+	 * Checks the result of a write for a lost connection. A lost connection makes all following writes go to the journal,
+	 * until the connection is back.
+	 * @returns - True if the write failed because the backend can't be reached, and should be journaled
+	 */
+	bool NoteResult(EOS_EResult Result);
+
+	/**
+	 * Records a write, replacing the journaled write with the same key.
+	 * @param Key - Identifies what the write changes, e.g. the presence of a user
+	 * @param Replay - Sends the write. Called once the connection is back
+	 */
+	void Record(FString const& Key, TUniqueFunction<void()>&& Replay);
+
+	/** Drops the journaled write with the given key, e.g. because the session it updates was destroyed */
+	void Discard(FString const& Key);
+
+	/** Replays all journaled writes. Called when a user's login is back */
+	void Flush();
+
+	/** Probes a lost connection by replaying the journal from time to time */
+	void Tick(float DeltaTime);
+
+	/** Drops all journaled writes without sending them */
+	void Reset();
+
+	/** The number of journaled writes */
+	int32 Num() const
+	{
+		return this->Entries.Num();
+	}
+
+	/** The number of writes that were replaced by a later write before being sent */
+	uint64 GetSupersededCount() const
+	{
+		return this->Superseded;
+	}
+
+private:
+	struct FEntry
+	{
+		FString Key;
+		TUniqueFunction<void()> Replay;
+	};
+
+	FOnlineSubsystemEpic* Subsystem;
+
+	/** The journaled writes, the oldest first */
+	TArray<FEntry> Entries;
+
+	/** Whether the backend reported a lost connection, and no replay went through since */
+	bool bConnectionLost;
+
+	/** The time in seconds between two replays while the connection is lost */
+	float RetryInterval;
+
+	/** The time of the next replay while the connection is lost */
+	double NextRetryTime;
+
+	uint64 Superseded;
+};
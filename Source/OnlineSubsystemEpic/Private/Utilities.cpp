@@ -25,3 +25,95 @@ const char* FUtils::GetTempDirectory()
 	return "/var/tmp";
 #endif
 }
+
+// ---------------------------------------------
+// Name tables
+// ---------------------------------------------
+namespace
+{
+	using namespace FUtils::NameTable;
+
+	constexpr TEntry<ELoginType> LoginTypeNames[] = {
+		{ TEXT("Password"), ELoginType::Password },
+		{ TEXT("ExchangeCode"), ELoginType::ExchangeCode },
+		{ TEXT("DeviceCode"), ELoginType::DeviceCode },
+		{ TEXT("Developer"), ELoginType::Developer },
+		{ TEXT("RefreshToken"), ELoginType::RefreshToken },
+		{ TEXT("AccountPortal"), ELoginType::AccountPortal },
+		{ TEXT("PersistentAuth"), ELoginType::PersistentAuth },
+		{ TEXT("ExternalAuth"), ELoginType::ExternalAuth },
+	};
+	constexpr auto LoginTypeTable = MakeTable<16>(LoginTypeNames);
+	static_assert(LoginTypeTable.bValid, "No collision free seed for LoginTypeTable, increase the number of slots");
+
+	constexpr TEntry<EExternalLoginType> ExternalLoginTypeNames[] = {
+		{ TEXT("Steam"), EExternalLoginType::Steam },
+	};
+	constexpr auto ExternalLoginTypeTable = MakeTable<1>(ExternalLoginTypeNames);
+	static_assert(ExternalLoginTypeTable.bValid, "No collision free seed for ExternalLoginTypeTable, increase the number of slots");
+
+	constexpr TEntry<EOS_EExternalCredentialType> ExternalCredentialTypeNames[] = {
+		{ TEXT("steam"), EOS_EExternalCredentialType::EOS_ECT_STEAM_APP_TICKET },
+		{ TEXT("psn"), EOS_EExternalCredentialType::EOS_ECT_PSN_ID_TOKEN },
+		{ TEXT("xbl"), EOS_EExternalCredentialType::EOS_ECT_XBL_XSTS_TOKEN },
+		{ TEXT("discord"), EOS_EExternalCredentialType::EOS_ECT_DISCORD_ACCESS_TOKEN },
+		{ TEXT("gog"), EOS_EExternalCredentialType::EOS_ECT_GOG_SESSION_TICKET },
+		{ TEXT("nintendo_id"), EOS_EExternalCredentialType::EOS_ECT_NINTENDO_ID_TOKEN },
+		{ TEXT("nintendo_nsa"), EOS_EExternalCredentialType::EOS_ECT_NINTENDO_NSA_ID_TOKEN },
+		{ TEXT("uplay"), EOS_EExternalCredentialType::EOS_ECT_UPLAY_ACCESS_TOKEN },
+		{ TEXT("openid"), EOS_EExternalCredentialType::EOS_ECT_OPENID_ACCESS_TOKEN },
+		{ TEXT("device"), EOS_EExternalCredentialType::EOS_ECT_DEVICEID_ACCESS_TOKEN },
+		{ TEXT("apple"), EOS_EExternalCredentialType::EOS_ECT_APPLE_ID_TOKEN },
+	};
+	constexpr auto ExternalCredentialTypeTable = MakeTable<32>(ExternalCredentialTypeNames);
+	static_assert(ExternalCredentialTypeTable.bValid, "No collision free seed for ExternalCredentialTypeTable, increase the number of slots");
+
+	constexpr TEntry<EOS_EExternalAccountType> ExternalAccountTypeNames[] = {
+		{ TEXT("epic"), EOS_EExternalAccountType::EOS_EAT_EPIC },
+		{ TEXT("steam"), EOS_EExternalAccountType::EOS_EAT_STEAM },
+		{ TEXT("psn"), EOS_EExternalAccountType::EOS_EAT_PSN },
+		{ TEXT("xbl"), EOS_EExternalAccountType::EOS_EAT_XBL },
+		{ TEXT("discord"), EOS_EExternalAccountType::EOS_EAT_DISCORD },
+		{ TEXT("gog"), EOS_EExternalAccountType::EOS_EAT_GOG },
+		{ TEXT("nintendo"), EOS_EExternalAccountType::EOS_EAT_NINTENDO },
+		{ TEXT("uplay"), EOS_EExternalAccountType::EOS_EAT_UPLAY },
+		{ TEXT("openid"), EOS_EExternalAccountType::EOS_EAT_OPENID },
+		{ TEXT("apple"), EOS_EExternalAccountType::EOS_EAT_APPLE },
+	};
+	constexpr auto ExternalAccountTypeTable = MakeTable<16>(ExternalAccountTypeNames);
+	static_assert(ExternalAccountTypeTable.bValid, "No collision free seed for ExternalAccountTypeTable, increase the number of slots");
+}
+
+TPair<ELoginType, bool> FUtils::LoginTypeFromString(FString const& InputString)
+{
+	const TEntry<ELoginType>* Entry = LoginTypeTable.Find(*InputString);
+	return Entry ? MakeTuple(Entry->Value, true) : MakeTuple(ELoginType::Password, false);
+}
+
+FString FUtils::LoginTypeToString(ELoginType LoginType)
+{
+	TCHAR const* Name = LoginTypeTable.NameOf(LoginType);
+	return Name ? FString(Name) : FString(TEXT("Invalid"));
+}
+
+TPair<EExternalLoginType, bool> FUtils::ExternalLoginTypeFromString(FString const& InputString)
+{
+	const TEntry<EExternalLoginType>* Entry = ExternalLoginTypeTable.Find(*InputString);
+	return Entry ? MakeTuple(Entry->Value, true) : MakeTuple(EExternalLoginType::Steam, false);
+}
+
+TPair<EOS_EExternalCredentialType, bool> FUtils::ExternalCredentialsTypeFromString(FString const& InputString)
+{
+	const TEntry<EOS_EExternalCredentialType>* Entry = ExternalCredentialTypeTable.Find(*InputString);
+	return Entry ? MakeTuple(Entry->Value, true) : MakeTuple(EOS_EExternalCredentialType::EOS_ECT_EPIC, false);
+}
+
+FString FUtils::ExternalAccountTypeToString(EOS_EExternalAccountType externalAccountType)
+{
+	TCHAR const* Name = ExternalAccountTypeTable.NameOf(externalAccountType);
+
+	// Every enum value is part of the table.
+	// If we're here we should crash and burn
+	checkf(Name, TEXT("Unknown external account type %d"), int32(externalAccountType));
+	return Name ? FString(Name) : FString(TEXT("unknown"));
+}
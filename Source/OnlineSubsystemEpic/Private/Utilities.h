@@ -1,7 +1,10 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "UObject/CoreOnline.h"
+#include "OnlineSubsystemEpicTypes.h"
 #include "eos_sdk.h"
 
 namespace FUtils
@@ -11,111 +14,203 @@ namespace FUtils
 	 */
 	const char* GetTempDirectory();
 
-	template<typename TEnum>
-	FORCEINLINE FString GetEnumValueAsString(const FString& Name, TEnum Value) {
-		const UEnum* enumPtr = FindObject<UEnum>(ANY_PACKAGE, *Name, true);
-		if (!enumPtr) return FString("Invalid");
-		return enumPtr->GetNameByValue((int64)Value).ToString();
-	}
-
-	template <typename EnumType>
-	FORCEINLINE EnumType GetEnumValueFromString(const FString& EnumName, const FString& String) {
-		UEnum* Enum = FindObject<UEnum>(ANY_PACKAGE, *EnumName, true);
-		if (!Enum) {
-			return EnumType(0);
-		}
-		return (EnumType)Enum->GetIndexByName(FName(*String));
-	}
-
-	/** 
-	  * Converts a string into an EOS_EExternalCredentialType, case insensitive.
-	  * @returns - The external credentials type and true if the conversion was successful.
-	  */
-	TPair<EOS_EExternalCredentialType, bool> ExternalCredentialsTypeFromString(FString const& InputString)
+	// ---------------------------------------------
+	// Compile-time name tables
+	//
+	// Each enum that is converted to or from strings has a single constexpr table of names.
+	// The string -> enum direction uses a perfect hash over the lower-cased names,
+	// whose seed is searched for at compile time. A lookup therefore costs one hash,
+	// one table access and one confirming compare, regardless of the table size.
+	// ---------------------------------------------
+	namespace NameTable
 	{
-		if (InputString.Equals(TEXT("steam"), ESearchCase::IgnoreCase))
+		/** Lower-cases a single ASCII character, leaves everything else untouched */
+		constexpr uint32 ToLowerAscii(TCHAR Char)
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_STEAM_APP_TICKET, true);
+			return (Char >= TEXT('A') && Char <= TEXT('Z')) ? uint32(Char) + (TEXT('a') - TEXT('A')) : uint32(Char);
 		}
-		else if (InputString.Equals(TEXT("psn"), ESearchCase::IgnoreCase))
-		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_PSN_ID_TOKEN, true);
-		}
-		else if (InputString.Equals(TEXT("xbl"), ESearchCase::IgnoreCase))
-		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_XBL_XSTS_TOKEN, true);
-		}
-		else if (InputString.Equals(TEXT("discord"), ESearchCase::IgnoreCase))
-		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_DISCORD_ACCESS_TOKEN, true);
-		}
-		else if (InputString.Equals(TEXT("gog"), ESearchCase::IgnoreCase))
+
+		/** FNV-1a over the lower-cased characters of a null terminated string */
+		constexpr uint32 HashLowerCase(TCHAR const* String, uint32 Seed)
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_GOG_SESSION_TICKET, true);
+			uint32 Hash = 2166136261u ^ Seed;
+			for (; *String; ++String)
+			{
+				Hash = (Hash ^ ToLowerAscii(*String)) * 16777619u;
+			}
+			return Hash;
 		}
-		else if (InputString.Equals(TEXT("nintendo_id"), ESearchCase::IgnoreCase))
+
+		/** Case insensitive compare of two null terminated strings */
+		constexpr bool EqualsIgnoreCase(TCHAR const* A, TCHAR const* B)
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_NINTENDO_ID_TOKEN, true);
+			for (; *A && *B; ++A, ++B)
+			{
+				if (ToLowerAscii(*A) != ToLowerAscii(*B))
+				{
+					return false;
+				}
+			}
+			return *A == *B;
 		}
-		else if (InputString.Equals(TEXT("nintendo_nsa"), ESearchCase::IgnoreCase))
+
+		template<typename TEnum>
+		struct TEntry
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_NINTENDO_NSA_ID_TOKEN, true);
-		}
-		else if (InputString.Equals(TEXT("uplay"), ESearchCase::IgnoreCase))
+			TCHAR const* Name;
+			TEnum Value;
+		};
+
+		/**
+		 * A name table with a collision free slot array.
+		 * @param TEnum - The enum stored in the table
+		 * @param NumEntries - The number of names
+		 * @param NumSlots - The number of hash slots, must be a power of two
+		 */
+		template<typename TEnum, int32 NumEntries, uint32 NumSlots>
+		struct TTable
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_UPLAY_ACCESS_TOKEN, true);
-		}
-		else if (InputString.Equals(TEXT("openid"), ESearchCase::IgnoreCase))
+			static_assert((NumSlots & (NumSlots - 1)) == 0, "NumSlots must be a power of two");
+			static_assert(NumSlots >= uint32(NumEntries), "NumSlots must be able to hold every entry");
+
+			TEntry<TEnum> Entries[NumEntries];
+			int32 Slots[NumSlots];
+			uint32 Seed;
+
+			/** Whether a collision free seed was found. Checked with a static_assert next to each table */
+			bool bValid;
+
+			/** Finds the entry for a name, case insensitive. Returns nullptr if the name is unknown */
+			const TEntry<TEnum>* Find(TCHAR const* Name) const
+			{
+				int32 const Index = Slots[HashLowerCase(Name, Seed) & (NumSlots - 1)];
+				return (Index != INDEX_NONE && EqualsIgnoreCase(Entries[Index].Name, Name)) ? &Entries[Index] : nullptr;
+			}
+
+			/** Finds the name of an enum value. Returns nullptr if the value is unknown */
+			TCHAR const* NameOf(TEnum Value) const
+			{
+				for (int32 i = 0; i < NumEntries; ++i)
+				{
+					if (Entries[i].Value == Value)
+					{
+						return Entries[i].Name;
+					}
+				}
+				return nullptr;
+			}
+		};
+
+		/** Builds a table, searching for the first seed that maps every name to its own slot. The table is not valid if no seed was found */
+		template<uint32 NumSlots, typename TEnum, int32 NumEntries>
+		constexpr TTable<TEnum, NumEntries, NumSlots> MakeTable(TEntry<TEnum> const (&Entries)[NumEntries])
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_OPENID_ACCESS_TOKEN, true);
+			TTable<TEnum, NumEntries, NumSlots> Table = {};
+			for (int32 i = 0; i < NumEntries; ++i)
+			{
+				Table.Entries[i] = Entries[i];
+			}
+
+			for (uint32 Seed = 0; Seed < 0x10000; ++Seed)
+			{
+				for (uint32 Slot = 0; Slot < NumSlots; ++Slot)
+				{
+					Table.Slots[Slot] = INDEX_NONE;
+				}
+
+				bool bCollisionFree = true;
+				for (int32 i = 0; i < NumEntries && bCollisionFree; ++i)
+				{
+					uint32 const Slot = HashLowerCase(Entries[i].Name, Seed) & (NumSlots - 1);
+					bCollisionFree = Table.Slots[Slot] == INDEX_NONE;
+					Table.Slots[Slot] = i;
+				}
+
+				if (bCollisionFree)
+				{
+					Table.Seed = Seed;
+					Table.bValid = true;
+					return Table;
+				}
+			}
+
+			// No seed found, rejected by the static_assert on the table
+			Table.bValid = false;
+			return Table;
 		}
-		else if (InputString.Equals(TEXT("device"), ESearchCase::IgnoreCase))
+	}
+
+	/**
+	 * Combines multiple futures into one, that completes once every input future has completed.
+	 * The continuation runs on the thread that completes the last input future, which for
+	 * the interfaces of this subsystem is always inside the EOS_Platform_Tick dispatch.
+	 * @param Futures - The futures to wait for. The futures are consumed.
+	 * @returns - A future holding the results in the same order as the input futures
+	 */
+	template<typename ResultType>
+	TFuture<TArray<ResultType>> WhenAll(TArray<TFuture<ResultType>>& Futures)
+	{
+		struct FWhenAllState
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_DEVICEID_ACCESS_TOKEN, true);
-		}
-		else if (InputString.Equals(TEXT("apple"), ESearchCase::IgnoreCase))
+			TPromise<TArray<ResultType>> Promise;
+			TArray<ResultType> Results;
+			FThreadSafeCounter Remaining;
+		};
+
+		TSharedRef<FWhenAllState, ESPMode::ThreadSafe> State = MakeShared<FWhenAllState, ESPMode::ThreadSafe>();
+		State->Results.SetNum(Futures.Num());
+		State->Remaining.Set(Futures.Num());
+
+		TFuture<TArray<ResultType>> Combined = State->Promise.GetFuture();
+		if (Futures.Num() == 0)
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_APPLE_ID_TOKEN, true);
+			State->Promise.SetValue(TArray<ResultType>());
+			return Combined;
 		}
-		else
+
+		for (int32 i = 0; i < Futures.Num(); ++i)
 		{
-			return MakeTuple(EOS_EExternalCredentialType::EOS_ECT_EPIC, false);
+			Futures[i].Then([State, i](TFuture<ResultType> Completed)
+			{
+				State->Results[i] = Completed.Get();
+				if (State->Remaining.Decrement() == 0)
+				{
+					State->Promise.SetValue(MoveTemp(State->Results));
+				}
+			});
 		}
+		Futures.Empty();
+
+		return Combined;
 	}
 
+	/**
+	 * Converts a string into an ELoginType, case insensitive.
+	 * @returns - The login type and true if the conversion was successful.
+	 */
+	TPair<ELoginType, bool> LoginTypeFromString(FString const& InputString);
+
+	/**
+	 * Converts an ELoginType into its name, as used in the credentials type string.
+	 * @returns - The name of the login type
+	 */
+	FString LoginTypeToString(ELoginType LoginType);
+
+	/**
+	 * Converts a string into an EExternalLoginType, case insensitive.
+	 * @returns - The external login type and true if the conversion was successful.
+	 */
+	TPair<EExternalLoginType, bool> ExternalLoginTypeFromString(FString const& InputString);
+
+	/**
+	  * Converts a string into an EOS_EExternalCredentialType, case insensitive.
+	  * @returns - The external credentials type and true if the conversion was successful.
+	  */
+	TPair<EOS_EExternalCredentialType, bool> ExternalCredentialsTypeFromString(FString const& InputString);
+
 	/**
 	 * Converts an EOS_EExternalAccountType into a lower case string.
 	 * @returns - The string representing the external account enum
 	 */
-	FString ExternalAccountTypeToString(EOS_EExternalAccountType externalAccountType)
-	{
-		switch (externalAccountType)
-		{
-		case EOS_EExternalAccountType::EOS_EAT_EPIC:
-			return TEXT("epic");
-		case EOS_EExternalAccountType::EOS_EAT_STEAM:
-			return TEXT("steam");
-		case EOS_EExternalAccountType::EOS_EAT_PSN:
-			return TEXT("psn");
-		case EOS_EExternalAccountType::EOS_EAT_XBL:
-			return TEXT("xbl");
-		case EOS_EExternalAccountType::EOS_EAT_DISCORD:
-			return TEXT("discord");
-		case EOS_EExternalAccountType::EOS_EAT_GOG:
-			return TEXT("gog");
-		case EOS_EExternalAccountType::EOS_EAT_NINTENDO:
-			return TEXT("nintendo");
-		case EOS_EExternalAccountType::EOS_EAT_UPLAY:
-			return TEXT("uplay");
-		case EOS_EExternalAccountType::EOS_EAT_OPENID:
-			return TEXT("openid");
-		case EOS_EExternalAccountType::EOS_EAT_APPLE:
-			return TEXT("apple");
-		}
-
-		// We covered all enum cases.
-		// If we're here we should crash and burn
-		checkNoEntry();
-		return TEXT("unknown");
-	}
-};
\ No newline at end of file
+	FString ExternalAccountTypeToString(EOS_EExternalAccountType externalAccountType);
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Interfaces/OnlineIdentityInterface.h"
+#include "Interfaces/OnlinePresenceInterface.h"
+#include "Interfaces/OnlineSessionInterface.h"
+#include "OnlineSessionSettings.h"
+
+// The types of the API the subsystem offers on top of the online interfaces, see FOnlineSubsystemEpic
+
+/** The outcome of a login, as delivered by the future based login API */
+struct FOnlineLoginResultEpic
+{
+	int32 LocalUserNum = INDEX_NONE;
+	bool bWasSuccessful = false;
+	TSharedPtr<const FUniqueNetId> UserId;
+	FString Error;
+};
+
+/** A single login of a batch login */
+struct FOnlineLoginRequestEpic
+{
+	int32 LocalUserNum = INDEX_NONE;
+	FOnlineAccountCredentials Credentials;
+};
+
+/**
+ * Fired when the login of a local user has to be renewed, but the user logged in with credentials the plugin doesn't keep,
+ * e.g. a platform token. The game fetches fresh credentials and logs the user in again.
+ * @param LocalUserNum - The local user
+ * @param bLostLogin - True if the user lost their login, false if their auth is about to expire
+ */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnLoginCredentialsNeeded, int32, bool);
+typedef FOnLoginCredentialsNeeded::FDelegate FOnLoginCredentialsNeededDelegate;
+
+/** The outcome of a session state change, as delivered by the future based API */
+struct FOnlineSessionResultEpic
+{
+	FName SessionName;
+	bool bWasSuccessful = false;
+};
+
+/** The outcome of a session search, as delivered by the future based API */
+struct FOnlineFindSessionsResultEpic
+{
+	bool bWasSuccessful = false;
+	TSharedPtr<FOnlineSessionSearch> SearchSettings;
+};
+
+/** The outcome of joining a session, as delivered by the future based API */
+struct FOnlineJoinSessionResultEpic
+{
+	FName SessionName;
+	EOnJoinSessionCompleteResult::Type Result = EOnJoinSessionCompleteResult::UnknownError;
+};
+
+/** The outcome of a presence operation, as delivered by the future based API */
+struct FOnlinePresenceResultEpic
+{
+	TSharedPtr<const FUniqueNetId> UserId;
+	bool bWasSuccessful = false;
+};
+
+/** The outcome of a user info query, as delivered by the future based API */
+struct FOnlineQueryUserInfoResultEpic
+{
+	int32 LocalUserNum = INDEX_NONE;
+	bool bWasSuccessful = false;
+	TArray<TSharedRef<const FUniqueNetId>> UserIds;
+	FString Error;
+};
+
+/** Counters of the session search cache */
+struct FOnlineSessionSearchCacheMetricsEpic
+{
+	/** The number of searches answered from fresh cached results */
+	uint64 Hits = 0;
+
+	/** The number of searches answered from stale cached results, while the results were refreshed in the background */
+	uint64 StaleHits = 0;
+
+	/** The number of searches that had to wait for the backend */
+	uint64 Misses = 0;
+
+	/** The fraction of searches answered from the cache */
+	double GetHitRate() const
+	{
+		uint64 searches = this->Hits + this->StaleHits + this->Misses;
+		return searches > 0 ? static_cast<double>(this->Hits + this->StaleHits) / searches : 0;
+	}
+};
+
+/**
+ * Fired after each slice of converted search results. The results converted so far are in the search results already.
+ * @param SearchSettings - The search the results belong to
+ * @param NumConverted - The number of results converted so far
+ * @param NumResults - The number of results the backend returned
+ */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnFindSessionsProgress, TSharedRef<FOnlineSessionSearch> const&, int32, int32);
+typedef FOnFindSessionsProgress::FDelegate FOnFindSessionsProgressDelegate;
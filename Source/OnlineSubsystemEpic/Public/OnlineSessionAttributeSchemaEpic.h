@@ -0,0 +1,167 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OnlineKeyValuePair.h"
+#include "OnlineSessionSettings.h"
+#include "eos_sessions_types.h"
+
+/**
+ * Holds the UTF-8 strings of the attributes marshalled by a single call, until they are passed to the SDK.
+ * Strings are copied into an inline buffer, only strings that don't fit anymore go to the heap.
+ * Pointers handed out stay valid until the arena is reset or destroyed.
+ */
+class ONLINESUBSYSTEMEPIC_API FOnlineSessionAttributeArenaEpic
+{
+public:
+	FOnlineSessionAttributeArenaEpic()
+		: InlineUsed(0)
+	{
+	}
+
+	/** Copies a string into the arena as UTF-8 */
+	char const* Store(FString const& String);
+
+	/** Copies an UTF-8 string into the arena */
+	char const* Store(char const* Utf8, int32 Length);
+
+	/** Drops all strings, the inline buffer is reused */
+	void Reset();
+
+private:
+	FOnlineSessionAttributeArenaEpic(FOnlineSessionAttributeArenaEpic const&) = delete;
+	FOnlineSessionAttributeArenaEpic& operator=(FOnlineSessionAttributeArenaEpic const&) = delete;
+
+	static constexpr int32 InlineSize = 1024;
+
+	char Inline[InlineSize];
+	int32 InlineUsed;
+
+	/** Strings that didn't fit into the inline buffer, each in a block of its own */
+	TArray<TArray<char>> Overflow;
+};
+
+/** Maps the value type of an attribute key to the data type of the session settings */
+template<typename ValueType>
+struct TSessionAttributeTypeEpic;
+
+template<> struct TSessionAttributeTypeEpic<bool> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::Bool; };
+template<> struct TSessionAttributeTypeEpic<int32> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::Int32; };
+template<> struct TSessionAttributeTypeEpic<uint32> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::UInt32; };
+template<> struct TSessionAttributeTypeEpic<int64> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::Int64; };
+template<> struct TSessionAttributeTypeEpic<uint64> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::UInt64; };
+template<> struct TSessionAttributeTypeEpic<float> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::Float; };
+template<> struct TSessionAttributeTypeEpic<double> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::Double; };
+template<> struct TSessionAttributeTypeEpic<FString> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::String; };
+template<> struct TSessionAttributeTypeEpic<TArray<uint8>> { static constexpr EOnlineKeyValuePairDataType::Type Type = EOnlineKeyValuePairDataType::Blob; };
+
+/**
+ * A session attribute registered with the schema. Only values of the registered type can be set through it.
+ * @param ValueType - One of bool, int32, uint32, int64, uint64, float, double, FString or TArray<uint8>
+ */
+template<typename ValueType>
+struct TSessionAttributeKeyEpic
+{
+	FName Name;
+
+	/** Sets the attribute in the settings of a session */
+	void Set(FOnlineSessionSettings& Settings, ValueType const& Value, EOnlineDataAdvertisementType::Type AdvertisementType = EOnlineDataAdvertisementType::ViaOnlineService) const
+	{
+		Settings.Set(this->Name, Value, AdvertisementType);
+	}
+
+	/** Reads the attribute from the settings of a session. Returns false if it isn't set */
+	bool Get(FOnlineSessionSettings const& Settings, ValueType& OutValue) const
+	{
+		return Settings.Get(this->Name, OutValue);
+	}
+
+	/** Adds the attribute as a parameter of a session search */
+	void SetQuery(FOnlineSearchSettings& QuerySettings, ValueType const& Value, EOnlineComparisonOp::Type ComparisonOp = EOnlineComparisonOp::Equals) const
+	{
+		QuerySettings.Set(this->Name, Value, ComparisonOp);
+	}
+};
+
+/**
+ * The session attributes known to the game, with their names already encoded for the SDK.
+ * Game code registers its attributes once, e.g. at startup, and keeps the typed keys:
+ *
+ *     static TSessionAttributeKeyEpic<int32> const MapId = Schema->Register<int32>(TEXT("MapId"));
+ *     MapId.Set(SessionSettings, 3);
+ *
+ * The settings of FOnlineSessionSettings that are sent as attributes are registered by the schema itself.
+ * Attributes that were not registered still work, their names are encoded whenever they are sent.
+ * Types the SDK doesn't have are encoded: UInt32 as an integer, UInt64 as a decimal string, Json as a string and Blob as a base64 string.
+ * Registered attributes are decoded back to their type when they are read from search results, others keep the type of the SDK.
+ * The schema is not thread safe, it is used from the game thread only.
+ */
+class ONLINESUBSYSTEMEPIC_API FOnlineSessionAttributeSchemaEpic
+{
+public:
+	FOnlineSessionAttributeSchemaEpic();
+
+	/**
+	 * Registers an attribute. Registering a name again replaces its type.
+	 * @param Name - The name of the attribute, as used in the session settings
+	 * @returns - The typed key of the attribute
+	 */
+	template<typename ValueType>
+	TSessionAttributeKeyEpic<ValueType> Register(FName Name)
+	{
+		this->RegisterAttribute(Name, TSessionAttributeTypeEpic<ValueType>::Type);
+		return TSessionAttributeKeyEpic<ValueType>{ Name };
+	}
+
+	/** Whether an attribute was registered */
+	bool IsRegistered(FName Name) const
+	{
+		return this->Attributes.Contains(Name);
+	}
+
+	/**
+	 * Returns the UTF-8 name of an attribute. Names of unregistered attributes are encoded into the arena
+	 * @param Name - The name of the attribute
+	 * @param Arena - Holds the name if it wasn't registered
+	 */
+	char const* GetUtf8Name(FName Name, FOnlineSessionAttributeArenaEpic& Arena) const;
+
+	/**
+	 * Fills the SDK's attribute data from a session setting
+	 * @param Name - The name of the attribute
+	 * @param Data - The value of the attribute. Has to match the registered type, if the attribute was registered
+	 * @param Arena - Holds the strings of the attribute, until it is passed to the SDK
+	 * @param OutAttribute - The attribute data to fill
+	 * @param Error - The error message if the value can't be sent
+	 * @returns - True if the attribute data was filled
+	 */
+	bool Marshal(FName Name, FVariantData const& Data, FOnlineSessionAttributeArenaEpic& Arena, EOS_Sessions_AttributeData& OutAttribute, FString& Error) const;
+
+	/**
+	 * Reads a session setting from the SDK's attribute data
+	 * @param Attribute - The attribute data of a search result
+	 * @param OutName - The name of the attribute
+	 * @param OutData - The value of the attribute, in the registered type if the attribute was registered
+	 * @returns - True if the value could be read
+	 */
+	bool Unmarshal(EOS_Sessions_AttributeData const& Attribute, FName& OutName, FVariantData& OutData) const;
+
+private:
+	struct FAttribute
+	{
+		/** The null terminated UTF-8 name */
+		TArray<char> Utf8Name;
+
+		/** The type of the values sent to the SDK */
+		EOS_ESessionAttributeType AttributeType;
+
+		/** The type of the values in the session settings */
+		EOnlineKeyValuePairDataType::Type DataType;
+	};
+
+	void RegisterAttribute(FName Name, EOnlineKeyValuePairDataType::Type DataType);
+
+	/** Maps a session settings data type to the type of the SDK. Returns false if the SDK has no such type */
+	static bool ToAttributeType(EOnlineKeyValuePairDataType::Type DataType, EOS_ESessionAttributeType& OutAttributeType);
+
+	TMap<FName, FAttribute> Attributes;
+};
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "OnlineSubsystemEpicPackage.h"
 #include "OnlineSubsystemImpl.h"
+#include "OnlineApiTypesEpic.h"
 #include "eos_sdk.h"
 
 
@@ -12,6 +13,13 @@ using FOnlineUserEpicPtr = TSharedPtr<class FOnlineUserEpic, ESPMode::ThreadSafe
 using FOnlineFriendsEpicPtr = TSharedPtr<class FOnlineFriendInterfaceEpic, ESPMode::ThreadSafe>;
 using FOnlinePresenceEpicPtr = TSharedPtr<class FOnlinePresenceEpic, ESPMode::ThreadSafe>;
 using FOnlineVoiceImplPtr = TSharedPtr<class FOnlineVoiceImpl, ESPMode::ThreadSafe>;
+using FOnlineRetryPolicyEpicPtr = TSharedPtr<class FOnlineRetryPolicyEpic>;
+using FOnlineRateLimiterEpicPtr = TSharedPtr<class FOnlineRateLimiterEpic>;
+using FOnlineReconnectSchedulerEpicPtr = TSharedPtr<class FOnlineReconnectSchedulerEpic>;
+using FOnlineBotFarmEpicPtr = TSharedPtr<class FOnlineBotFarmEpic>;
+using FOnlineWriteJournalEpicPtr = TSharedPtr<class FOnlineWriteJournalEpic>;
+using FOnlineSessionAttributeSchemaEpicPtr = TSharedPtr<class FOnlineSessionAttributeSchemaEpic>;
+using FOnlineSessionPingerEpicPtr = TSharedPtr<class FOnlineSessionPingerEpic>;
 
 class ONLINESUBSYSTEMEPIC_API FOnlineSubsystemEpic
     : public FOnlineSubsystemImpl
@@ -53,6 +61,98 @@ public:
 
     virtual bool Tick(float DeltaTime) override;
 
+    /** The session attributes known to the game. Register attributes here to get typed keys for them. Null before Init */
+    FOnlineSessionAttributeSchemaEpicPtr GetSessionAttributeSchema() const
+    {
+        return this->SessionAttributeSchema;
+    }
+
+    // Future based API.
+    // The futures complete from within the EOS callback that finishes the operation, continuations attached with
+    // Then() or Next() therefore run in the same tick and can issue the next request right away.
+    // Operations still running on shutdown complete as failed. Calls made before Init or after Shutdown fail right away.
+
+    /** Same as IOnlineIdentity::Login, but returns a future instead of raising only the login delegates */
+    TFuture<FOnlineLoginResultEpic> LoginAsync(int32 LocalUserNum, const FOnlineAccountCredentials& AccountCredentials);
+
+    /** Same as IOnlineIdentity::AutoLogin, but returns a future instead of raising only the login delegates */
+    TFuture<FOnlineLoginResultEpic> AutoLoginAsync(int32 LocalUserNum);
+
+    /**
+     * Logs in several local users at once. The logins run concurrently, the usual per user login delegates are raised for every login.
+     * @param Requests - The users to log in. Every local user may only appear once
+     * @param MaxConcurrentLogins - The maximum number of logins running at the same time
+     * @returns - A future completing once all logins are done, with the results in the order of the requests
+     */
+    TFuture<TArray<FOnlineLoginResultEpic>> LoginManyAsync(TArray<FOnlineLoginRequestEpic> const& Requests, int32 MaxConcurrentLogins = 4);
+
+    /**
+     * Asks for fresh credentials when a user's login has to be renewed, but they logged in with a platform token.
+     * Only Epic account and device id logins are refreshed and reconnected in the background, the plugin doesn't keep other tokens.
+     */
+    FDelegateHandle AddOnLoginCredentialsNeededDelegate_Handle(FOnLoginCredentialsNeededDelegate const& Delegate);
+    void ClearOnLoginCredentialsNeededDelegate_Handle(FDelegateHandle& Handle);
+
+    /** Same as IOnlineSession::CreateSession, but returns a future that completes with the creation of this session */
+    TFuture<FOnlineSessionResultEpic> CreateSessionAsync(const FUniqueNetId& HostingPlayerId, FName SessionName, const FOnlineSessionSettings& NewSessionSettings);
+
+    /** Same as IOnlineSession::DestroySession, but returns a future that completes with the destruction of this session */
+    TFuture<FOnlineSessionResultEpic> DestroySessionAsync(FName SessionName);
+
+    /** Same as IOnlineSession::FindSessions, but returns a future that completes once the passed search is done */
+    TFuture<FOnlineFindSessionsResultEpic> FindSessionsAsync(const FUniqueNetId& SearchingPlayerId, const TSharedRef<FOnlineSessionSearch>& SearchSettings);
+
+    /** Same as IOnlineSession::JoinSession, but returns a future that completes once this session is joined */
+    TFuture<FOnlineJoinSessionResultEpic> JoinSessionAsync(const FUniqueNetId& PlayerId, FName SessionName, const FOnlineSessionSearchResult& DesiredSession);
+
+    /** Same as IOnlinePresence::SetPresence, but returns a future instead of taking a delegate */
+    TFuture<FOnlinePresenceResultEpic> SetPresenceAsync(const FUniqueNetId& User, const FOnlineUserPresenceStatus& Status);
+
+    /** Same as IOnlinePresence::QueryPresence, but returns a future instead of taking a delegate */
+    TFuture<FOnlinePresenceResultEpic> QueryPresenceAsync(const FUniqueNetId& User);
+
+    /** Same as IOnlineUser::QueryUserInfo, but returns a future that completes once this exact query is done */
+    TFuture<FOnlineQueryUserInfoResultEpic> QueryUserInfoAsync(int32 LocalUserNum, const TArray<TSharedRef<const FUniqueNetId>>& UserIds);
+
+    /** Copies the settings of a session. Unlike IOnlineSession::GetSessionSettings safe to call from any thread */
+    bool CopySessionSettings(FName SessionName, FOnlineSessionSettings& OutSettings) const;
+
+    // Session search
+
+    /**
+     * Runs several searches at the same time, e.g. one per bucket, and merges their results.
+     * Every search gets its own results as usual. The merged search receives the results of all of them,
+     * without duplicate sessions, and the find delegates fire once, when it is done.
+     * @param MaxResults - Once the merged search has this many results, the searches still running are given up on. Zero waits for all of them
+     * @returns - True if at least one search was started
+     */
+    bool FindSessionsMulti(const FUniqueNetId& SearchingPlayerId, TArray<TSharedRef<FOnlineSessionSearch>> const& Searches, TSharedRef<FOnlineSessionSearch> const& MergedSearch, int32 MaxResults = 0);
+
+    /**
+     * Cancels a single running search. The find delegates fire as failed, the results the backend sends later are dropped
+     * @returns - True if the search was running
+     */
+    bool CancelSessionSearch(TSharedRef<FOnlineSessionSearch> const& SearchSettings);
+
+    /** How many searches were answered from the search cache. Zero before Init */
+    FOnlineSessionSearchCacheMetricsEpic GetSessionSearchCacheMetrics() const;
+
+    /** Reports the results of large searches, while they are converted over several frames. FindSessions completes after the last slice */
+    FDelegateHandle AddOnFindSessionsProgressDelegate_Handle(FOnFindSessionsProgressDelegate const& Delegate);
+    void ClearOnFindSessionsProgressDelegate_Handle(FDelegateHandle& Handle);
+
+    // FSelfRegisteringExec
+
+    /**
+     * Handles the test commands:
+     * - BOTS ADD <Count>: Mints and logs in bots. Deletes the device id of this device, refused while a local user is logged in with it
+     * - BOTS STATUS: Logs the number of bots
+     * - BOTS RESET: Drops all bots
+     * - PING RESPOND: Opens the ping responder on SessionPingPort
+     * - PING <Ip>: Pings a host on SessionPingPort and logs the round trip time
+     */
+    virtual bool Exec(class UWorld* InWorld, const TCHAR* Cmd, FOutputDevice& Ar) override;
+
 
 PACKAGE_SCOPE:
 
@@ -92,6 +192,27 @@ PACKAGE_SCOPE:
     FOnlinePresenceEpicPtr PresenceInterface;
 
     FString DevToolAddress;
+
+    /** Decides which failed EOS operations are retried and when */
+    FOnlineRetryPolicyEpicPtr RetryPolicy;
+
+    /** Paces the EOS requests, so bursts don't run into the backend rate limits */
+    FOnlineRateLimiterEpicPtr RateLimiter;
+
+    /** Spreads the re-logins of users that lost their connection */
+    FOnlineReconnectSchedulerEpicPtr ReconnectScheduler;
+
+    /** Holds the bot identities of load tests */
+    FOnlineBotFarmEpicPtr BotFarm;
+
+    /** Keeps presence and session writes made while offline, until the connection is back */
+    FOnlineWriteJournalEpicPtr WriteJournal;
+
+    /** Encodes session settings into EOS attributes */
+    FOnlineSessionAttributeSchemaEpicPtr SessionAttributeSchema;
+
+    /** Pings the hosts of found sessions, and answers the pings of clients on servers */
+    FOnlineSessionPingerEpicPtr SessionPinger;
 };
 
 